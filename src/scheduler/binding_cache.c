@@ -0,0 +1,438 @@
+#include "der_scheduler_internal.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define BINDING_CACHE_MAGIC 0x43425344 /* "DSBC" */
+#define BINDING_CACHE_VERSION 2
+
+#define FNV_OFFSET_BASIS 0xcbf29ce484222325ULL
+#define FNV_PRIME 0x100000001b3ULL
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t modelHash;
+    uint32_t numberOfEntries;
+    uint32_t reserved;
+} BindingCacheFileHeader;
+
+static uint64_t
+bindingCache_hashString(uint64_t hash, const char* str)
+{
+    while (*str) {
+        hash ^= (uint8_t)(*str);
+        hash *= FNV_PRIME;
+        str++;
+    }
+
+    /* include the terminator so that "ab"+"c" and "a"+"bc" differ */
+    hash *= FNV_PRIME;
+
+    return hash;
+}
+
+static uint64_t
+bindingCache_hashInt(uint64_t hash, uint32_t value)
+{
+    int i;
+
+    for (i = 0; i < 4; i++) {
+        hash ^= (uint8_t)(value >> (i * 8));
+        hash *= FNV_PRIME;
+    }
+
+    return hash;
+}
+
+uint64_t
+BindingCache_calculateModelHash(IedModel* model)
+{
+    uint64_t hash = FNV_OFFSET_BASIS;
+
+    int i;
+
+    for (i = 0; i < IedModel_getLogicalDeviceCount(model); i++) {
+        LogicalDevice* ld = IedModel_getDeviceByIndex(model, i);
+
+        if (ld == NULL)
+            continue;
+
+        hash = bindingCache_hashString(hash, ld->name);
+
+        LogicalNode* ln = (LogicalNode*)ld->firstChild;
+
+        while (ln) {
+            hash = bindingCache_hashString(hash, ln->name);
+
+            uint32_t numberOfDataObjects = 0;
+
+            ModelNode* dObj = ln->firstChild;
+
+            while (dObj) {
+                numberOfDataObjects++;
+                dObj = dObj->sibling;
+            }
+
+            hash = bindingCache_hashInt(hash, numberOfDataObjects);
+
+            ln = (LogicalNode*)ln->sibling;
+        }
+    }
+
+    return hash;
+}
+
+static uint64_t
+bindingCache_hashNode(uint64_t hash, ModelNode* node)
+{
+    ModelNode* child = node->firstChild;
+
+    while (child) {
+        hash = bindingCache_hashString(hash, child->name);
+        hash = bindingCache_hashNode(hash, child);
+
+        child = child->sibling;
+    }
+
+    /* mark the end of the children */
+    hash *= FNV_PRIME;
+
+    return hash;
+}
+
+/**
+ * @brief Calculate a hash over the names of all elements below the node
+ */
+uint64_t
+BindingCache_calculateNodeHash(ModelNode* node)
+{
+    return bindingCache_hashNode(FNV_OFFSET_BASIS, node);
+}
+
+BindingCache
+BindingCache_create(uint64_t modelHash)
+{
+    BindingCache self = (BindingCache)calloc(1, sizeof(struct sBindingCache));
+
+    if (self) {
+        self->modelHash = modelHash;
+    }
+
+    return self;
+}
+
+bool
+BindingCache_addEntry(BindingCache self, int ldIdx, int lnIdx, BindingType type)
+{
+    if (self->numberOfEntries == self->maxEntries) {
+        int newMaxEntries = (self->maxEntries == 0) ? 16 : (self->maxEntries * 2);
+
+        BindingCacheEntry* newEntries = (BindingCacheEntry*)realloc(self->entries, newMaxEntries * sizeof(BindingCacheEntry));
+
+        if (newEntries == NULL)
+            return false;
+
+        self->entries = newEntries;
+        self->maxEntries = newMaxEntries;
+    }
+
+    BindingCacheEntry* entry = &(self->entries[self->numberOfEntries++]);
+
+    memset(entry, 0, sizeof(BindingCacheEntry));
+
+    entry->ldIdx = (uint16_t)ldIdx;
+    entry->lnIdx = (uint16_t)lnIdx;
+    entry->type = (uint8_t)type;
+
+    return true;
+}
+
+/**
+ * @brief Get the position of a node below the logical node as child indexes
+ */
+static bool
+bindingCache_getPosition(ModelNode* ln, ModelNode* node, BindingCachePosition* position)
+{
+    uint16_t childIdx[BINDING_CACHE_MAX_DEPTH];
+
+    int depth = 0;
+
+    while (node != ln) {
+        if ((node == NULL) || (node->parent == NULL) || (depth == BINDING_CACHE_MAX_DEPTH))
+            return false;
+
+        int idx = 0;
+
+        ModelNode* child = node->parent->firstChild;
+
+        while (child && (child != node)) {
+            child = child->sibling;
+            idx++;
+        }
+
+        if ((child == NULL) || (idx > UINT16_MAX))
+            return false;
+
+        childIdx[depth++] = (uint16_t)idx;
+
+        node = node->parent;
+    }
+
+    position->depth = (uint8_t)depth;
+
+    int i;
+
+    /* the child indexes were collected from the node up to the LN */
+    for (i = 0; i < depth; i++)
+        position->childIdx[i] = childIdx[depth - 1 - i];
+
+    return true;
+}
+
+/**
+ * @brief Add a schedule with the positions of the resolved elements of the LN
+ */
+bool
+BindingCache_addScheduleEntry(BindingCache self, int ldIdx, int lnIdx, LogicalNode* ln, ScheduleBinding* binding)
+{
+    if (BindingCache_addEntry(self, ldIdx, lnIdx, BINDING_TYPE_SCHEDULE) == false)
+        return false;
+
+    BindingCacheEntry* entry = &(self->entries[self->numberOfEntries - 1]);
+
+    entry->targetType = (uint8_t)binding->targetType;
+
+    int i;
+
+    for (i = 0; i < SCHD_BINDING_NUMBER_OF_NODES; i++) {
+        if (binding->nodes[i]) {
+            if (bindingCache_getPosition((ModelNode*)ln, binding->nodes[i], &(entry->positions[i])) == false) {
+                /* the schedule is bound by name when the cache is loaded */
+                memset(entry->positions, 0, sizeof(entry->positions));
+                return true;
+            }
+        }
+    }
+
+    entry->hasPositions = 1;
+
+    return true;
+}
+
+/**
+ * @brief Check that the node has the name element at the start of the (dotted) name
+ *
+ * @return the remaining name elements, "" when the name is complete or NULL when the name doesn't match
+ */
+static const char*
+bindingCache_matchName(ModelNode* node, const char* name)
+{
+    const char* separator = strchr(name, '.');
+
+    size_t nameLen = separator ? (size_t)(separator - name) : strlen(name);
+
+    if ((strncmp(node->name, name, nameLen) != 0) || (node->name[nameLen] != 0))
+        return NULL;
+
+    return separator ? (separator + 1) : "";
+}
+
+/**
+ * @brief Get the node below the data object at the position and check its name (e.g. "units.SIUnit")
+ *
+ * @return the node or NULL when the position doesn't fit the data object
+ */
+static ModelNode*
+bindingCache_getNodeAtPosition(ModelNode* dObj, BindingCachePosition* position, const char* name)
+{
+    ModelNode* node = dObj;
+
+    int level;
+
+    for (level = 1; level < position->depth; level++) {
+        if (*name == 0)
+            return NULL;
+
+        node = node->firstChild;
+
+        int idx;
+
+        for (idx = 0; (idx < position->childIdx[level]) && node; idx++)
+            node = node->sibling;
+
+        if (node == NULL)
+            return NULL;
+
+        name = bindingCache_matchName(node, name);
+
+        if (name == NULL)
+            return NULL;
+    }
+
+    /* the name has more elements than the position */
+    if (*name != 0)
+        return NULL;
+
+    return node;
+}
+
+/**
+ * @brief Resolve the elements of a schedule LN from the stored positions
+ *
+ * The data objects of the LN are traversed once. Each element is taken by its child indexes
+ * and only its name is compared (no search by name). Elements stored as not present are not
+ * searched.
+ *
+ * @return false when a position doesn't fit the LN (the model differs from the cached one)
+ */
+bool
+BindingCache_resolveScheduleBinding(BindingCacheEntry* entry, LogicalNode* ln, ScheduleBinding* binding)
+{
+    memset(binding, 0, sizeof(ScheduleBinding));
+
+    binding->targetType = (ScheduleTargetType)entry->targetType;
+
+    /* elements ordered by the index of their data object */
+    int order[SCHD_BINDING_NUMBER_OF_NODES];
+    int numberOfPositions = 0;
+
+    int i;
+
+    for (i = 0; i < SCHD_BINDING_NUMBER_OF_NODES; i++) {
+        BindingCachePosition* position = &(entry->positions[i]);
+
+        if (position->depth > BINDING_CACHE_MAX_DEPTH)
+            return false;
+
+        if (position->depth > 0) {
+            int j = numberOfPositions++;
+
+            while ((j > 0) && (entry->positions[order[j - 1]].childIdx[0] > position->childIdx[0])) {
+                order[j] = order[j - 1];
+                j--;
+            }
+
+            order[j] = i;
+        }
+    }
+
+    ModelNode* dObj = ln->firstChild;
+
+    int dObjIdx = 0;
+
+    int orderIdx = 0;
+
+    while (dObj && (orderIdx < numberOfPositions)) {
+        while ((orderIdx < numberOfPositions) && (entry->positions[order[orderIdx]].childIdx[0] == dObjIdx)) {
+            int nodeIdx = order[orderIdx++];
+
+            const char* name = Schedule_getBindingNodeName(binding->targetType, (ScheduleBindingNode)nodeIdx);
+
+            if (name)
+                name = bindingCache_matchName(dObj, name);
+
+            if (name == NULL)
+                return false;
+
+            binding->nodes[nodeIdx] = bindingCache_getNodeAtPosition(dObj, &(entry->positions[nodeIdx]), name);
+
+            if (binding->nodes[nodeIdx] == NULL)
+                return false;
+        }
+
+        dObj = dObj->sibling;
+        dObjIdx++;
+    }
+
+    /* positions behind the last data object */
+    return (orderIdx == numberOfPositions);
+}
+
+BindingCache
+BindingCache_load(const char* filename)
+{
+    FILE* file = fopen(filename, "rb");
+
+    if (file == NULL)
+        return NULL;
+
+    BindingCache self = NULL;
+
+    BindingCacheFileHeader header;
+
+    if (fread(&header, sizeof(header), 1, file) != 1)
+        goto exit_function;
+
+    if ((header.magic != BINDING_CACHE_MAGIC) || (header.version != BINDING_CACHE_VERSION)) {
+        printf("WARN: Binding cache %s has unknown format -> ignored\n", filename);
+        goto exit_function;
+    }
+
+    self = BindingCache_create(header.modelHash);
+
+    if (self == NULL)
+        goto exit_function;
+
+    if (header.numberOfEntries > 0) {
+        self->entries = (BindingCacheEntry*)malloc(header.numberOfEntries * sizeof(BindingCacheEntry));
+
+        if ((self->entries == NULL) || (fread(self->entries, sizeof(BindingCacheEntry), header.numberOfEntries, file) != header.numberOfEntries)) {
+            printf("WARN: Binding cache %s is truncated -> ignored\n", filename);
+            BindingCache_destroy(self);
+            self = NULL;
+            goto exit_function;
+        }
+
+        self->numberOfEntries = header.numberOfEntries;
+        self->maxEntries = header.numberOfEntries;
+    }
+
+exit_function:
+    fclose(file);
+
+    return self;
+}
+
+bool
+BindingCache_save(BindingCache self, const char* filename)
+{
+    FILE* file = fopen(filename, "wb");
+
+    if (file == NULL) {
+        printf("ERROR: Failed to write binding cache %s\n", filename);
+        return false;
+    }
+
+    BindingCacheFileHeader header;
+
+    memset(&header, 0, sizeof(header));
+
+    header.magic = BINDING_CACHE_MAGIC;
+    header.version = BINDING_CACHE_VERSION;
+    header.modelHash = self->modelHash;
+    header.numberOfEntries = self->numberOfEntries;
+
+    bool success = (fwrite(&header, sizeof(header), 1, file) == 1);
+
+    if (success && (self->numberOfEntries > 0))
+        success = (fwrite(self->entries, sizeof(BindingCacheEntry), self->numberOfEntries, file) == (size_t)self->numberOfEntries);
+
+    fclose(file);
+
+    if (success == false) {
+        printf("ERROR: Failed to write binding cache %s\n", filename);
+        remove(filename);
+    }
+
+    return success;
+}
+
+void
+BindingCache_destroy(BindingCache self)
+{
+    if (self) {
+        free(self->entries);
+        free(self);
+    }
+}
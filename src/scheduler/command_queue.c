@@ -0,0 +1,134 @@
+#include "der_scheduler_internal.h"
+
+#include <string.h>
+
+/*
+ * Bounded lock-free queue with multiple producers (MMS server threads, application threads)
+ * and a single consumer (the thread that processes the schedule). Each cell has a sequence
+ * number that tells the producers and the consumer if the cell is free or filled.
+ *
+ * A producer reserves a cell (freeCells) before it takes a position, so that a group of commands
+ * can be checked for space before the first one is queued (see Scheduler_applyScheduleChanges).
+ */
+
+void
+CommandQueue_initialize(CommandQueue* self)
+{
+    int i;
+
+    for (i = 0; i < CONFIG_SCHEDULE_COMMAND_QUEUE_SIZE; i++) {
+        __atomic_store_n(&(self->cells[i].sequence), (uint32_t)i, __ATOMIC_RELAXED);
+    }
+
+    __atomic_store_n(&(self->enqueuePos), 0, __ATOMIC_RELAXED);
+    self->dequeuePos = 0;
+
+    __atomic_store_n(&(self->freeCells), CONFIG_SCHEDULE_COMMAND_QUEUE_SIZE, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief Reserve cells for commands that are pushed later with CommandQueue_pushReserved
+ *
+ * @return true when the cells are reserved, false when the queue doesn't have enough free cells
+ */
+bool
+CommandQueue_reserve(CommandQueue* self, int numberOfCommands)
+{
+    int32_t freeCells = __atomic_load_n(&(self->freeCells), __ATOMIC_RELAXED);
+
+    do {
+        if (freeCells < numberOfCommands)
+            return false;
+    } while (__atomic_compare_exchange_n(&(self->freeCells), &freeCells, freeCells - numberOfCommands, true,
+        __ATOMIC_ACQUIRE, __ATOMIC_RELAXED) == false);
+
+    return true;
+}
+
+/**
+ * @brief Return reserved cells that are not used
+ */
+void
+CommandQueue_releaseReservation(CommandQueue* self, int numberOfCommands)
+{
+    __atomic_add_fetch(&(self->freeCells), numberOfCommands, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Add a command to the queue in a cell reserved with CommandQueue_reserve (can be called by multiple threads)
+ */
+void
+CommandQueue_pushReserved(CommandQueue* self, const SchedulerCommand* command)
+{
+    CommandQueueCell* cell;
+
+    uint32_t pos = __atomic_load_n(&(self->enqueuePos), __ATOMIC_RELAXED);
+
+    while (true) {
+        cell = &(self->cells[pos % CONFIG_SCHEDULE_COMMAND_QUEUE_SIZE]);
+
+        uint32_t seq = __atomic_load_n(&(cell->sequence), __ATOMIC_ACQUIRE);
+
+        int32_t diff = (int32_t)(seq - pos);
+
+        if (diff == 0) {
+            if (__atomic_compare_exchange_n(&(self->enqueuePos), &pos, pos + 1, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+                break;
+        }
+        else {
+            /* another producer took the position (the reservation guarantees that a cell is released) */
+            pos = __atomic_load_n(&(self->enqueuePos), __ATOMIC_RELAXED);
+        }
+    }
+
+    memcpy(&(cell->command), command, sizeof(SchedulerCommand));
+
+    __atomic_store_n(&(cell->sequence), pos + 1, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Add a command to the queue (can be called by multiple threads)
+ *
+ * @return true on success, false when the queue is full
+ */
+bool
+CommandQueue_push(CommandQueue* self, const SchedulerCommand* command)
+{
+    if (CommandQueue_reserve(self, 1) == false) {
+        /* queue is full */
+        return false;
+    }
+
+    CommandQueue_pushReserved(self, command);
+
+    return true;
+}
+
+/**
+ * @brief Take the oldest command from the queue (only called by the consumer thread)
+ *
+ * @return true when a command was copied to command, false when the queue is empty
+ */
+bool
+CommandQueue_pop(CommandQueue* self, SchedulerCommand* command)
+{
+    uint32_t pos = self->dequeuePos;
+
+    CommandQueueCell* cell = &(self->cells[pos % CONFIG_SCHEDULE_COMMAND_QUEUE_SIZE]);
+
+    uint32_t seq = __atomic_load_n(&(cell->sequence), __ATOMIC_ACQUIRE);
+
+    if ((int32_t)(seq - (pos + 1)) < 0)
+        return false;
+
+    memcpy(command, &(cell->command), sizeof(SchedulerCommand));
+
+    self->dequeuePos = pos + 1;
+
+    __atomic_store_n(&(cell->sequence), pos + CONFIG_SCHEDULE_COMMAND_QUEUE_SIZE, __ATOMIC_RELEASE);
+
+    /* the cell can be reserved again after it was released */
+    CommandQueue_releaseReservation(self, 1);
+
+    return true;
+}
@@ -4,6 +4,8 @@
 #include <stdio.h>
 #include <ctype.h>
 #include <math.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
 
 bool 
 scheduler_checkIfMultiObjInst(const char* name, const char* multiName)
@@ -36,9 +38,109 @@ scheduler_checkIfMultiObjInst(const char* name, const char* multiName)
     return isInstance;
 }
 
+bool
+scheduler_getNumericValue(MmsValue* value, double* numericValue)
+{
+    switch (MmsValue_getType(value)) {
+    case MMS_FLOAT:
+        *numericValue = MmsValue_toDouble(value);
+        return true;
+
+    case MMS_INTEGER:
+    case MMS_UNSIGNED:
+        *numericValue = (double)MmsValue_toInt64(value);
+        return true;
+
+    case MMS_BOOLEAN:
+        *numericValue = MmsValue_getBoolean(value) ? 1.0 : 0.0;
+        return true;
+
+    default:
+        return false;
+    }
+}
+
+/* nesting depth of scheduler_lockDataModel in the current thread (IedServer_lockDataModel is not recursive) */
+static __thread int dataModelLockDepth = 0;
+
+void
+scheduler_lockDataModel(IedServer server)
+{
+    if (dataModelLockDepth == 0)
+        IedServer_lockDataModel(server);
+
+    dataModelLockDepth++;
+}
+
+void
+scheduler_unlockDataModel(IedServer server)
+{
+    dataModelLockDepth--;
+
+    if (dataModelLockDepth == 0)
+        IedServer_unlockDataModel(server);
+}
+
+bool
+scheduler_isDataModelLocked(void)
+{
+    return (dataModelLockDepth > 0);
+}
+
+/* the current thread processes the schedules without own thread (scheduler thread or caller of Scheduler_process) */
+static __thread bool sharedProcessingThread = false;
+
+void
+scheduler_setSharedProcessingThread(void)
+{
+    sharedProcessingThread = true;
+}
+
+bool
+scheduler_isSharedProcessingThread(void)
+{
+    return sharedProcessingThread;
+}
+
+/**
+ * @brief Check if an update would rewrite the value and quality attributes with their current content
+ *
+ * Used in coalesced reporting mode to avoid data changes (and the related timestamp updates) that
+ * don't change anything for the client.
+ */
+bool
+scheduler_isValueUnchanged(DataAttribute* valueAttr, MmsValue* value, DataAttribute* qAttr, Quality quality)
+{
+    if (qAttr && qAttr->mmsValue) {
+        if (Quality_fromMmsValue(qAttr->mmsValue) != quality)
+            return false;
+    }
+
+    if (value == NULL)
+        return true;
+
+    if ((valueAttr == NULL) || (valueAttr->mmsValue == NULL))
+        return true;
+
+    return MmsValue_equals(valueAttr->mmsValue, value);
+}
+
 static void
 scheduler_initializeScheduleControllers(Scheduler self)
 {
+    /* the position is stored by the controllers in the setpoint history */
+    int listIdx = 0;
+
+    LinkedList scheduleElem = LinkedList_getNext(self->schedules);
+
+    while (scheduleElem) {
+        Schedule schedule = (Schedule)LinkedList_getData(scheduleElem);
+
+        schedule->listIdx = listIdx++;
+
+        scheduleElem = LinkedList_getNext(scheduleElem);
+    }
+
     LinkedList schedCtrlElem = LinkedList_getNext(self->scheduleController);
 
     while (schedCtrlElem) {
@@ -52,7 +154,68 @@ scheduler_initializeScheduleControllers(Scheduler self)
 }
 
 static void
-scheduler_parseModel(Scheduler self)
+scheduler_bindScheduleController(Scheduler self, LogicalDevice* ld, LogicalNode* ln)
+{
+    printf("INFO: Found schedule controller: %s/%s\n", ld->name, ln->name);
+
+    ScheduleController controller = ScheduleController_create(ln, self);
+
+    if (controller)
+        LinkedList_add(self->scheduleController, controller);
+}
+
+/**
+ * @param binding the resolved elements of the LN or NULL to resolve them by name
+ */
+static Schedule
+scheduler_createSchedule(Scheduler self, LogicalNode* ln, ScheduleBinding* binding)
+{
+    ScheduleHotState* hot = NULL;
+
+    if (self->numberOfHotStates < self->maxHotStates) {
+        hot = &(self->hotStates[self->numberOfHotStates]);
+        memset(hot, 0, sizeof(ScheduleHotState));
+    }
+
+    /* a schedule without element in the hot state array cannot be processed by the scheduler thread */
+    bool ownThread = (self->mode == SCHEDULER_MODE_THREAD_PER_SCHEDULE) || (hot == NULL);
+
+    Schedule sched = Schedule_createEx(ln, self->server, self->model, self->arena, hot, ownThread, binding);
+
+    if (sched && hot)
+        self->numberOfHotStates++;
+
+    if (sched) {
+        sched->processedByApplication = (self->mode == SCHEDULER_MODE_EXTERNAL) && (ownThread == false);
+
+        Schedule_setCoalescedReporting(sched, self->coalescedReporting);
+        Schedule_setEventFd(sched, self->eventFd);
+        Schedule_setThreadConfig(sched, &(self->threadConfig), &(self->threadConfigSequence));
+    }
+
+    return sched;
+}
+
+static void
+scheduler_bindSchedule(Scheduler self, LogicalDevice* ld, LogicalNode* ln, ScheduleBinding* binding)
+{
+    Schedule sched = scheduler_createSchedule(self, ln, binding);
+
+    if (sched) {
+        LinkedList_add(self->schedules, sched);
+    }
+    else {
+        printf("ERROR: Invalid schedule: %s/%s -> ignored\n", ld->name, ln->name);
+    }
+}
+
+/**
+ * @brief Search the data model for schedule controller and schedule instances
+ * 
+ * @param bindingCache when not NULL the found instances are added to the binding cache
+ */
+static void
+scheduler_parseModel(Scheduler self, BindingCache bindingCache)
 {
     if (self->model) {
         /* search data model for FSCC instances */
@@ -67,6 +230,8 @@ scheduler_parseModel(Scheduler self)
 
                 LogicalNode* ln = (LogicalNode*)ld->firstChild;
 
+                int lnIdx = 0;
+
                 while (ln) {
                     /* check if LN name contains "FSCC" */
 
@@ -90,28 +255,26 @@ scheduler_parseModel(Scheduler self)
                         }
 
                         if (isScheduleController) {
-                            printf("INFO: Found schedule controller: %s/%s\n", ld->name, ln->name);
+                            scheduler_bindScheduleController(self, ld, ln);
 
-                            ScheduleController controller = ScheduleController_create(ln, self);
-
-                            if (controller)
-                                LinkedList_add(self->scheduleController, controller);
+                            if (bindingCache)
+                                BindingCache_addEntry(bindingCache, i, lnIdx, BINDING_TYPE_SCHEDULE_CONTROLLER);
                         }
                     }
 
                     if (strstr(ln->name, "FSCH")) {
+                        ScheduleBinding binding;
 
-                        Schedule sched = Schedule_create(ln, self->server, self->model);
+                        Schedule_resolveBinding(ln, &binding);
 
-                        if (sched) {
-                            LinkedList_add(self->schedules, sched);
-                        }
-                        else {
-                            printf("ERROR: Invalid schedule: %s/%s -> ignored\n", ld->name, ln->name);
-                        }
+                        scheduler_bindSchedule(self, ld, ln, &binding);
+
+                        if (bindingCache)
+                            BindingCache_addScheduleEntry(bindingCache, i, lnIdx, ln, &binding);
                     }
 
                     ln = (LogicalNode*)ln->sibling;
+                    lnIdx++;
                 }
 
             }
@@ -121,144 +284,1600 @@ scheduler_parseModel(Scheduler self)
     }
 }
 
-Scheduler
-Scheduler_create(IedModel* model, IedServer server)
-{  
-    Scheduler self = (Scheduler)calloc(1, sizeof(struct sScheduler));
+/**
+ * @brief Bind the schedule controllers and schedules listed in the binding cache
+ * 
+ * The cache entries are in model order so the model is only traversed once. The elements of
+ * the schedule LNs are taken from the stored positions instead of searching them by name.
+ * 
+ * @return false when the cache doesn't fit the model (nothing is bound in this case)
+ */
+static bool
+scheduler_bindFromCache(Scheduler self, BindingCache bindingCache)
+{
+    int numberOfDevices = IedModel_getLogicalDeviceCount(self->model);
 
-    if (self) {
-        self->model = model;
-        self->server = server;
-        self->scheduleController = LinkedList_create();
-        self->schedules = LinkedList_create();
+    int entryIdx;
 
-        scheduler_parseModel(self);
+    /* check all entries before binding anything */
+    for (entryIdx = 1; entryIdx < bindingCache->numberOfEntries; entryIdx++) {
+        BindingCacheEntry* prev = &(bindingCache->entries[entryIdx - 1]);
+        BindingCacheEntry* entry = &(bindingCache->entries[entryIdx]);
+
+        if ((entry->ldIdx < prev->ldIdx) || ((entry->ldIdx == prev->ldIdx) && (entry->lnIdx <= prev->lnIdx)))
+            return false;
     }
 
-    return self;
+    if ((bindingCache->numberOfEntries > 0) && (bindingCache->entries[bindingCache->numberOfEntries - 1].ldIdx >= numberOfDevices))
+        return false;
+
+    LogicalDevice* ld = NULL;
+    LogicalNode* ln = NULL;
+    int ldIdx = -1;
+    int lnIdx = 0;
+
+    for (entryIdx = 0; entryIdx < bindingCache->numberOfEntries; entryIdx++) {
+        BindingCacheEntry* entry = &(bindingCache->entries[entryIdx]);
+
+        if (entry->ldIdx != ldIdx) {
+            ldIdx = entry->ldIdx;
+            ld = IedModel_getDeviceByIndex(self->model, ldIdx);
+
+            if (ld == NULL)
+                return false;
+
+            printf("INFO: Found LD: %s\n", ld->name);
+
+            ln = (LogicalNode*)ld->firstChild;
+            lnIdx = 0;
+        }
+
+        while (ln && (lnIdx < entry->lnIdx)) {
+            ln = (LogicalNode*)ln->sibling;
+            lnIdx++;
+        }
+
+        if (ln == NULL)
+            return false;
+
+        if (entry->type == BINDING_TYPE_SCHEDULE_CONTROLLER) {
+            scheduler_bindScheduleController(self, ld, ln);
+        }
+        else if (entry->type == BINDING_TYPE_SCHEDULE) {
+            if (entry->hasPositions) {
+                ScheduleBinding binding;
+
+                if (BindingCache_resolveScheduleBinding(entry, ln, &binding) == false)
+                    return false;
+
+                scheduler_bindSchedule(self, ld, ln, &binding);
+            }
+            else {
+                scheduler_bindSchedule(self, ld, ln, NULL);
+            }
+        }
+    }
+
+    scheduler_initializeScheduleControllers(self);
+
+    return true;
 }
 
-void
-Scheduler_destroy(Scheduler self)
+static void
+scheduler_copyChildValues(ModelNode* dst, ModelNode* src)
 {
-    if (self)
-    {
-        LinkedList_destroyDeep(self->scheduleController, (LinkedListValueDeleteFunction)ScheduleController_destroy);
+    ModelNode* srcChild = src->firstChild;
+    ModelNode* dstCursor = dst->firstChild;
 
-        LinkedList_destroyDeep(self->schedules, (LinkedListValueDeleteFunction)Schedule_destroy);
+    while (srcChild) {
+        ModelNode* dstChild = NULL;
 
-        free(self);
+        /* both models usually have the same element order */
+        if (dstCursor && (strcmp(dstCursor->name, srcChild->name) == 0))
+            dstChild = dstCursor;
+        else
+            dstChild = ModelNode_getChild(dst, srcChild->name);
+
+        if (dstChild) {
+            if ((srcChild->modelType == DataAttributeModelType) && (dstChild->modelType == DataAttributeModelType)) {
+                DataAttribute* srcAttr = (DataAttribute*)srcChild;
+                DataAttribute* dstAttr = (DataAttribute*)dstChild;
+
+                if (srcAttr->mmsValue && dstAttr->mmsValue)
+                    MmsValue_update(dstAttr->mmsValue, srcAttr->mmsValue);
+            }
+
+            scheduler_copyChildValues(dstChild, srcChild);
+
+            dstCursor = dstChild->sibling;
+        }
+
+        srcChild = srcChild->sibling;
     }
 }
 
+/**
+ * @brief Copy the values of all data attributes below src to the elements with the same names below dst
+ */
 void
-Scheduler_enableScheduleControl(Scheduler self, const char* scheduleRef, bool enable)
+scheduler_copyDataModelValues(IedServer server, ModelNode* dst, ModelNode* src)
 {
-    Schedule schedule = Scheduler_getScheduleByObjRef(self, scheduleRef);
+    IedServer_lockDataModel(server);
 
-    if (schedule) {
-        Schedule_enableScheduleControl(schedule, enable);
-    }
-    else {
-        printf("WARN: Schedule %s not found\n", scheduleRef);
-    }
+    scheduler_copyChildValues(dst, src);
+
+    IedServer_unlockDataModel(server);
 }
 
-bool
-Scheduler_enableSchedule(Scheduler self, const char* scheduleRef, bool enable)
+static bool
+scheduler_isSameNode(ModelNode* node1, ModelNode* node2)
 {
-    Schedule schedule = Scheduler_getScheduleByObjRef(self, scheduleRef);
+    return (strcmp(node1->name, node2->name) == 0) && (strcmp(node1->parent->name, node2->parent->name) == 0);
+}
 
-    if (schedule) {
-        return Schedule_enableSchedule(schedule, enable);
-    }
-    else {
-        printf("WARN: Schedule %s not found\n", scheduleRef);
+/**
+ * @brief Find and remove the element with the same LD/LN name and structure
+ * 
+ * The search starts at the cursor position because the elements of both models are usually in the same order.
+ * 
+ * @param elements array of Schedule or ScheduleController instances (NULL for elements already taken)
+ * @param nodes logical nodes of the elements
+ */
+static void*
+scheduler_takeMatchingElement(void** elements, LogicalNode** nodes, int numberOfElements, int* cursor, LogicalNode* ln)
+{
+    uint64_t lnHash = 0;
 
-        return false;
+    int i;
+
+    for (i = 0; i < numberOfElements; i++) {
+        int idx = (*cursor + i) % numberOfElements;
+
+        if (elements[idx] && scheduler_isSameNode((ModelNode*)nodes[idx], (ModelNode*)ln)) {
+
+            if (lnHash == 0)
+                lnHash = BindingCache_calculateNodeHash((ModelNode*)ln);
+
+            if (BindingCache_calculateNodeHash((ModelNode*)nodes[idx]) == lnHash) {
+                void* element = elements[idx];
+
+                elements[idx] = NULL;
+                *cursor = idx + 1;
+
+                return element;
+            }
+
+            return NULL;
+        }
     }
+
+    return NULL;
 }
 
-void
-Scheduler_enableWriteAccessToParameter(Scheduler self, const char* scheduleRef, Scheduler_ScheduleParameter parameter, bool enable)
+/**
+ * @brief Calculate the arena size required for the schedules and schedule controllers of the model
+ */
+static size_t
+scheduler_calculateArenaSize(IedModel* model, int* numberOfSchedules)
 {
-    Schedule schedule = Scheduler_getScheduleByObjRef(self, scheduleRef);
+    size_t size = 0;
 
-    if (schedule) {
-        switch (parameter)
-        {
-        case SCHED_PARAM_SCHD_PRIO:
-            Schedule_enableWriteAccessToSchdPrio(schedule, enable);
-            break;
+    *numberOfSchedules = 0;
 
-        case SCHED_PARAM_STR_TM:
-            Schedule_enableWriteAccessToStrTm(schedule, enable);
-            break;
+    int i;
 
-        case SCHED_PARAM_SCHD_REUSE:
-            Schedule_enableWriteAccessToSchdReuse(schedule, enable);
-            break;
-        
-        default:
-            printf("WARN: Unknown parameter %i\n", parameter);
-            break;
+    for (i = 0; i < IedModel_getLogicalDeviceCount(model); i++) {
+        LogicalDevice* ld = IedModel_getDeviceByIndex(model, i);
+
+        if (ld == NULL)
+            continue;
+
+        LogicalNode* ln = (LogicalNode*)ld->firstChild;
+
+        while (ln) {
+            bool isSchedule = (strstr(ln->name, "FSCH") != NULL);
+            bool isController = (strstr(ln->name, "FSCC") != NULL);
+
+            if (isSchedule || isController) {
+                DataObject* dObj = (DataObject*)ln->firstChild;
+
+                while (dObj) {
+                    if (isSchedule && scheduler_checkIfMultiObjInst(dObj->name, "StrTm"))
+                        size += sizeof(ScheduleStartTime) + sizeof(uint64_t);
+                    else if (isSchedule && (strncmp(dObj->name, "Val", 3) == 0))
+                        size += sizeof(DataAttribute*);
+                    else if (isController && scheduler_checkIfMultiObjInst(dObj->name, "Schd"))
+                        size += sizeof(Schedule);
+
+                    dObj = (DataObject*)dObj->sibling;
+                }
+            }
+
+            if (isSchedule) {
+                size += sizeof(struct sSchedule) + sizeof(ScheduleHotState) + 24; /* 24: alignment of three tables */
+                (*numberOfSchedules)++;
+            }
+
+            if (isController)
+                size += sizeof(struct sScheduleController) + 16;
+
+            ln = (LogicalNode*)ln->sibling;
         }
     }
-    else {
-        printf("WARN: Schedule %s not found\n", scheduleRef);
-    }
+
+    return size;
 }
 
-void
-Scheduler_setTargetValueHandler(Scheduler self, Scheduler_TargetValueChanged handler, void* parameter)
+static Scheduler
+scheduler_allocate(IedModel* model, IedServer server, Scheduler_Mode mode)
 {
-    self->targetValueHandler = handler;
-    self->targetValueHandlerParameter = parameter;
+    Scheduler self = (Scheduler)calloc(1, sizeof(struct sScheduler));
+
+    if (self) {
+        self->model = model;
+        self->server = server;
+        self->mode = mode;
+        self->scheduleController = LinkedList_create();
+        self->schedules = LinkedList_create();
+
+        if (model) {
+            int numberOfSchedules = 0;
+
+            size_t arenaSize = scheduler_calculateArenaSize(model, &numberOfSchedules);
+
+            self->arena = MemoryArena_create(arenaSize);
+
+            if (self->arena) {
+                /* hot states first to keep them in one contiguous array */
+                if (numberOfSchedules > 0)
+                    self->hotStates = (ScheduleHotState*)MemoryArena_alloc(self->arena, numberOfSchedules * sizeof(ScheduleHotState));
+
+                if (self->hotStates)
+                    self->maxHotStates = numberOfSchedules;
+            }
+            else {
+                printf("WARN: Failed to allocate scheduler arena -> use heap\n");
+            }
+        }
+    }
+
+    return self;
 }
 
-void
-scheduler_targetValueChanged(Scheduler self, DataAttribute* targetAttr, MmsValue* value, Quality quality, uint64_t timestampMs)
+static void
+scheduler_processCycle(Scheduler self, uint64_t currentTime)
 {
-    if (self->targetValueHandler) {
-        char targetValueObjRef[130];
+    if (self->mode != SCHEDULER_MODE_THREAD_PER_SCHEDULE) {
+        int i;
 
-        ModelNode_getObjectReferenceEx((ModelNode*)targetAttr, targetValueObjRef, true);
+        for (i = 0; i < self->numberOfHotStates; i++) {
+            ScheduleHotState* hot = &(self->hotStates[i]);
 
-        self->targetValueHandler(self->targetValueHandlerParameter, targetValueObjRef, value, quality, timestampMs);
+            if (hot->schedule && ScheduleHotState_needsProcessing(hot, currentTime))
+                Schedule_process(hot->schedule, currentTime);
+        }
+    }
+
+    if (self->processOutputs) {
+        LinkedList schedCtrlElem = LinkedList_getNext(self->scheduleController);
+
+        while (schedCtrlElem) {
+            ScheduleController_processOutput((ScheduleController)LinkedList_getData(schedCtrlElem), currentTime);
+
+            schedCtrlElem = LinkedList_getNext(schedCtrlElem);
+        }
     }
 }
 
-Schedule
-Scheduler_getScheduleByObjRef(Scheduler self, const char* objRef)
+static void*
+scheduler_thread(void* parameter)
 {
-    Schedule matchingSchedule = NULL;
+    Scheduler self = (Scheduler)parameter;
 
-    if (objRef && objRef[0] != 0) {
+    scheduler_setSharedProcessingThread();
 
-        bool withoutIedName = false;
+    while (self->threadRunning) {
+        scheduler_updateThreadConfig(&(self->threadConfig), &(self->threadConfigSequence), &(self->appliedThreadConfig));
 
-        if (objRef[0] == '@') {
-            withoutIedName = true;
-            objRef = objRef + 1;
-        }
+        scheduler_processCycle(self, Hal_getTimeInMs());
 
-        LinkedList scheduleElem = LinkedList_getNext(self->schedules);
+        uint64_t sleepStart = SchedulerRt_getMonotonicTimeInUs();
 
-        while (scheduleElem) {
-            Schedule schedule = (Schedule)LinkedList_getData(scheduleElem);
+        Thread_sleep(100);
 
-            char scheduleObjRefBuf[130];
+        SchedulerRtLatency_addWakeup(&(self->latency), sleepStart, 100);
+    }
 
-            ModelNode_getObjectReferenceEx((ModelNode*)schedule->scheduleLn, scheduleObjRefBuf, withoutIedName);
+    return NULL;
+}
 
-            if (!strcmp(objRef, scheduleObjRefBuf)) {
-                matchingSchedule = schedule;
-                break;
-            }
+static void
+scheduler_startThread(Scheduler self)
+{
+    if (self->mode == SCHEDULER_MODE_EXTERNAL)
+        return;
 
-            scheduleElem = LinkedList_getNext(scheduleElem);
+    if (((self->mode == SCHEDULER_MODE_LOW_FOOTPRINT) || self->processOutputs) && (self->thread == NULL)) {
+        self->thread = Thread_create(scheduler_thread, self, false);
+
+        if (self->thread) {
+            self->threadRunning = true;
+            Thread_start(self->thread);
         }
     }
+}
 
-    return matchingSchedule;
+static void
+scheduler_stopThread(Scheduler self)
+{
+    if (self->thread) {
+        self->threadRunning = false;
+        Thread_destroy(self->thread);
+        self->thread = NULL;
+    }
+}
+
+Scheduler
+Scheduler_create(IedModel* model, IedServer server)
+{  
+    return Scheduler_createEx(model, server, SCHEDULER_MODE_THREAD_PER_SCHEDULE, NULL);
+}
+
+Scheduler
+Scheduler_createWithBindingCache(IedModel* model, IedServer server, const char* cacheFile)
+{
+    return Scheduler_createEx(model, server, SCHEDULER_MODE_THREAD_PER_SCHEDULE, cacheFile);
+}
+
+static void
+scheduler_bindWithBindingCache(Scheduler self, const char* cacheFile)
+{
+    IedModel* model = self->model;
+
+    uint64_t modelHash = BindingCache_calculateModelHash(model);
+
+    BindingCache bindingCache = BindingCache_load(cacheFile);
+
+    if (bindingCache) {
+        bool bound = false;
+
+        if (bindingCache->modelHash == modelHash)
+            bound = scheduler_bindFromCache(self, bindingCache);
+
+        BindingCache_destroy(bindingCache);
+
+        if (bound) {
+            printf("INFO: Model bound from binding cache %s\n", cacheFile);
+            return;
+        }
+
+        printf("WARN: Binding cache %s doesn't match the model -> full parse\n", cacheFile);
+
+        /* release instances bound before a corrupted entry was detected */
+        LinkedList_destroyDeep(self->scheduleController, (LinkedListValueDeleteFunction)ScheduleController_destroy);
+        LinkedList_destroyDeep(self->schedules, (LinkedListValueDeleteFunction)Schedule_destroy);
+
+        self->scheduleController = LinkedList_create();
+        self->schedules = LinkedList_create();
+        self->numberOfHotStates = 0;
+    }
+
+    bindingCache = BindingCache_create(modelHash);
+
+    scheduler_parseModel(self, bindingCache);
+
+    if (bindingCache) {
+        BindingCache_save(bindingCache, cacheFile);
+        BindingCache_destroy(bindingCache);
+    }
+}
+
+Scheduler
+Scheduler_createEx(IedModel* model, IedServer server, Scheduler_Mode mode, const char* cacheFile)
+{
+    Scheduler self = scheduler_allocate(model, server, mode);
+
+    if (self) {
+        self->eventFd = -1;
+        self->overrideLatencyLimitInUs = CONFIG_SCHEDULER_OVERRIDE_LATENCY_LIMIT_US;
+
+        if (mode == SCHEDULER_MODE_EXTERNAL) {
+            self->eventFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+            if (self->eventFd == -1)
+                printf("WARN: Failed to create scheduler event file descriptor\n");
+        }
+
+        uint64_t bindStart = SchedulerRt_getMonotonicTimeInUs();
+
+        if (cacheFile && model)
+            scheduler_bindWithBindingCache(self, cacheFile);
+        else
+            scheduler_parseModel(self, NULL);
+
+        printf("INFO: Bound %i schedule controllers and %i schedules in %llu us\n",
+            LinkedList_size(self->scheduleController), LinkedList_size(self->schedules),
+            (unsigned long long)(SchedulerRt_getMonotonicTimeInUs() - bindStart));
+
+        scheduler_startThread(self);
+    }
+
+    return self;
+}
+
+/**
+ * @brief Assign a slot of the shared memory region to each schedule controller (in model order)
+ *
+ * @return the number of assigned slots
+ */
+static int
+scheduler_assignShmSlots(Scheduler self, ShmPublisher publisher)
+{
+    int slotIdx = 0;
+
+    LinkedList schedCtrlElem = LinkedList_getNext(self->scheduleController);
+
+    while (schedCtrlElem) {
+        ScheduleController controller = (ScheduleController)LinkedList_getData(schedCtrlElem);
+
+        char controllerRef[130];
+
+        ModelNode_getObjectReferenceEx((ModelNode*)controller->controllerLn, controllerRef, true);
+
+        ShmPublisher_initializeSlot(publisher, slotIdx, controllerRef);
+
+        controller->shmSlot = slotIdx++;
+
+        schedCtrlElem = LinkedList_getNext(schedCtrlElem);
+    }
+
+    return slotIdx;
+}
+
+bool
+Scheduler_reconfigure(Scheduler self, IedModel* model, IedServer server)
+{
+    if ((model == NULL) || (server == NULL))
+        return false;
+
+    int numberOfOldSchedules = LinkedList_size(self->schedules);
+    int numberOfOldControllers = LinkedList_size(self->scheduleController);
+
+    Schedule* oldSchedules = (Schedule*)calloc(numberOfOldSchedules + 1, sizeof(Schedule));
+    LogicalNode** oldScheduleLns = (LogicalNode**)calloc(numberOfOldSchedules + 1, sizeof(LogicalNode*));
+    ScheduleController* oldControllers = (ScheduleController*)calloc(numberOfOldControllers + 1, sizeof(ScheduleController));
+    LogicalNode** oldControllerLns = (LogicalNode**)calloc(numberOfOldControllers + 1, sizeof(LogicalNode*));
+
+    LinkedList schedules = LinkedList_create();
+    LinkedList controllers = LinkedList_create();
+    LinkedList keptControllers = LinkedList_create();
+    LinkedList removedSchedules = LinkedList_create();
+
+    if (!oldSchedules || !oldScheduleLns || !oldControllers || !oldControllerLns || !schedules || !controllers || !keptControllers || !removedSchedules) {
+        free(oldSchedules);
+        free(oldScheduleLns);
+        free(oldControllers);
+        free(oldControllerLns);
+
+        if (schedules) LinkedList_destroyStatic(schedules);
+        if (controllers) LinkedList_destroyStatic(controllers);
+        if (keptControllers) LinkedList_destroyStatic(keptControllers);
+        if (removedSchedules) LinkedList_destroyStatic(removedSchedules);
+
+        return false;
+    }
+
+    scheduler_stopThread(self);
+
+    int i = 0;
+
+    LinkedList elem = LinkedList_getNext(self->schedules);
+
+    while (elem) {
+        oldSchedules[i] = (Schedule)LinkedList_getData(elem);
+        oldScheduleLns[i] = oldSchedules[i]->scheduleLn;
+
+        /* stop all schedules while the references between schedules and controllers are updated */
+        Schedule_suspend(oldSchedules[i]);
+
+        /* queued commands refer to elements of the old model */
+        Schedule_executeCommands(oldSchedules[i]);
+
+        i++;
+        elem = LinkedList_getNext(elem);
+    }
+
+    i = 0;
+
+    elem = LinkedList_getNext(self->scheduleController);
+
+    while (elem) {
+        oldControllers[i] = (ScheduleController)LinkedList_getData(elem);
+        oldControllerLns[i] = oldControllers[i]->controllerLn;
+
+        i++;
+        elem = LinkedList_getNext(elem);
+    }
+
+    self->model = model;
+    self->server = server;
+
+    /* new hot state array in the order of the new model - the old array stays valid for removed schedules */
+    int numberOfNewSchedules = 0;
+
+    scheduler_calculateArenaSize(model, &numberOfNewSchedules);
+
+    self->hotStates = NULL;
+    self->numberOfHotStates = 0;
+    self->maxHotStates = 0;
+
+    if (self->arena && (numberOfNewSchedules > 0)) {
+        self->hotStates = (ScheduleHotState*)MemoryArena_alloc(self->arena, numberOfNewSchedules * sizeof(ScheduleHotState));
+
+        if (self->hotStates)
+            self->maxHotStates = numberOfNewSchedules;
+    }
+
+    int scheduleCursor = 0;
+    int controllerCursor = 0;
+
+    int numberOfKeptSchedules = 0;
+
+    int ldIdx;
+
+    for (ldIdx = 0; ldIdx < IedModel_getLogicalDeviceCount(model); ldIdx++) {
+        LogicalDevice* ld = IedModel_getDeviceByIndex(model, ldIdx);
+
+        if (ld == NULL)
+            continue;
+
+        LogicalNode* ln = (LogicalNode*)ld->firstChild;
+
+        while (ln) {
+            if (strstr(ln->name, "FSCC")) {
+                if (ModelNode_getChild((ModelNode*)ln, "ActSchdRef") && ModelNode_getChild((ModelNode*)ln, "CtlEnt")) {
+                    ScheduleController controller = (ScheduleController)scheduler_takeMatchingElement((void**)oldControllers,
+                        oldControllerLns, numberOfOldControllers, &controllerCursor, ln);
+
+                    if (controller) {
+                        ScheduleController_rebind(controller, ln);
+                        LinkedList_add(keptControllers, controller);
+                    }
+                    else {
+                        printf("INFO: Add schedule controller: %s/%s\n", ld->name, ln->name);
+
+                        controller = ScheduleController_create(ln, self);
+                    }
+
+                    if (controller)
+                        LinkedList_add(controllers, controller);
+                }
+                else {
+                    printf("ERROR: ActSchdRef or CtlEnt not found in LN %s -> skip LN\n", ln->name);
+                }
+            }
+
+            if (strstr(ln->name, "FSCH")) {
+                Schedule sched = (Schedule)scheduler_takeMatchingElement((void**)oldSchedules,
+                    oldScheduleLns, numberOfOldSchedules, &scheduleCursor, ln);
+
+                if (sched) {
+                    if (self->numberOfHotStates < self->maxHotStates) {
+                        ScheduleHotState* hot = &(self->hotStates[self->numberOfHotStates++]);
+
+                        *hot = *(sched->hot);
+                        hot->schedule = sched;
+                        sched->hot = hot;
+                    }
+
+                    if (Schedule_rebind(sched, ln, server, model)) {
+                        LinkedList_add(schedules, sched);
+                        numberOfKeptSchedules++;
+                    }
+                    else {
+                        printf("ERROR: Failed to move schedule %s/%s -> removed\n", ld->name, ln->name);
+                        LinkedList_add(removedSchedules, sched);
+                    }
+                }
+                else {
+                    printf("INFO: Add schedule: %s/%s\n", ld->name, ln->name);
+
+                    sched = scheduler_createSchedule(self, ln, NULL);
+
+                    if (sched)
+                        LinkedList_add(schedules, sched);
+                    else
+                        printf("ERROR: Invalid schedule: %s/%s -> ignored\n", ld->name, ln->name);
+                }
+            }
+
+            ln = (LogicalNode*)ln->sibling;
+        }
+    }
+
+    /* controllers are informed again when they are initialized with the new schedule references */
+    elem = LinkedList_getNext(schedules);
+
+    while (elem) {
+        Schedule sched = (Schedule)LinkedList_getData(elem);
+
+        Schedule_clearListeningControllers(sched);
+
+        elem = LinkedList_getNext(elem);
+    }
+
+    bool* activeScheduleRemoved = (bool*)calloc(LinkedList_size(keptControllers) + 1, sizeof(bool));
+
+    for (i = 0; i < numberOfOldSchedules; i++) {
+        if (oldSchedules[i]) {
+            printf("INFO: Remove schedule: %s/%s\n", oldScheduleLns[i]->parent->name, oldScheduleLns[i]->name);
+
+            LinkedList_add(removedSchedules, oldSchedules[i]);
+        }
+    }
+
+    LinkedList removedElem = LinkedList_getNext(removedSchedules);
+
+    while (removedElem) {
+        Schedule sched = (Schedule)LinkedList_getData(removedElem);
+
+        int ctrlIdx = 0;
+
+        elem = LinkedList_getNext(keptControllers);
+
+        while (elem) {
+            ScheduleController controller = (ScheduleController)LinkedList_getData(elem);
+
+            if (controller->activeSchedule == sched) {
+                controller->activeSchedule = NULL;
+
+                if (activeScheduleRemoved)
+                    activeScheduleRemoved[ctrlIdx] = true;
+            }
+
+            ctrlIdx++;
+            elem = LinkedList_getNext(elem);
+        }
+
+        removedElem = LinkedList_getNext(removedElem);
+    }
+
+    LinkedList_destroyDeep(removedSchedules, (LinkedListValueDeleteFunction)Schedule_destroy);
+
+    for (i = 0; i < numberOfOldControllers; i++) {
+        if (oldControllers[i]) {
+            printf("INFO: Remove schedule controller: %s/%s\n", oldControllerLns[i]->parent->name, oldControllerLns[i]->name);
+
+            ScheduleController_destroy(oldControllers[i]);
+        }
+    }
+
+    LinkedList_destroyStatic(self->schedules);
+    LinkedList_destroyStatic(self->scheduleController);
+
+    self->schedules = schedules;
+    self->scheduleController = controllers;
+
+    /* new region with a slot for each controller of the new model (kept controllers keep their last output) */
+    if (self->shmPublisher) {
+        self->shmPublisher = ShmPublisher_recreate(self->shmPublisher, LinkedList_size(self->scheduleController));
+
+        if (self->shmPublisher) {
+            scheduler_assignShmSlots(self, self->shmPublisher);
+            ShmPublisher_releasePreviousSlots(self->shmPublisher);
+        }
+        else {
+            printf("ERROR: Failed to recreate the shared memory region -> publication disabled\n");
+
+            elem = LinkedList_getNext(self->scheduleController);
+
+            while (elem) {
+                ((ScheduleController)LinkedList_getData(elem))->shmSlot = -1;
+
+                elem = LinkedList_getNext(elem);
+            }
+        }
+    }
+
+    scheduler_initializeScheduleControllers(self);
+
+    int ctrlIdx = 0;
+
+    elem = LinkedList_getNext(keptControllers);
+
+    while (elem) {
+        ScheduleController controller = (ScheduleController)LinkedList_getData(elem);
+
+        ScheduleController_updateActiveSchedule(controller, activeScheduleRemoved ? activeScheduleRemoved[ctrlIdx] : false);
+
+        ctrlIdx++;
+        elem = LinkedList_getNext(elem);
+    }
+
+    elem = LinkedList_getNext(self->schedules);
+
+    while (elem) {
+        Schedule_resume((Schedule)LinkedList_getData(elem));
+
+        elem = LinkedList_getNext(elem);
+    }
+
+    scheduler_startThread(self);
+
+    printf("INFO: Reconfiguration done (kept %i schedule(s) and %i controller(s), %i schedule(s) and %i controller(s) in total)\n",
+        numberOfKeptSchedules, LinkedList_size(keptControllers), LinkedList_size(self->schedules), LinkedList_size(self->scheduleController));
+
+    free(activeScheduleRemoved);
+    free(oldSchedules);
+    free(oldScheduleLns);
+    free(oldControllers);
+    free(oldControllerLns);
+
+    LinkedList_destroyStatic(keptControllers);
+
+    return true;
+}
+
+void
+Scheduler_destroy(Scheduler self)
+{
+    if (self)
+    {
+        scheduler_stopThread(self);
+
+        /* queued batch commands resume the arbitration of their controllers -> before the controllers are destroyed */
+        LinkedList elem = LinkedList_getNext(self->schedules);
+
+        while (elem) {
+            Schedule schedule = (Schedule)LinkedList_getData(elem);
+
+            Schedule_suspend(schedule);
+            Schedule_cancelCommands(schedule);
+
+            elem = LinkedList_getNext(elem);
+        }
+
+        LinkedList_destroyDeep(self->scheduleController, (LinkedListValueDeleteFunction)ScheduleController_destroy);
+
+        LinkedList_destroyDeep(self->schedules, (LinkedListValueDeleteFunction)Schedule_destroy);
+
+        MemoryArena_destroy(self->arena);
+
+        if (self->shmPublisher)
+            ShmPublisher_destroy(self->shmPublisher);
+
+        if (self->eventFd != -1)
+            close(self->eventFd);
+
+        free(self);
+    }
+}
+
+uint64_t
+Scheduler_getNextDeadline(Scheduler self, uint64_t currentTime)
+{
+    uint64_t nextDeadline = 0;
+
+    int i;
+
+    for (i = 0; i < self->numberOfHotStates; i++) {
+        ScheduleHotState* hot = &(self->hotStates[i]);
+
+        if (hot->schedule) {
+            uint64_t deadline = ScheduleHotState_getNextDeadline(hot, currentTime);
+
+            if (deadline && ((nextDeadline == 0) || (deadline < nextDeadline)))
+                nextDeadline = deadline;
+        }
+    }
+
+    if (self->processOutputs) {
+        LinkedList schedCtrlElem = LinkedList_getNext(self->scheduleController);
+
+        while (schedCtrlElem) {
+            uint64_t deadline = ScheduleController_getNextDeadline((ScheduleController)LinkedList_getData(schedCtrlElem));
+
+            if (deadline && ((nextDeadline == 0) || (deadline < nextDeadline)))
+                nextDeadline = deadline;
+
+            schedCtrlElem = LinkedList_getNext(schedCtrlElem);
+        }
+    }
+
+    return nextDeadline;
+}
+
+void
+Scheduler_process(Scheduler self, uint64_t currentTime)
+{
+    if (self->mode != SCHEDULER_MODE_EXTERNAL) {
+        printf("WARN: Scheduler_process is only allowed in external mode\n");
+        return;
+    }
+
+    scheduler_setSharedProcessingThread();
+
+    /* reset the event - the queued commands are executed by the schedules */
+    if (self->eventFd != -1) {
+        uint64_t value;
+
+        if (read(self->eventFd, &value, sizeof(value)) < 0) {
+            /* EAGAIN - no event */
+        }
+    }
+
+    scheduler_processCycle(self, currentTime);
+}
+
+int
+Scheduler_getEventFd(Scheduler self)
+{
+    return self->eventFd;
+}
+
+void
+Scheduler_enableScheduleControl(Scheduler self, const char* scheduleRef, bool enable)
+{
+    Schedule schedule = Scheduler_getScheduleByObjRef(self, scheduleRef);
+
+    if (schedule) {
+        Schedule_enableScheduleControl(schedule, enable);
+    }
+    else {
+        printf("WARN: Schedule %s not found\n", scheduleRef);
+    }
+}
+
+bool
+Scheduler_enableSchedule(Scheduler self, const char* scheduleRef, bool enable)
+{
+    Schedule schedule = Scheduler_getScheduleByObjRef(self, scheduleRef);
+
+    if (schedule) {
+        return Schedule_enableSchedule(schedule, enable);
+    }
+    else {
+        printf("WARN: Schedule %s not found\n", scheduleRef);
+
+        return false;
+    }
+}
+
+/**
+ * @brief Called by the thread that executed a command of the batch (the last one resumes the arbitration)
+ */
+void
+scheduler_finishBatchCommand(SchedulerBatch batch)
+{
+    if (__atomic_sub_fetch(&(batch->pendingCommands), 1, __ATOMIC_ACQ_REL) == 0) {
+        int i;
+
+        for (i = 0; i < batch->numberOfControllers; i++)
+            ScheduleController_resumeArbitration(batch->controllers[i]);
+
+        free(batch);
+    }
+}
+
+static void
+scheduler_addBatchController(SchedulerBatch batch, ScheduleController controller)
+{
+    int i;
+
+    for (i = 0; i < batch->numberOfControllers; i++) {
+        if (batch->controllers[i] == controller)
+            return;
+    }
+
+    batch->controllers[batch->numberOfControllers++] = controller;
+}
+
+bool
+Scheduler_applyScheduleChanges(Scheduler self, const Scheduler_ScheduleChange* changes, int numberOfChanges)
+{
+    if (numberOfChanges < 1)
+        return (numberOfChanges == 0);
+
+    Schedule* schedules = (Schedule*)malloc(numberOfChanges * sizeof(Schedule));
+
+    int maxControllers = numberOfChanges * CONFIG_SCHEDULE_MAX_LISTENING_CONTROLLERS;
+
+    SchedulerBatch batch = (SchedulerBatch)malloc(sizeof(struct sSchedulerBatch) + maxControllers * sizeof(ScheduleController));
+
+    if ((schedules == NULL) || (batch == NULL)) {
+        printf("ERROR: Out of memory\n");
+
+        free(schedules);
+        free(batch);
+
+        return false;
+    }
+
+    batch->controllers = (ScheduleController*)(batch + 1);
+    batch->numberOfControllers = 0;
+
+    int i;
+
+    /* resolve all schedules first - nothing is changed when a reference is invalid */
+    for (i = 0; i < numberOfChanges; i++) {
+        schedules[i] = Scheduler_getScheduleByObjRef(self, changes[i].scheduleRef);
+
+        if (schedules[i] == NULL) {
+            printf("WARN: Schedule %s not found\n", changes[i].scheduleRef);
+            break;
+        }
+
+        int j;
+
+        for (j = 0; j < schedules[i]->numberOfListeningControllers; j++)
+            scheduler_addBatchController(batch, schedules[i]->listeningControllers[j]);
+    }
+
+    if (i < numberOfChanges) {
+        free(schedules);
+        free(batch);
+
+        return false;
+    }
+
+    /* check all changes before anything is queued - the batch is applied completely or not at all */
+    for (i = 0; i < numberOfChanges; i++) {
+        if ((changes[i].type != SCHED_CHANGE_ENABLE) && (changes[i].type != SCHED_CHANGE_DISABLE) &&
+            (changes[i].type != SCHED_CHANGE_SET_PRIO))
+        {
+            printf("WARN: Invalid change of schedule %s\n", changes[i].scheduleRef);
+            break;
+        }
+
+        if ((changes[i].type == SCHED_CHANGE_ENABLE) && (Schedule_checkEnable(schedules[i]) == false)) {
+            printf("WARN: Schedule %s cannot be enabled\n", changes[i].scheduleRef);
+            break;
+        }
+    }
+
+    /* reserve the space in the command queues, so that queuing the commands cannot fail */
+    if (i == numberOfChanges) {
+        for (i = 0; i < numberOfChanges; i++) {
+            if (Schedule_reserveCommands(schedules[i], 1) == false) {
+                printf("WARN: Command queue of schedule %s is full\n", changes[i].scheduleRef);
+
+                int j;
+
+                for (j = 0; j < i; j++)
+                    Schedule_releaseCommandReservation(schedules[j], 1);
+
+                break;
+            }
+        }
+    }
+
+    if (i < numberOfChanges) {
+        free(schedules);
+        free(batch);
+
+        return false;
+    }
+
+    for (i = 0; i < batch->numberOfControllers; i++)
+        ScheduleController_suspendArbitration(batch->controllers[i]);
+
+    /* one additional reference of this thread, so that the batch can't complete while queuing the commands */
+    batch->pendingCommands = numberOfChanges + 1;
+
+    for (i = 0; i < numberOfChanges; i++) {
+        SchedulerCommand command;
+
+        memset(&command, 0, sizeof(command));
+
+        switch (changes[i].type) {
+        case SCHED_CHANGE_ENABLE:
+            command.type = SCHD_CMD_ENABLE;
+            break;
+
+        case SCHED_CHANGE_DISABLE:
+            command.type = SCHD_CMD_DISABLE;
+            break;
+
+        default:
+            command.type = SCHD_CMD_SET_PRIO;
+            command.intValue = changes[i].prio;
+            break;
+        }
+
+        command.batch = batch;
+
+        Schedule_sendReservedCommand(schedules[i], &command);
+    }
+
+    free(schedules);
+
+    scheduler_finishBatchCommand(batch);
+
+    return true;
+}
+
+bool
+Scheduler_setScheduleInterpolation(Scheduler self, const char* scheduleRef, bool enable, int outputIntervalInMs)
+{
+    Schedule schedule = Scheduler_getScheduleByObjRef(self, scheduleRef);
+
+    if (schedule) {
+        return Schedule_setInterpolation(schedule, enable, outputIntervalInMs);
+    }
+    else {
+        printf("WARN: Schedule %s not found\n", scheduleRef);
+
+        return false;
+    }
+}
+
+bool
+Scheduler_setScheduleEntryDurations(Scheduler self, const char* scheduleRef, const int* durationsInMs, int numberOfDurations)
+{
+    Schedule schedule = Scheduler_getScheduleByObjRef(self, scheduleRef);
+
+    if (schedule) {
+        return Schedule_setEntryDurations(schedule, durationsInMs, numberOfDurations);
+    }
+    else {
+        printf("WARN: Schedule %s not found\n", scheduleRef);
+
+        return false;
+    }
+}
+
+bool
+Scheduler_uploadCompressedSchedule(Scheduler self, const char* scheduleRef, const uint8_t* data, int size)
+{
+    Schedule schedule = Scheduler_getScheduleByObjRef(self, scheduleRef);
+
+    if (schedule) {
+        ScheduleRleReader reader;
+
+        if (ScheduleRleReader_initialize(&reader, data, size) == false) {
+            printf("WARN: Invalid compressed schedule for %s\n", scheduleRef);
+
+            return false;
+        }
+
+        return Schedule_writeCompressedValues(schedule, &reader);
+    }
+    else {
+        printf("WARN: Schedule %s not found\n", scheduleRef);
+
+        return false;
+    }
+}
+
+int
+Scheduler_exportCompressedSchedule(Scheduler self, const char* scheduleRef, uint8_t* buffer, int bufferSize)
+{
+    Schedule schedule = Scheduler_getScheduleByObjRef(self, scheduleRef);
+
+    if (schedule) {
+        return Schedule_readCompressedValues(schedule, buffer, bufferSize);
+    }
+    else {
+        printf("WARN: Schedule %s not found\n", scheduleRef);
+
+        return -1;
+    }
+}
+
+void
+Scheduler_enableWriteAccessToParameter(Scheduler self, const char* scheduleRef, Scheduler_ScheduleParameter parameter, bool enable)
+{
+    Schedule schedule = Scheduler_getScheduleByObjRef(self, scheduleRef);
+
+    if (schedule) {
+        switch (parameter)
+        {
+        case SCHED_PARAM_SCHD_PRIO:
+            Schedule_enableWriteAccessToSchdPrio(schedule, enable);
+            break;
+
+        case SCHED_PARAM_STR_TM:
+            Schedule_enableWriteAccessToStrTm(schedule, enable);
+            break;
+
+        case SCHED_PARAM_SCHD_REUSE:
+            Schedule_enableWriteAccessToSchdReuse(schedule, enable);
+            break;
+        
+        default:
+            printf("WARN: Unknown parameter %i\n", parameter);
+            break;
+        }
+    }
+    else {
+        printf("WARN: Schedule %s not found\n", scheduleRef);
+    }
+}
+
+void
+Scheduler_setTargetValueHandler(Scheduler self, Scheduler_TargetValueChanged handler, void* parameter)
+{
+    self->targetValueHandler = handler;
+    self->targetValueHandlerParameter = parameter;
+}
+
+void
+scheduler_targetValueChanged(Scheduler self, DataAttribute* targetAttr, MmsValue* value, Quality quality, uint64_t timestampMs)
+{
+    if (self->targetValueHandler) {
+        char targetValueObjRef[130];
+
+        ModelNode_getObjectReferenceEx((ModelNode*)targetAttr, targetValueObjRef, true);
+
+        self->targetValueHandler(self->targetValueHandlerParameter, targetValueObjRef, value, quality, timestampMs);
+    }
+}
+
+bool
+Scheduler_enableSharedMemoryPublication(Scheduler self, const char* name, bool notify)
+{
+    if (self->shmPublisher) {
+        printf("WARN: Shared memory publication already enabled\n");
+        return false;
+    }
+
+    ShmPublisher publisher = ShmPublisher_create(name, LinkedList_size(self->scheduleController), notify);
+
+    if (publisher == NULL)
+        return false;
+
+    int numberOfSlots = scheduler_assignShmSlots(self, publisher);
+
+    self->shmPublisher = publisher;
+
+    printf("INFO: Publishing %i schedule controller(s) in shared memory %s\n", numberOfSlots, name);
+
+    return true;
+}
+
+void
+scheduler_publishTargetValue(Scheduler self, ScheduleController controller, DataAttribute* targetAttr, MmsValue* value, Quality quality, uint64_t timestampMs)
+{
+    if (self->shmPublisher && (controller->shmSlot != -1)) {
+        char targetValueObjRef[130];
+
+        ModelNode_getObjectReferenceEx((ModelNode*)targetAttr, targetValueObjRef, true);
+
+        ShmPublisher_publish(self->shmPublisher, controller->shmSlot, targetValueObjRef, value, quality, timestampMs,
+            controller->activeScheduleRef);
+    }
+}
+
+void
+Scheduler_enableCoalescedReporting(Scheduler self, bool enable)
+{
+    self->coalescedReporting = enable;
+
+    LinkedList scheduleElem = LinkedList_getNext(self->schedules);
+
+    while (scheduleElem) {
+        Schedule schedule = (Schedule)LinkedList_getData(scheduleElem);
+
+        Schedule_setCoalescedReporting(schedule, enable);
+
+        scheduleElem = LinkedList_getNext(scheduleElem);
+    }
+}
+
+bool
+Scheduler_setTargetValueFilter(Scheduler self, const char* controllerRef, const Scheduler_TargetValueFilter* filter)
+{
+    ScheduleController controller = Scheduler_getScheduleControllerByObjRef(self, controllerRef);
+
+    if (controller == NULL) {
+        printf("WARN: Schedule controller %s not found\n", controllerRef);
+        return false;
+    }
+
+    ScheduleController_setTargetValueFilter(controller, filter);
+
+    if (filter && (filter->minUpdateIntervalInMs > 0) && (self->processOutputs == false)) {
+        self->processOutputs = true;
+        scheduler_startThread(self);
+    }
+
+    return true;
+}
+
+bool
+Scheduler_setTargetValueRamp(Scheduler self, const char* controllerRef, const Scheduler_RampConfig* ramp)
+{
+    ScheduleController controller = Scheduler_getScheduleControllerByObjRef(self, controllerRef);
+
+    if (controller == NULL) {
+        printf("WARN: Schedule controller %s not found\n", controllerRef);
+        return false;
+    }
+
+    ScheduleController_setRamp(controller, ramp);
+
+    if (ramp && (self->processOutputs == false)) {
+        self->processOutputs = true;
+        scheduler_startThread(self);
+    }
+
+    return true;
+}
+
+bool
+Scheduler_setEmergencyOverride(Scheduler self, const char* controllerRef, double value, int durationInMs)
+{
+    ScheduleController controller = Scheduler_getScheduleControllerByObjRef(self, controllerRef);
+
+    if (controller == NULL) {
+        printf("WARN: Schedule controller %s not found\n", controllerRef);
+        return false;
+    }
+
+    if (ScheduleController_setOverride(controller, value, durationInMs) == false)
+        return false;
+
+    /* the expiry is handled by the output processing */
+    if ((durationInMs > 0) && (self->processOutputs == false)) {
+        self->processOutputs = true;
+        scheduler_startThread(self);
+    }
+
+    return true;
+}
+
+bool
+Scheduler_clearEmergencyOverride(Scheduler self, const char* controllerRef)
+{
+    ScheduleController controller = Scheduler_getScheduleControllerByObjRef(self, controllerRef);
+
+    if (controller == NULL) {
+        printf("WARN: Schedule controller %s not found\n", controllerRef);
+        return false;
+    }
+
+    ScheduleController_clearOverride(controller);
+
+    return true;
+}
+
+bool
+Scheduler_getEmergencyOverrideStatus(Scheduler self, const char* controllerRef, Scheduler_OverrideStatus* status)
+{
+    ScheduleController controller = Scheduler_getScheduleControllerByObjRef(self, controllerRef);
+
+    if (controller == NULL) {
+        printf("WARN: Schedule controller %s not found\n", controllerRef);
+        return false;
+    }
+
+    ScheduleController_getOverrideStatus(controller, status);
+
+    return true;
+}
+
+void
+Scheduler_setOverrideLatencyLimit(Scheduler self, int limitInUs)
+{
+    self->overrideLatencyLimitInUs = limitInUs;
+}
+
+/**
+ * @brief Apply the thread configuration to the calling thread when it was changed
+ *
+ * Called by the schedule and scheduler threads at the start of each cycle.
+ *
+ * @param appliedSequence sequence of the configuration last applied by the calling thread
+ */
+void
+scheduler_updateThreadConfig(SchedulerRtConfig* config, uint32_t* sequence, uint32_t* appliedSequence)
+{
+    if ((sequence == NULL) || (__atomic_load_n(sequence, __ATOMIC_ACQUIRE) == *appliedSequence))
+        return;
+
+    SchedulerRtConfig copy;
+    uint32_t seq;
+
+    do {
+        seq = scheduler_beginSequenceRead(sequence);
+
+        memcpy(&copy, config, sizeof(SchedulerRtConfig));
+
+    } while (scheduler_retrySequenceRead(sequence, seq));
+
+    *appliedSequence = seq;
+
+    SchedulerRt_applyToCurrentThread(&copy);
+}
+
+bool
+Scheduler_setThreadConfig(Scheduler self, const SchedulerRtConfig* config)
+{
+    if ((config->policy != SCHEDULER_RT_POLICY_DEFAULT) && ((config->priority < 1) || (config->priority > 99))) {
+        printf("WARN: Invalid real-time priority %i\n", config->priority);
+        return false;
+    }
+
+    bool success = SchedulerRt_lockMemory(config);
+
+    /* the threads apply the new configuration with their next cycle */
+    scheduler_beginSequenceWrite(&(self->threadConfigSequence));
+
+    memcpy(&(self->threadConfig), config, sizeof(SchedulerRtConfig));
+
+    scheduler_endSequenceWrite(&(self->threadConfigSequence));
+
+    return success;
+}
+
+void
+Scheduler_getThreadLatency(Scheduler self, SchedulerRtLatency* latency)
+{
+    memset(latency, 0, sizeof(SchedulerRtLatency));
+
+    SchedulerRtLatency_merge(latency, &(self->latency));
+
+    LinkedList elem = LinkedList_getNext(self->schedules);
+
+    while (elem) {
+        Schedule schedule = (Schedule)LinkedList_getData(elem);
+
+        SchedulerRtLatency_merge(latency, &(schedule->latency));
+
+        elem = LinkedList_getNext(elem);
+    }
+}
+
+bool
+Scheduler_enableSetpointHistory(Scheduler self, const char* controllerRef, int capacity, const char* fileName)
+{
+    ScheduleController controller = Scheduler_getScheduleControllerByObjRef(self, controllerRef);
+
+    if (controller == NULL) {
+        printf("WARN: Schedule controller %s not found\n", controllerRef);
+        return false;
+    }
+
+    if (controller->history) {
+        printf("WARN: Setpoint history of %s is already enabled\n", controllerRef);
+        return false;
+    }
+
+    SetpointHistory history = SetpointHistory_create(capacity, fileName);
+
+    if (history == NULL) {
+        printf("ERROR: Failed to create setpoint history for %s\n", controllerRef);
+        return false;
+    }
+
+    /* the history is written with locked data model */
+    scheduler_lockDataModel(self->server);
+    controller->history = history;
+    scheduler_unlockDataModel(self->server);
+
+    return true;
+}
+
+int
+Scheduler_querySetpointHistory(Scheduler self, const char* controllerRef, uint64_t startTime, uint64_t endTime,
+    Scheduler_SetpointRecord* records, int maxRecords)
+{
+    ScheduleController controller = Scheduler_getScheduleControllerByObjRef(self, controllerRef);
+
+    if ((controller == NULL) || (controller->history == NULL))
+        return -1;
+
+    return SetpointHistory_query(controller->history, startTime, endTime, records, maxRecords);
+}
+
+int
+Scheduler_exportSetpointHistory(Scheduler self, const char* controllerRef, uint64_t startTime, uint64_t endTime,
+    Scheduler_SetpointRecordHandler handler, void* parameter)
+{
+    ScheduleController controller = Scheduler_getScheduleControllerByObjRef(self, controllerRef);
+
+    if ((controller == NULL) || (controller->history == NULL))
+        return -1;
+
+    return SetpointHistory_export(controller->history, startTime, endTime, handler, parameter);
+}
+
+void
+Scheduler_getMemoryReport(Scheduler self, Scheduler_MemoryReport* report)
+{
+    memset(report, 0, sizeof(Scheduler_MemoryReport));
+
+    if (self->arena) {
+        report->arenaBytes = MemoryArena_getReservedBytes(self->arena);
+        report->arenaUsedBytes = MemoryArena_getUsedBytes(self->arena);
+    }
+
+    report->scheduleBytes = (LinkedList_size(self->schedules) + 1) * sizeof(struct sLinkedList);
+
+    LinkedList elem = LinkedList_getNext(self->schedules);
+
+    while (elem) {
+        Schedule schedule = (Schedule)LinkedList_getData(elem);
+
+        report->scheduleBytes += Schedule_getMemoryUsage(schedule);
+        report->numberOfSchedules++;
+
+        if (schedule->thread)
+            report->numberOfThreads++;
+
+        elem = LinkedList_getNext(elem);
+    }
+
+    report->scheduleControllerBytes = (LinkedList_size(self->scheduleController) + 1) * sizeof(struct sLinkedList);
+
+    elem = LinkedList_getNext(self->scheduleController);
+
+    while (elem) {
+        ScheduleController controller = (ScheduleController)LinkedList_getData(elem);
+
+        report->scheduleControllerBytes += ScheduleController_getMemoryUsage(controller);
+        report->numberOfScheduleControllers++;
+
+        elem = LinkedList_getNext(elem);
+    }
+
+    if (self->thread)
+        report->numberOfThreads++;
+
+    report->totalBytes = sizeof(struct sScheduler) + report->arenaBytes + report->scheduleBytes + report->scheduleControllerBytes;
+}
+
+int
+Scheduler_getScheduleStates(Scheduler self, Scheduler_ScheduleState* states, int maxStates)
+{
+    int count = 0;
+
+    LinkedList elem = LinkedList_getNext(self->schedules);
+
+    while (elem && (count < maxStates)) {
+        Schedule schedule = (Schedule)LinkedList_getData(elem);
+
+        Scheduler_ScheduleState* state = &(states[count++]);
+
+        ModelNode_getObjectReferenceEx((ModelNode*)schedule->scheduleLn, state->scheduleRef, true);
+
+        ScheduleHotState* hot = schedule->hot;
+        ScheduleHotState copy;
+
+        uint32_t seq;
+
+        do {
+            seq = scheduler_beginSequenceRead(&(hot->sequence));
+
+            memcpy(&copy, hot, sizeof(ScheduleHotState));
+
+        } while (scheduler_retrySequenceRead(&(hot->sequence), seq));
+
+        state->state = copy.state;
+        state->prio = copy.prio;
+        state->nextStartTime = copy.nextStartTime;
+
+        if (copy.state == SCHD_STATE_RUNNING) {
+            state->actualStartTime = copy.startTime;
+            state->currentEntry = (copy.currentEntryIdx >= 0) ? (copy.currentEntryIdx + 1) : 0;
+            state->hasValue = copy.hasValue;
+            state->value = copy.hasValue ? copy.value : 0;
+        }
+        else {
+            state->actualStartTime = 0;
+            state->currentEntry = 0;
+            state->hasValue = false;
+            state->value = 0;
+        }
+
+        elem = LinkedList_getNext(elem);
+    }
+
+    return count;
+}
+
+int
+Scheduler_getScheduleControllerStates(Scheduler self, Scheduler_ScheduleControllerState* states, int maxStates)
+{
+    int count = 0;
+
+    LinkedList elem = LinkedList_getNext(self->scheduleController);
+
+    while (elem && (count < maxStates)) {
+        ScheduleController controller = (ScheduleController)LinkedList_getData(elem);
+
+        Scheduler_ScheduleControllerState* state = &(states[count++]);
+
+        ModelNode_getObjectReferenceEx((ModelNode*)controller->controllerLn, state->controllerRef, true);
+
+        uint32_t seq;
+
+        do {
+            seq = scheduler_beginSequenceRead(&(controller->outputSequence));
+
+            memcpy(state->activeScheduleRef, controller->activeScheduleRef, sizeof(state->activeScheduleRef));
+            state->hasValue = controller->hasOutputValue;
+            state->value = controller->outputValue;
+            state->quality = controller->outputQuality;
+            state->timestamp = controller->outputTimestamp;
+            state->overrideActive = controller->overrideActive;
+
+        } while (scheduler_retrySequenceRead(&(controller->outputSequence), seq));
+
+        state->activeScheduleRef[sizeof(state->activeScheduleRef) - 1] = 0;
+
+        elem = LinkedList_getNext(elem);
+    }
+
+    return count;
+}
+
+Schedule
+Scheduler_getScheduleByObjRef(Scheduler self, const char* objRef)
+{
+    Schedule matchingSchedule = NULL;
+
+    if (objRef && objRef[0] != 0) {
+
+        bool withoutIedName = false;
+
+        if (objRef[0] == '@') {
+            withoutIedName = true;
+            objRef = objRef + 1;
+        }
+
+        LinkedList scheduleElem = LinkedList_getNext(self->schedules);
+
+        while (scheduleElem) {
+            Schedule schedule = (Schedule)LinkedList_getData(scheduleElem);
+
+            char scheduleObjRefBuf[130];
+
+            ModelNode_getObjectReferenceEx((ModelNode*)schedule->scheduleLn, scheduleObjRefBuf, withoutIedName);
+
+            if (!strcmp(objRef, scheduleObjRefBuf)) {
+                matchingSchedule = schedule;
+                break;
+            }
+
+            scheduleElem = LinkedList_getNext(scheduleElem);
+        }
+    }
+
+    return matchingSchedule;
+}
+
+ScheduleController
+Scheduler_getScheduleControllerByObjRef(Scheduler self, const char* objRef)
+{
+    ScheduleController matchingController = NULL;
+
+    if (objRef && objRef[0] != 0) {
+
+        bool withoutIedName = false;
+
+        if (objRef[0] == '@') {
+            withoutIedName = true;
+            objRef = objRef + 1;
+        }
+
+        LinkedList schedCtrlElem = LinkedList_getNext(self->scheduleController);
+
+        while (schedCtrlElem) {
+            ScheduleController controller = (ScheduleController)LinkedList_getData(schedCtrlElem);
+
+            char controllerObjRefBuf[130];
+
+            ModelNode_getObjectReferenceEx((ModelNode*)controller->controllerLn, controllerObjRefBuf, withoutIedName);
+
+            if (!strcmp(objRef, controllerObjRefBuf)) {
+                matchingController = controller;
+                break;
+            }
+
+            schedCtrlElem = LinkedList_getNext(schedCtrlElem);
+        }
+    }
+
+    return matchingController;
 }
\ No newline at end of file
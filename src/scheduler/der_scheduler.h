@@ -1,5 +1,7 @@
 #include <libiec61850/iec61850_server.h>
 
+#include "scheduler_rt.h"
+
 typedef struct sScheduler* Scheduler;
 
 /**
@@ -12,6 +14,188 @@ typedef struct sScheduler* Scheduler;
 Scheduler
 Scheduler_create(IedModel* model, IedServer server);
 
+typedef enum {
+    /** each schedule is processed by its own thread */
+    SCHEDULER_MODE_THREAD_PER_SCHEDULE = 0,
+    /** all schedules are processed by one scheduler thread */
+    SCHEDULER_MODE_LOW_FOOTPRINT = 1,
+    /** no threads - the application calls Scheduler_process (e.g. from its event loop) */
+    SCHEDULER_MODE_EXTERNAL = 2
+} Scheduler_Mode;
+
+/**
+ * @brief Create a new Scheduler instance with a specific runtime mode
+ * 
+ * The schedules, schedule controllers and their tables are allocated in one arena owned by the
+ * scheduler that is sized after parsing the model. In SCHEDULER_MODE_LOW_FOOTPRINT the schedules
+ * are passive objects and a single thread processes all schedules. The memory used then scales
+ * linearly with the number of schedules and only one thread stack is required.
+ * 
+ * @param model the data model containing schedule controller and schedule logical nodes
+ * @param server the server to be attached
+ * @param mode the runtime mode
+ * @param cacheFile path of the binding cache file (see Scheduler_createWithBindingCache) or NULL
+ * @return Scheduler 
+ */
+Scheduler
+Scheduler_createEx(IedModel* model, IedServer server, Scheduler_Mode mode, const char* cacheFile);
+
+/**
+ * @brief Get the time when Scheduler_process has to be called next
+ * 
+ * Intended for SCHEDULER_MODE_EXTERNAL. The deadline only changes by calling Scheduler_process or by
+ * external requests (EnaReq/DsaReq, SchdPrio, StrTm, Scheduler_enableSchedule ...). External requests
+ * are signaled with the event file descriptor (see Scheduler_getEventFd).
+ * 
+ * @param self the scheduler instance
+ * @param currentTime the current time in ms since epoch
+ * 
+ * @return the next deadline in ms since epoch (can be in the past) or 0 when there is nothing to do
+ */
+uint64_t
+Scheduler_getNextDeadline(Scheduler self, uint64_t currentTime);
+
+/**
+ * @brief Process all schedules and schedule controllers that are due at currentTime
+ * 
+ * Only allowed in SCHEDULER_MODE_EXTERNAL. Must not be called concurrently with other
+ * Scheduler_process or Scheduler_reconfigure calls.
+ * 
+ * @param self the scheduler instance
+ * @param currentTime the current time in ms since epoch
+ */
+void
+Scheduler_process(Scheduler self, uint64_t currentTime);
+
+/**
+ * @brief Get the event file descriptor (eventfd) that becomes readable when an external request was queued
+ * 
+ * Only available in SCHEDULER_MODE_EXTERNAL. The application has to call Scheduler_process (that
+ * also resets the event) and Scheduler_getNextDeadline when the file descriptor becomes readable.
+ * 
+ * @param self the scheduler instance
+ * 
+ * @return the file descriptor or -1 when not available
+ */
+int
+Scheduler_getEventFd(Scheduler self);
+
+/**
+ * @brief Create a new Scheduler instance using a binding cache file
+ * 
+ * The binding cache contains the positions of all schedule controller and schedule
+ * logical nodes in the data model and the positions of the elements of the schedule
+ * logical nodes (EnaReq, SchdPrio.setVal, SchdIntv.units.SIUnit ...) together with a
+ * hash of the model structure. When the cache file exists and matches the model the
+ * scheduler binds the logical nodes in a single pass and takes the elements from their
+ * positions (only their names are checked) without searching the model. Otherwise the
+ * model is parsed like with Scheduler_create and the cache file is (re)written.
+ * 
+ * @param model the data model containing schedule controller and schedule logical nodes
+ * @param server the server to be attached
+ * @param cacheFile path of the binding cache file
+ * @return Scheduler 
+ */
+Scheduler
+Scheduler_createWithBindingCache(IedModel* model, IedServer server, const char* cacheFile);
+
+/**
+ * @brief Apply a revised data model to a running scheduler
+ * 
+ * The schedule controllers and schedules of the new model are compared with the existing
+ * ones by LD and LN name and by the structure of the LN. Unchanged instances are moved to
+ * the new model: the values of their data attributes (parameters, start times, schedule
+ * references, states) are copied to the new model and running schedules continue without
+ * interruption of the target values. Only new or changed instances are created and only
+ * removed or changed instances are destroyed.
+ * 
+ * The old model has to exist until the function returns. The server of the old model
+ * should be stopped before calling this function because its handlers can refer to
+ * removed instances.
+ * 
+ * @param self the scheduler instance
+ * @param model the revised data model
+ * @param server the server for the revised data model
+ * 
+ * @return true on success, false otherwise
+ */
+bool
+Scheduler_reconfigure(Scheduler self, IedModel* model, IedServer server);
+
+typedef struct {
+    int numberOfSchedules;
+    int numberOfScheduleControllers;
+    int numberOfThreads; /* threads created by the scheduler (each with the default stack size of the platform) */
+    size_t arenaBytes; /* memory reserved by the arena containing schedules, schedule controllers and their tables */
+    size_t arenaUsedBytes; /* part of the arena that is in use */
+    size_t scheduleBytes; /* heap memory used by schedules outside of the arena */
+    size_t scheduleControllerBytes; /* heap memory used by schedule controllers outside of the arena */
+    size_t totalBytes; /* total heap memory used by the scheduler */
+} Scheduler_MemoryReport;
+
+/**
+ * @brief Get the memory used by the scheduler
+ * 
+ * The report only includes memory allocated by the scheduler (not the data model or the server).
+ * 
+ * @param self the scheduler instance
+ * @param report user provided structure to be filled
+ */
+void
+Scheduler_getMemoryReport(Scheduler self, Scheduler_MemoryReport* report);
+
+typedef struct {
+    char scheduleRef[130]; /* object reference of the schedule (LDInst/LN) */
+    int state; /* SchdSt: 1 - not ready, 2 - start time required, 3 - ready, 4 - running */
+    int prio; /* SchdPrio */
+    uint64_t nextStartTime; /* next start time in ms since epoch (0 when not set) */
+    uint64_t actualStartTime; /* start time of the running schedule in ms since epoch (0 when not running) */
+    int currentEntry; /* active entry of the running schedule (starting with 1) or 0 */
+    bool hasValue; /* value contains the value of the active entry */
+    double value;
+} Scheduler_ScheduleState;
+
+typedef struct {
+    char controllerRef[130]; /* object reference of the schedule controller (LDInst/LN) */
+    char activeScheduleRef[130]; /* object reference of the active schedule (empty when no schedule is active) */
+    bool hasValue; /* value contains the current output */
+    double value; /* current output (target value) */
+    Quality quality; /* quality of the output */
+    uint64_t timestamp; /* timestamp of the output in ms since epoch */
+    bool overrideActive; /* the output is set by an emergency override */
+} Scheduler_ScheduleControllerState;
+
+/**
+ * @brief Get the state of all schedules
+ * 
+ * Each element is a consistent copy of the state of one schedule. The function doesn't lock
+ * the data model and doesn't block the schedule execution (the state of a schedule is read
+ * again when it was updated during the copy). It must not be called concurrently with
+ * Scheduler_reconfigure.
+ * 
+ * @param self the scheduler instance
+ * @param states user provided array
+ * @param maxStates number of elements of the array
+ * 
+ * @return number of elements written
+ */
+int
+Scheduler_getScheduleStates(Scheduler self, Scheduler_ScheduleState* states, int maxStates);
+
+/**
+ * @brief Get the active schedule and the output of all schedule controllers
+ * 
+ * Same consistency rules as Scheduler_getScheduleStates.
+ * 
+ * @param self the scheduler instance
+ * @param states user provided array
+ * @param maxStates number of elements of the array
+ * 
+ * @return number of elements written
+ */
+int
+Scheduler_getScheduleControllerStates(Scheduler self, Scheduler_ScheduleControllerState* states, int maxStates);
+
 /**
  * @brief Callback to receive notifications on target value changes
  * 
@@ -34,6 +218,252 @@ typedef void
 void
 Scheduler_setTargetValueHandler(Scheduler self, Scheduler_TargetValueChanged handler, void* parameter);
 
+/**
+ * @brief Publish the outputs of all schedule controllers in a POSIX shared memory region
+ * 
+ * Each schedule controller gets a slot (in the order of the data model) containing the current
+ * target value, quality, timestamp and the active schedule reference. The layout of the region
+ * is defined in der_scheduler_shm.h. Other processes can map the region read-only and read the
+ * slots without system calls. The slots are protected by a sequence lock.
+ * 
+ * Scheduler_reconfigure replaces the region by a new one with the same name and a slot for each
+ * schedule controller of the new model. The magic number of the old region is cleared, so readers
+ * have to map the region again when DerSchedulerShm_isValid fails.
+ * 
+ * @param self the scheduler instance
+ * @param name name of the shared memory object (e.g. "/der_scheduler")
+ * @param notify true to wake up processes waiting (futex) on the update counter of the region after each update
+ * 
+ * @return true on success, false otherwise
+ */
+bool
+Scheduler_enableSharedMemoryPublication(Scheduler self, const char* name, bool notify);
+
+/**
+ * @brief Enable or disable coalesced reporting (disabled by default)
+ * 
+ * When enabled all data model changes of a schedule processing cycle (schedule values, SchdEntr,
+ * SchdSt, start times and the values, target and ActSchdRef of the listening schedule controllers)
+ * are done in a single data model update. The IED server creates a single report per report control
+ * block for them instead of one report for each updated attribute. Quality and timestamp attributes
+ * are not rewritten when the value and the quality didn't change. The target value callback and the
+ * shared memory publication are called after the data model update.
+ * 
+ * @param self the scheduler instance
+ * @param enable true to enable coalesced reporting, false to update each attribute separately
+ */
+void
+Scheduler_enableCoalescedReporting(Scheduler self, bool enable);
+
+typedef struct {
+    double absoluteDeadband; /* MV targets: minimum absolute change of the target value (0 - not used) */
+    double relativeDeadband; /* MV targets: minimum change relative to the last sent value (e.g. 0.02 for 2%, 0 - not used) */
+    bool suppressEqualValues; /* don't send a target value that is equal to the last sent value (used for MV only without deadband) */
+    int minUpdateIntervalInMs; /* minimum time between two target value updates (0 - not used) */
+} Scheduler_TargetValueFilter;
+
+/**
+ * @brief Set a filter for the target value updates of a schedule controller
+ * 
+ * Filtered updates neither change the target in the data model nor call the target value handler or
+ * the shared memory publication. Quality changes are never filtered. An update within the minimum
+ * update interval is held back and sent by the scheduler thread when the interval expired (the
+ * scheduler thread is also started in SCHEDULER_MODE_THREAD_PER_SCHEDULE mode for this purpose).
+ * 
+ * @param self the scheduler instance
+ * @param controllerRef object reference of the schedule controller (@LDInst/LN)
+ * @param filter the filter settings (copied) or NULL to disable filtering
+ * 
+ * @return true on success, false when the schedule controller was not found
+ */
+bool
+Scheduler_setTargetValueFilter(Scheduler self, const char* controllerRef, const Scheduler_TargetValueFilter* filter);
+
+typedef struct {
+    double rampRate; /* maximum change of the target value per second */
+    double softStartRampRate; /* ramp rate when a schedule becomes active while no schedule was active (starting at 0 when the target was invalid, 0 - use rampRate) */
+    int updateIntervalInMs; /* interval of the intermediate target values (resolution 100 ms) */
+} Scheduler_RampConfig;
+
+/**
+ * @brief Limit the rate of change of the target value of a schedule controller (MV targets only)
+ * 
+ * Instead of jumping to a new schedule value at an entry boundary the target value follows the
+ * new value with the configured ramp rate. The intermediate values are written to the target and
+ * passed to the target value handler by the scheduler thread (started also in
+ * SCHEDULER_MODE_THREAD_PER_SCHEDULE mode for this purpose). Invalid target values are not ramped.
+ * 
+ * @param self the scheduler instance
+ * @param controllerRef object reference of the schedule controller (@LDInst/LN)
+ * @param ramp the ramp settings (copied) or NULL to disable the ramp
+ * 
+ * @return true on success, false when the schedule controller was not found
+ */
+bool
+Scheduler_setTargetValueRamp(Scheduler self, const char* controllerRef, const Scheduler_RampConfig* ramp);
+
+typedef struct {
+    bool active; /* an override is active */
+    double value; /* value of the active override */
+    uint64_t expiryTime; /* end of the active override in ms since epoch (0 - until cleared) */
+    int numberOfOverrides; /* number of applied overrides */
+    int latencyViolations; /* number of overrides with an apply latency above the limit */
+    uint32_t lastApplyLatencyInUs; /* apply latency of the last override */
+    uint32_t maxApplyLatencyInUs; /* highest apply latency */
+} Scheduler_OverrideStatus;
+
+/**
+ * @brief Apply an emergency override to the target value of a schedule controller
+ * 
+ * The value is written to the target and passed to the target value handler immediately by the calling
+ * thread - without waiting for the schedule processing and the arbitration of the schedules. Filter and
+ * ramp are bypassed. While the override is active the schedules are still executed and arbitrated
+ * (ActSchdRef, ValMV ...) but don't change the target value. When the override expires (or is cleared)
+ * the target value is set to the value of the active schedule again (the ramp applies to this change).
+ * 
+ * The expiry is only checked by the output processing of the scheduler thread, every 100 ms (in external
+ * mode by Scheduler_process). The target value can return to the schedule up to 100 ms after the end
+ * of the duration.
+ * 
+ * The time from the call until the target is written and the target value handler returned is measured
+ * (see Scheduler_getEmergencyOverrideStatus).
+ * 
+ * @param self the scheduler instance
+ * @param controllerRef object reference of the schedule controller (@LDInst/LN)
+ * @param value the target value (converted to the type of the target)
+ * @param durationInMs duration of the override (resolution 100 ms) or 0 for an override until it is cleared
+ * 
+ * @return true when the override was applied, false otherwise
+ */
+bool
+Scheduler_setEmergencyOverride(Scheduler self, const char* controllerRef, double value, int durationInMs);
+
+/**
+ * @brief End an emergency override before it expires and return to the schedule arbitration
+ * 
+ * @return true on success, false when the schedule controller was not found
+ */
+bool
+Scheduler_clearEmergencyOverride(Scheduler self, const char* controllerRef);
+
+/**
+ * @brief Get the state and the apply latency statistics of emergency overrides of a schedule controller
+ * 
+ * @return true on success, false when the schedule controller was not found
+ */
+bool
+Scheduler_getEmergencyOverrideStatus(Scheduler self, const char* controllerRef, Scheduler_OverrideStatus* status);
+
+/**
+ * @brief Set the maximum apply latency of emergency overrides
+ * 
+ * Overrides that take longer are reported with a warning and counted as latency violation.
+ * 
+ * @param self the scheduler instance
+ * @param limitInUs the latency limit in microseconds (default 100 ms)
+ */
+void
+Scheduler_setOverrideLatencyLimit(Scheduler self, int limitInUs);
+
+/**
+ * @brief Configure the scheduling of the threads that process the schedules
+ * 
+ * Applies to the schedule threads (SCHEDULER_MODE_THREAD_PER_SCHEDULE) and the scheduler thread.
+ * Running threads take over the configuration with their next cycle. Memory locking is applied
+ * immediately (for the whole process). In SCHEDULER_MODE_EXTERNAL the application can use
+ * SchedulerRt_applyToCurrentThread for the thread that calls Scheduler_process.
+ * 
+ * Real-time policies and memory locking require the related privileges (CAP_SYS_NICE,
+ * CAP_IPC_LOCK or suitable RLIMIT_RTPRIO/RLIMIT_MEMLOCK). A rejected setting is logged by each thread.
+ * 
+ * @param self the scheduler instance
+ * @param config the thread configuration
+ * 
+ * @return true on success, false when the configuration is invalid or the memory cannot be locked
+ */
+bool
+Scheduler_setThreadConfig(Scheduler self, const SchedulerRtConfig* config);
+
+/**
+ * @brief Get the wakeup latency of all threads processing schedules since the scheduler was created
+ * 
+ * @param self the scheduler instance
+ * @param latency user provided structure for the combined latency of all threads
+ */
+void
+Scheduler_getThreadLatency(Scheduler self, SchedulerRtLatency* latency);
+
+/** the target value was not set by a schedule (no active schedule) */
+#define SCHED_HISTORY_SOURCE_NONE -1
+
+/** the target value was set by an emergency override */
+#define SCHED_HISTORY_SOURCE_OVERRIDE -2
+
+/**
+ * Target value applied by a schedule controller
+ */
+typedef struct {
+    uint64_t timestamp; /* time the value was applied (ms since epoch) */
+    double value; /* target value (0 when the target value was invalidated) */
+    uint16_t quality; /* IEC 61850 quality of the target value */
+    int16_t source; /* index of the source schedule in Scheduler_getScheduleStates or SCHED_HISTORY_SOURCE_XXX */
+    uint32_t reserved;
+} Scheduler_SetpointRecord;
+
+/**
+ * @brief Handler for the records of Scheduler_exportSetpointHistory
+ * 
+ * @return true to continue the export, false to stop
+ */
+typedef bool (*Scheduler_SetpointRecordHandler)(void* parameter, const Scheduler_SetpointRecord* record);
+
+/**
+ * @brief Record the target values applied by a schedule controller
+ * 
+ * The records are kept in a ring with fixed capacity (the oldest records are overwritten). With a
+ * file name the ring is a memory-mapped file: the history survives restarts of the application (the
+ * file is continued when it has the same capacity) and can be used as evidence for settlement.
+ * Appending a record requires no system call and no additional lock.
+ * 
+ * @param self the scheduler instance
+ * @param controllerRef object reference of the schedule controller (LDInst/LN)
+ * @param capacity maximum number of records
+ * @param fileName file for the ring or NULL to keep the ring in memory
+ * 
+ * @return true on success, false when the history is already enabled or cannot be created
+ */
+bool
+Scheduler_enableSetpointHistory(Scheduler self, const char* controllerRef, int capacity, const char* fileName);
+
+/**
+ * @brief Get the target values that were applied during a time range (binary search, O(log n))
+ * 
+ * The first record is the target value that was active at startTime (when it is still in the history).
+ * 
+ * @param self the scheduler instance
+ * @param controllerRef object reference of the schedule controller (LDInst/LN)
+ * @param startTime start of the range (ms since epoch)
+ * @param endTime end of the range (ms since epoch, exclusive)
+ * @param records user provided buffer for the records in ascending time order
+ * @param maxRecords size of the buffer
+ * 
+ * @return the number of records, or -1 when the history is not enabled
+ */
+int
+Scheduler_querySetpointHistory(Scheduler self, const char* controllerRef, uint64_t startTime, uint64_t endTime,
+    Scheduler_SetpointRecord* records, int maxRecords);
+
+/**
+ * @brief Pass the records of a time range to a handler (like Scheduler_querySetpointHistory without buffer limit)
+ * 
+ * The export doesn't block the threads that apply new target values.
+ * 
+ * @return the number of exported records, or -1 when the history is not enabled
+ */
+int
+Scheduler_exportSetpointHistory(Scheduler self, const char* controllerRef, uint64_t startTime, uint64_t endTime,
+    Scheduler_SetpointRecordHandler handler, void* parameter);
+
 /**
  * @brief Get the current target value of a schedule controller
  * 
@@ -61,15 +491,127 @@ Scheduler_enableScheduleControl(Scheduler self, const char* scheduleRef, bool en
 /**
  * @brief Enable or disable a schedule
  * 
+ * Like the EnaReq/DsaReq commands of clients the request is executed by the thread processing the
+ * schedule. The function waits until the request is executed (at most one processing cycle). In external
+ * mode it has to be called by the thread calling Scheduler_process and is executed directly.
+ * 
+ * When called by a thread of the scheduler (e.g. in a target value handler) or with locked data model
+ * the request is only queued and the resulting state is available with SchdSt or Scheduler_getScheduleStates.
+ * 
  * @param self the scheduler instance
  * @param scheduleRef the object reference of the Schedule (@LDInst/LN)
  * @param enable true to enable the schedule, or false to disable the schedule
  * 
- * @return true on success, false otherwise
+ * @return true when the schedule was enabled/disabled (or the request was queued), false when the schedule
+ *         is not valid, not found, or the request cannot be queued
  */
 bool
 Scheduler_enableSchedule(Scheduler self, const char* scheduleRef, bool enable);
 
+typedef enum {
+    SCHED_CHANGE_ENABLE = 1,
+    SCHED_CHANGE_DISABLE,
+    SCHED_CHANGE_SET_PRIO
+} Scheduler_ScheduleChangeType;
+
+typedef struct {
+    const char* scheduleRef; /* object reference of the Schedule (@LDInst/LN) */
+    Scheduler_ScheduleChangeType type;
+    int prio; /* new SchdPrio.setVal (SCHED_CHANGE_SET_PRIO only) */
+} Scheduler_ScheduleChange;
+
+/**
+ * @brief Enable, disable or reprioritize a group of schedules as one transaction
+ * 
+ * The changes are executed asynchronously by the threads processing the schedules (like
+ * Scheduler_enableSchedule). The schedule controllers of the affected schedules don't select a new
+ * active schedule until all changes are executed. Then each affected controller selects the active
+ * schedule once and updates its target value at most once (no intermediate target values).
+ * 
+ * All changes are checked before the first one is queued. No change is applied when a schedule
+ * reference is unknown, a schedule to enable doesn't pass the enable checks (NumEntr, SchdIntv,
+ * start times or trigger) or a command queue has no space for a change.
+ * 
+ * The enable checks are repeated when an enable is executed. A schedule parameter changed after the
+ * call can still prevent the enable (reported with SchdEnaErr) - the other changes are applied then.
+ * 
+ * @param self the scheduler instance
+ * @param changes the changes to apply
+ * @param numberOfChanges number of elements in changes
+ * 
+ * @return true when all changes were queued, false when no change is applied
+ */
+bool
+Scheduler_applyScheduleChanges(Scheduler self, const Scheduler_ScheduleChange* changes, int numberOfChanges);
+
+/**
+ * @brief Enable or disable linear interpolation between the entries of a schedule (MV schedules only)
+ * 
+ * In interpolation mode the schedule value changes linearly from the value of an entry to the value of
+ * the next entry instead of stepwise at the entry boundaries. The last entry keeps its value. The
+ * interpolated value is written to ValMV and passed to the schedule controllers (and the target value
+ * handler) every outputIntervalInMs. The setting takes effect with the next start of the schedule.
+ * 
+ * @param self the scheduler instance
+ * @param scheduleRef the object reference of the Schedule (@LDInst/LN)
+ * @param enable true to enable interpolation, false for the step function
+ * @param outputIntervalInMs interval of the interpolated values (resolution 100 ms)
+ * 
+ * @return true on success, false otherwise
+ */
+bool
+Scheduler_setScheduleInterpolation(Scheduler self, const char* scheduleRef, bool enable, int outputIntervalInMs);
+
+/**
+ * @brief Set individual durations for the entries of a schedule
+ * 
+ * Allows schedules that mix long and short entries (e.g. a two hour block followed by one minute steps).
+ * Entry n (n > numberOfDurations) keeps the duration defined by SchdIntv. The current entry is found
+ * with a cached cursor and a binary search, so the cost per cycle doesn't depend on the number of entries.
+ * The setting takes effect with the next start of the schedule.
+ * 
+ * @param self the scheduler instance
+ * @param scheduleRef the object reference of the Schedule (@LDInst/LN)
+ * @param durationsInMs duration of each entry in ms (index 0 -> entry 1) or NULL to use SchdIntv for all entries
+ * @param numberOfDurations number of elements in durationsInMs
+ * 
+ * @return true on success, false otherwise
+ */
+bool
+Scheduler_setScheduleEntryDurations(Scheduler self, const char* scheduleRef, const int* durationsInMs, int numberOfDurations);
+
+/**
+ * @brief Upload the values of a schedule in run-length compressed form (see schedule_rle.h)
+ * 
+ * Writes the ValXXX entries and NumEntr in a single data model update. The values are decoded on the fly,
+ * a day with 1440 entries and a few value changes needs only some hundred bytes. Nothing is written when
+ * the data is invalid or has more values than the schedule has entries.
+ * 
+ * @param self the scheduler instance
+ * @param scheduleRef the object reference of the Schedule (@LDInst/LN)
+ * @param data the compressed values (e.g. created with ScheduleRle_encode)
+ * @param size size of data in bytes
+ * 
+ * @return true on success, false otherwise
+ */
+bool
+Scheduler_uploadCompressedSchedule(Scheduler self, const char* scheduleRef, const uint8_t* data, int size);
+
+/**
+ * @brief Export the values of the first NumEntr entries of a schedule in run-length compressed form
+ * 
+ * Can be used for persistence and snapshots. The result can be restored with Scheduler_uploadCompressedSchedule.
+ * 
+ * @param self the scheduler instance
+ * @param scheduleRef the object reference of the Schedule (@LDInst/LN)
+ * @param buffer buffer for the compressed values (SCHEDULE_RLE_MAX_ENCODED_SIZE(NumEntr) is always sufficient)
+ * @param bufferSize size of the buffer in bytes
+ * 
+ * @return the size of the compressed values or -1 on error
+ */
+int
+Scheduler_exportCompressedSchedule(Scheduler self, const char* scheduleRef, uint8_t* buffer, int bufferSize);
+
 typedef enum {
     SCHED_PARAM_SCHD_PRIO = 1,
     SCHED_PARAM_STR_TM,
@@ -1,11 +1,36 @@
 #include "der_scheduler.h"
+#include "schedule_core.h"
 
 #include <libiec61850/hal_thread.h>
 
+#ifndef CONFIG_SCHEDULE_MAX_LISTENING_CONTROLLERS
+#define CONFIG_SCHEDULE_MAX_LISTENING_CONTROLLERS 4
+#endif
+
+/* number of external commands that can be queued for a schedule (has to be a power of two) */
+#ifndef CONFIG_SCHEDULE_COMMAND_QUEUE_SIZE
+#define CONFIG_SCHEDULE_COMMAND_QUEUE_SIZE 16
+#endif
+
+/* default limit for the apply latency of an emergency override (see Scheduler_setOverrideLatencyLimit) */
+#ifndef CONFIG_SCHEDULER_OVERRIDE_LATENCY_LIMIT_US
+#define CONFIG_SCHEDULER_OVERRIDE_LATENCY_LIMIT_US 100000
+#endif
+
 typedef struct sSchedule* Schedule;
 
 typedef struct sScheduleController* ScheduleController;
 
+typedef struct sShmPublisher* ShmPublisher;
+
+typedef struct sBindingCache* BindingCache;
+
+typedef struct sMemoryArena* MemoryArena;
+
+typedef struct sSchedulerBatch* SchedulerBatch;
+
+typedef struct sSetpointHistory* SetpointHistory;
+
 typedef enum {
     SCHD_STATE_INVALID = 0,
     SCHD_STATE_NOT_READY = 1,
@@ -32,6 +57,150 @@ typedef enum {
     SCHD_TYPE_MV = 4
 } ScheduleTargetType;
 
+typedef enum {
+    SCHD_DIRTY_NUM_ENTR = 1,
+    SCHD_DIRTY_SCHD_INTV = 2,
+    SCHD_DIRTY_ENTRY_DURATIONS = 4
+} ScheduleDirtyParameter;
+
+typedef struct {
+    DataObject* strTm;
+    DataAttribute* setTm; /* NULL when the StrTm object has no setTm attribute */
+    DataAttribute* setCal; /* NULL when the StrTm object has no setCal attribute */
+    uint64_t value; /* current value of setTm in ms since epoch (0 = not set) */
+    uint64_t modelValue; /* value of setTm in the data model at the last synchronization */
+} ScheduleStartTime;
+
+typedef enum {
+    BINDING_TYPE_SCHEDULE_CONTROLLER = 1,
+    BINDING_TYPE_SCHEDULE = 2
+} BindingType;
+
+/* data model elements of a schedule LN that are resolved when the schedule is bound */
+typedef enum {
+    SCHD_BINDING_SCHD_ST = 0,
+    SCHD_BINDING_NXT_STR_TM,
+    SCHD_BINDING_SCHD_PRIO,
+    SCHD_BINDING_SCHD_PRIO_SET_VAL,
+    SCHD_BINDING_ENA_REQ,
+    SCHD_BINDING_DSA_REQ,
+    SCHD_BINDING_VAL, /* ValMV, ValINS, ValSPS or ValENS depending on the target type */
+    SCHD_BINDING_EV_TRG,
+    SCHD_BINDING_IN_SYN_SET_SRC_REF,
+    SCHD_BINDING_NUM_ENTR_SET_VAL,
+    SCHD_BINDING_SCHD_INTV_SET_VAL,
+    SCHD_BINDING_SCHD_INTV_UNIT,
+    SCHD_BINDING_SCHD_INTV_MULTIPLIER,
+    SCHD_BINDING_SCHD_REUSE_SET_VAL,
+    SCHD_BINDING_NUMBER_OF_NODES
+} ScheduleBindingNode;
+
+typedef struct {
+    ScheduleTargetType targetType;
+    ModelNode* nodes[SCHD_BINDING_NUMBER_OF_NODES]; /* NULL when the element is not present */
+} ScheduleBinding;
+
+#define BINDING_CACHE_MAX_DEPTH 3
+
+/* position of an element below a logical node as child indexes (e.g. SchdIntv.units.SIUnit) */
+typedef struct {
+    uint8_t depth; /* 0 = element not present */
+    uint8_t reserved;
+    uint16_t childIdx[BINDING_CACHE_MAX_DEPTH];
+} BindingCachePosition;
+
+typedef struct {
+    uint16_t ldIdx; /* index of the logical device in the model */
+    uint16_t lnIdx; /* index of the logical node in the logical device */
+    uint8_t type; /* BindingType */
+    uint8_t targetType; /* ScheduleTargetType (only schedules) */
+    uint8_t hasPositions; /* 0 = the elements of the schedule LN are resolved by name */
+    uint8_t reserved;
+    BindingCachePosition positions[SCHD_BINDING_NUMBER_OF_NODES]; /* only schedules */
+} BindingCacheEntry;
+
+struct sBindingCache {
+    uint64_t modelHash; /* hash of the model the entries were created for */
+    int numberOfEntries;
+    int maxEntries;
+    BindingCacheEntry* entries; /* in model order */
+};
+
+typedef enum {
+    SCHD_CMD_ENABLE = 1, /* EnaReq or Scheduler_enableSchedule */
+    SCHD_CMD_DISABLE, /* DsaReq or Scheduler_enableSchedule */
+    SCHD_CMD_SET_PRIO, /* SchdPrio.setVal */
+    SCHD_CMD_SET_START_TIME, /* StrTmXX.setTm */
+    SCHD_CMD_CONNECT_CONTROLLER /* SchdXX.setSrcRef of a schedule controller */
+} SchedulerCommandType;
+
+/**
+ * Result of a command that the caller waits for (see Schedule_enableSchedule)
+ */
+typedef struct {
+    Semaphore done; /* posted by the thread that executed the command */
+    bool result;
+} SchedulerCommandCompletion;
+
+/**
+ * External command that is executed by the thread processing the schedule (the only writer
+ * of the schedule state).
+ */
+typedef struct {
+    SchedulerCommandType type;
+    int32_t intValue; /* SCHD_CMD_SET_PRIO */
+    uint64_t timeValue; /* SCHD_CMD_SET_START_TIME */
+    DataAttribute* attribute; /* SCHD_CMD_SET_START_TIME: StrTmXX.setTm */
+    ScheduleController controller; /* SCHD_CMD_CONNECT_CONTROLLER */
+    Schedule oldSchedule; /* SCHD_CMD_CONNECT_CONTROLLER: schedule previously referenced by SchdXX (or NULL) */
+    SchedulerBatch batch; /* group of commands the command belongs to (see Scheduler_applyScheduleChanges) or NULL */
+    SchedulerCommandCompletion* completion; /* SCHD_CMD_ENABLE/SCHD_CMD_DISABLE: result for a waiting caller or NULL */
+} SchedulerCommand;
+
+/**
+ * Group of commands for different schedules. The arbitration of the affected schedule controllers
+ * is suspended until the last command is executed.
+ */
+struct sSchedulerBatch {
+    int pendingCommands; /* decremented by the threads executing the commands */
+    int numberOfControllers;
+    ScheduleController* controllers; /* affected schedule controllers (allocated with the batch) */
+};
+
+typedef struct {
+    uint32_t sequence;
+    SchedulerCommand command;
+} CommandQueueCell;
+
+typedef struct {
+    CommandQueueCell cells[CONFIG_SCHEDULE_COMMAND_QUEUE_SIZE];
+    uint32_t enqueuePos;
+    uint32_t dequeuePos; /* only accessed by the consumer */
+    int32_t freeCells; /* cells that are neither filled nor reserved by a producer */
+} CommandQueue;
+
+/**
+ * Runtime state of a schedule that is checked in every cycle. The scheduler keeps the
+ * hot states of all schedules in one array, separate from the configuration data.
+ */
+typedef struct {
+    Schedule schedule; /* owner (NULL when the element is unused) */
+    ScheduleState state; /* value of SchdSt.stVal */
+    int prio; /* value of SchdPrio.setVal */
+    int currentEntryIdx;
+    int entryDurationInMs; /* duration of schedule entry in ms */
+    int numberOfScheduleEntries; /* number of valid schedule entries */
+    uint32_t sequence; /* odd while the state is updated (see Scheduler_getScheduleStates) */
+    uint64_t nextStartTime;
+    uint64_t startTime; /* start time of current schedule execution */
+    uint64_t entryStartOffset; /* start of the current entry in ms after startTime */
+    uint64_t entryEndOffset; /* end of the current entry in ms after startTime */
+    double value; /* value of the current entry (or the interpolated value) */
+    bool hasValue;
+    bool hasCommands; /* set by the producers of the command queue */
+    uint64_t nextOutputTime; /* next interpolated output (0 when not interpolating) */
+} ScheduleHotState;
+
 struct sSchedule {
     LogicalNode* scheduleLn;
     ScheduleTargetType targetType;
@@ -43,18 +212,39 @@ struct sSchedule {
 
     DataObject* evTrg;
 
-    uint64_t nextStartTime;
+    ScheduleHotState* hot; /* element of the hot state array of the scheduler or hotStorage */
+    ScheduleHotState hotStorage;
 
-    uint64_t startTime; /* start time of current schedule execution */
-    int entryDurationInMs; /* duration of schedule entry in ms */
-    int numberOfScheduleEntries; /* number of valid schedule entries */
-    int currentEntryIdx;
+    int listIdx; /* position in the schedule list of the scheduler (source index of the setpoint history) */
+
+    MemoryArena arena; /* arena of the instance and its tables or NULL when allocated from heap */
 
     IedServer server;
     IedModel* model;
 
-    Thread thread;
+    Thread thread; /* NULL when the schedule is processed by the scheduler thread */
     bool alive;
+    bool hasOwnThread;
+    bool processedByApplication; /* processed by the caller of Scheduler_process (external mode) */
+
+    bool coalescedReporting; /* process a cycle in a single data model update (see Scheduler_enableCoalescedReporting) */
+
+    /* linear interpolation mode - only accessed by the processing thread (except configuration) */
+    bool interpolation;
+    int interpolationIntervalInMs;
+    bool interpolationValid; /* the table was calculated for the running schedule */
+    double* interpolationTable; /* values of all entries followed by the slopes (per ms) of all entries */
+    int interpolationTableSize; /* allocated number of entries */
+    int interpolationEntries; /* number of entries of the running schedule */
+    MmsValue* interpolatedValue;
+
+    /* variable entry durations (see Scheduler_setScheduleEntryDurations) */
+    int* entryDurations; /* configured durations in ms (index 0 -> entry 1) - protected by parameterLock */
+    int numberOfEntryDurations;
+    uint64_t* entryEndOffsets; /* end of each entry in ms after the start of the running schedule (allocated once) */
+    int entryEndOffsetsSize;
+    bool variableEntries; /* the running schedule uses entryEndOffsets */
+    int entryCursor; /* last found entry index (lookup hint) */
 
     bool allowRemoteControl; /* allow remote control of EnaReq/DsaReq */
     bool allowWriteToSchdPrio;
@@ -64,12 +254,54 @@ struct sSchedule {
     bool isTimeTriggerd; /* when the schedule has at least one StrTm object */
     bool isPeriodic;     /* when the schedule has at least one StrTm object with a setCal attribute */
 
-    LinkedList knownScheduleControllers; /* list of ScheduleControllers to inform on state/value change events */
+    ScheduleController listeningControllers[CONFIG_SCHEDULE_MAX_LISTENING_CONTROLLERS]; /* ScheduleControllers to inform on state/value change events */
+    int numberOfListeningControllers;
+
+    ScheduleStartTime* startTimes; /* resolved StrTm objects */
+    int numberOfStartTimes;
+
+    uint64_t* sortedStartTimes; /* values of all set StrTm objects in ascending order */
+    int numberOfSortedStartTimes;
+    int nextStartTimeIdx; /* first element of sortedStartTimes that was in the future at the last lookup */
+
+    DataAttribute* numEntr; /* NumEntr.setVal */
+    DataAttribute* schdIntv; /* SchdIntv.setVal */
+    DataAttribute* schdIntvUnit; /* SchdIntv.units.SIUnit */
+    DataAttribute* schdIntvMultiplier; /* SchdIntv.units.multiplier */
+
+    DataAttribute** scheduleValues; /* resolved value attributes of ValXXX (index 0 -> entry 1) */
+    int numberOfScheduleValues; /* number of consecutive ValXXX entries starting with entry 1 */
+
+    /* validation cache - recalculated only when the parameters in the data model changed since the last validation */
+    int dirtyParameters; /* ScheduleDirtyParameter flags */
+    int numEntrValue;
+    int schdIntvValue;
+    int schdIntvUnitValue;
+    int schdIntvMultiplierValue;
+    uint64_t intervalInMs;
+    uint64_t scheduleDurationInMs;
+    ScheduleEnablingError validationResult;
+
+    Semaphore parameterLock; /* protects start times and validation cache */
+
+    /* thread configuration of the scheduler (see Scheduler_setThreadConfig) */
+    SchedulerRtConfig* threadConfig;
+    uint32_t* threadConfigSequence;
+    uint32_t appliedThreadConfig;
+    SchedulerRtLatency latency; /* wakeup latency of the schedule thread */
+
+    CommandQueue commands; /* external commands executed by Schedule_process */
+    int eventFd; /* signaled when a command was queued (SCHEDULER_MODE_EXTERNAL) or -1 */
 };
 
 struct sScheduleController {
+    /* arbitration state - protected by the data model lock (the schedules report from their own threads) */
     Schedule activeSchedule;
-    LinkedList schedules;
+    Schedule* schedules; /* schedules referenced by SchdXX.setSrcRef */
+    int numberOfSchedules;
+    int maxSchedules; /* number of SchdXX objects */
+
+    MemoryArena arena; /* arena of the instance or NULL when allocated from heap */
 
     LogicalNode* controllerLn;
     IedServer server;
@@ -77,6 +309,65 @@ struct sScheduleController {
     Scheduler scheduler;
 
     ModelNode* controlEntity; /* target object to be controlled by the schedule controller */
+
+    int shmSlot; /* slot in the shared memory region or -1 when not published */
+
+    /* output state - protected by outputSequence (see Scheduler_getScheduleControllerStates) */
+    uint32_t outputSequence;
+    char activeScheduleRef[130]; /* object reference of the active schedule (empty when no schedule is active) */
+    bool hasOutputValue;
+    double outputValue;
+    Quality outputQuality;
+    uint64_t outputTimestamp;
+
+    /* target value filter - protected by outputSequence */
+    bool hasFilter;
+    Scheduler_TargetValueFilter filter;
+    bool hasLastOutput; /* last sent output (lastOutputXXX) is valid */
+    bool hasLastOutputValue;
+    double lastOutputValue;
+    Quality lastOutputQuality;
+    uint64_t lastOutputTime;
+    bool hasHeldOutput; /* an update was held back by the minimum update interval */
+    ScheduleTargetType heldTargetType;
+    MmsValue* heldValue; /* copy of the held back value (heap allocated) */
+    MmsValue* scheduleValue; /* copy of the current value of the active schedule (heap allocated, data model lock) */
+    Quality heldQuality;
+
+    /* ramp rate limitation - protected by outputSequence */
+    bool hasRamp;
+    Scheduler_RampConfig ramp;
+    bool softStartPending; /* a schedule became active while no schedule was active */
+    bool rampActive;
+    double rampCurrentValue;
+    double rampTargetValue;
+    double rampRatePerMs;
+    uint64_t lastRampTime;
+    MmsValue* rampValue; /* intermediate value written to the target (heap allocated) */
+
+    /* emergency override - protected by outputSequence (overrideActive is also checked with locked data model) */
+    bool overrideActive;
+    double overrideValue;
+    uint64_t overrideExpiryTime; /* 0 - no expiry */
+    MmsValue* overrideMmsValue; /* value written to the target (heap allocated) */
+    int numberOfOverrides;
+    int overrideLatencyViolations;
+    uint32_t lastOverrideLatencyInUs;
+    uint32_t maxOverrideLatencyInUs;
+
+    /* applied target values (see Scheduler_enableSetpointHistory) - written with locked data model */
+    SetpointHistory history;
+
+    /* group operations (see Scheduler_applyScheduleChanges) */
+    int arbitrationSuspended; /* number of unfinished batches affecting the controller */
+    bool arbitrationPending; /* a schedule state or priority changed while the arbitration was suspended */
+
+    /* target value notification deferred until the data model is unlocked - protected by the data model lock */
+    bool hasPendingNotification;
+    DataAttribute* pendingTargetAttr;
+    MmsValue* pendingValue; /* copy of the written value (heap allocated, NULL when invalid) */
+    Quality pendingQuality;
+    uint64_t pendingTimestamp;
 };
 
 struct sScheduler
@@ -88,17 +379,226 @@ struct sScheduler
 
     Scheduler_TargetValueChanged targetValueHandler;
     void* targetValueHandlerParameter;
+
+    ShmPublisher shmPublisher;
+
+    Scheduler_Mode mode;
+
+    MemoryArena arena; /* schedules, schedule controllers and their tables */
+
+    ScheduleHotState* hotStates; /* hot state of all schedules in model order */
+    int numberOfHotStates;
+    int maxHotStates;
+
+    Thread thread; /* processes all schedules (low footprint mode) */
+    bool threadRunning;
+
+    bool coalescedReporting;
+
+    bool processOutputs; /* scheduler thread has to process the controller outputs (also in thread per schedule mode) */
+
+    int eventFd; /* signaled when an external command was queued (SCHEDULER_MODE_EXTERNAL) or -1 */
+
+    int overrideLatencyLimitInUs; /* apply latency of emergency overrides that is reported as violation */
+
+    SchedulerRtConfig threadConfig; /* protected by threadConfigSequence (see Scheduler_setThreadConfig) */
+    uint32_t threadConfigSequence; /* 0 - not configured */
+    uint32_t appliedThreadConfig; /* sequence of the configuration applied by the scheduler thread */
+    SchedulerRtLatency latency; /* wakeup latency of the scheduler thread */
 };
 
+/**
+ * Sequence lock helpers. Writers can run in different threads (schedule threads and server
+ * threads) and acquire the odd sequence number. Readers never block writers, they retry
+ * when the sequence number changed while reading.
+ */
+static inline void
+scheduler_beginSequenceWrite(uint32_t* sequence)
+{
+    uint32_t seq = __atomic_load_n(sequence, __ATOMIC_RELAXED);
+
+    while ((seq & 1) || (__atomic_compare_exchange_n(sequence, &seq, seq + 1, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED) == false)) {
+        seq = __atomic_load_n(sequence, __ATOMIC_RELAXED) & ~1U;
+    }
+
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+static inline void
+scheduler_endSequenceWrite(uint32_t* sequence)
+{
+    __atomic_add_fetch(sequence, 1, __ATOMIC_RELEASE);
+}
+
+static inline uint32_t
+scheduler_beginSequenceRead(uint32_t* sequence)
+{
+    uint32_t seq;
+
+    while ((seq = __atomic_load_n(sequence, __ATOMIC_ACQUIRE)) & 1);
+
+    return seq;
+}
+
+static inline bool
+scheduler_retrySequenceRead(uint32_t* sequence, uint32_t startSequence)
+{
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+    return (__atomic_load_n(sequence, __ATOMIC_RELAXED) != startSequence);
+}
+
+bool
+scheduler_getNumericValue(MmsValue* value, double* numericValue);
+
+void
+scheduler_lockDataModel(IedServer server);
+
+void
+scheduler_unlockDataModel(IedServer server);
+
+bool
+scheduler_isDataModelLocked(void);
+
+void
+scheduler_setSharedProcessingThread(void);
+
+bool
+scheduler_isSharedProcessingThread(void);
+
+bool
+scheduler_isValueUnchanged(DataAttribute* valueAttr, MmsValue* value, DataAttribute* qAttr, Quality quality);
+
 void
 scheduler_targetValueChanged(Scheduler self, DataAttribute* targetAttr, MmsValue* value, Quality quality, uint64_t timestampMs);
 
+void
+scheduler_publishTargetValue(Scheduler self, ScheduleController controller, DataAttribute* targetAttr, MmsValue* value, Quality quality, uint64_t timestampMs);
+
+ShmPublisher
+ShmPublisher_create(const char* name, int numberOfSlots, bool notify);
+
+void
+ShmPublisher_initializeSlot(ShmPublisher self, int slotIdx, const char* controllerRef);
+
+void
+ShmPublisher_publish(ShmPublisher self, int slotIdx, const char* targetRef, MmsValue* value, Quality quality,
+    uint64_t timestampMs, const char* activeScheduleRef);
+
+ShmPublisher
+ShmPublisher_recreate(ShmPublisher self, int numberOfSlots);
+
+void
+ShmPublisher_releasePreviousSlots(ShmPublisher self);
+
+void
+ShmPublisher_destroy(ShmPublisher self);
+
+SetpointHistory
+SetpointHistory_create(int capacity, const char* fileName);
+
+void
+SetpointHistory_destroy(SetpointHistory self);
+
+void
+SetpointHistory_append(SetpointHistory self, uint64_t timestamp, double value, Quality quality, int source);
+
+int
+SetpointHistory_query(SetpointHistory self, uint64_t startTime, uint64_t endTime, Scheduler_SetpointRecord* records, int maxRecords);
+
+int
+SetpointHistory_export(SetpointHistory self, uint64_t startTime, uint64_t endTime, Scheduler_SetpointRecordHandler handler, void* parameter);
+
+uint64_t
+BindingCache_calculateModelHash(IedModel* model);
+
+BindingCache
+BindingCache_create(uint64_t modelHash);
+
+uint64_t
+BindingCache_calculateNodeHash(ModelNode* node);
+
+bool
+BindingCache_addEntry(BindingCache self, int ldIdx, int lnIdx, BindingType type);
+
+bool
+BindingCache_addScheduleEntry(BindingCache self, int ldIdx, int lnIdx, LogicalNode* ln, ScheduleBinding* binding);
+
+bool
+BindingCache_resolveScheduleBinding(BindingCacheEntry* entry, LogicalNode* ln, ScheduleBinding* binding);
+
+BindingCache
+BindingCache_load(const char* filename);
+
+bool
+BindingCache_save(BindingCache self, const char* filename);
+
+void
+BindingCache_destroy(BindingCache self);
+
+MemoryArena
+MemoryArena_create(size_t initialSize);
+
+void*
+MemoryArena_alloc(MemoryArena self, size_t size);
+
+size_t
+MemoryArena_getReservedBytes(MemoryArena self);
+
+size_t
+MemoryArena_getUsedBytes(MemoryArena self);
+
+void
+MemoryArena_destroy(MemoryArena self);
+
 ScheduleController
 ScheduleController_create(LogicalNode* fsccLn, Scheduler scheduler);
 
 void
 ScheduleController_destroy(ScheduleController self);
 
+size_t
+ScheduleController_getMemoryUsage(ScheduleController self);
+
+void
+ScheduleController_rebind(ScheduleController self, LogicalNode* fsccLn);
+
+void
+ScheduleController_updateActiveSchedule(ScheduleController self, bool activeScheduleRemoved);
+
+void
+ScheduleController_setTargetValueFilter(ScheduleController self, const Scheduler_TargetValueFilter* filter);
+
+void
+ScheduleController_setRamp(ScheduleController self, const Scheduler_RampConfig* ramp);
+
+void
+ScheduleController_processOutput(ScheduleController self, uint64_t currentTime);
+
+bool
+ScheduleController_setOverride(ScheduleController self, double value, int durationInMs);
+
+void
+ScheduleController_clearOverride(ScheduleController self);
+
+void
+ScheduleController_suspendArbitration(ScheduleController self);
+
+void
+ScheduleController_resumeArbitration(ScheduleController self);
+
+void
+scheduler_finishBatchCommand(SchedulerBatch batch);
+
+void
+scheduler_updateThreadConfig(SchedulerRtConfig* config, uint32_t* sequence, uint32_t* appliedSequence);
+
+void
+Schedule_setThreadConfig(Schedule self, SchedulerRtConfig* config, uint32_t* sequence);
+
+void
+ScheduleController_getOverrideStatus(ScheduleController self, Scheduler_OverrideStatus* status);
+
 void
 scheduleController_schedulePrioUpdated(ScheduleController self, Schedule sched, int newPrio);
 
@@ -108,12 +608,33 @@ scheduleController_scheduleStateUpdated(ScheduleController self, Schedule sched,
 void
 scheduleController_scheduleValueUpdated(ScheduleController self, Schedule sched, MmsValue* val, uint64_t timestamp);
 
+void
+scheduleController_sendPendingNotification(ScheduleController self);
+
 void
 ScheduleController_initialize(ScheduleController self);
 
 Schedule
 Schedule_create(LogicalNode* schedLn, IedServer server, IedModel* model);
 
+Schedule
+Schedule_createEx(LogicalNode* schedLn, IedServer server, IedModel* model, MemoryArena arena, ScheduleHotState* hot, bool ownThread, ScheduleBinding* binding);
+
+void
+Schedule_resolveBinding(LogicalNode* schedLn, ScheduleBinding* binding);
+
+const char*
+Schedule_getBindingNodeName(ScheduleTargetType targetType, ScheduleBindingNode node);
+
+bool
+ScheduleHotState_needsProcessing(ScheduleHotState* hot, uint64_t currentTime);
+
+void
+Schedule_process(Schedule self, uint64_t currentTime);
+
+size_t
+Schedule_getMemoryUsage(Schedule self);
+
 int
 Schedule_getPrio(Schedule self);
 
@@ -121,20 +642,104 @@ bool
 Schedule_isRunning(Schedule self);
 
 MmsValue*
-Schedule_getCurrentValue(Schedule self);
+Schedule_copyCurrentValue(Schedule self, MmsValue** value);
 
 void
 Schedule_destroy(Schedule self);
 
+void
+Schedule_suspend(Schedule self);
+
+void
+Schedule_resume(Schedule self);
+
+bool
+Schedule_rebind(Schedule self, LogicalNode* schedLn, IedServer server, IedModel* model);
+
+void
+scheduler_copyDataModelValues(IedServer server, ModelNode* dst, ModelNode* src);
+
 bool 
 scheduler_checkIfMultiObjInst(const char* name, const char* multiName);
 
 Schedule
 Scheduler_getScheduleByObjRef(Scheduler self, const char* objRef);
 
+ScheduleController
+Scheduler_getScheduleControllerByObjRef(Scheduler self, const char* objRef);
+
 void
 Schedule_setListeningController(Schedule self, ScheduleController controller);
 
+void
+Schedule_clearListeningControllers(Schedule self);
+
+void
+Schedule_setCoalescedReporting(Schedule self, bool enable);
+
+bool
+Schedule_setInterpolation(Schedule self, bool enable, int outputIntervalInMs);
+
+bool
+Schedule_setEntryDurations(Schedule self, const int* durationsInMs, int numberOfDurations);
+
+bool
+Schedule_writeCompressedValues(Schedule self, ScheduleRleReader* reader);
+
+int
+Schedule_readCompressedValues(Schedule self, uint8_t* buffer, int bufferSize);
+
+bool
+Schedule_sendCommand(Schedule self, const SchedulerCommand* command);
+
+bool
+Schedule_reserveCommands(Schedule self, int numberOfCommands);
+
+void
+Schedule_releaseCommandReservation(Schedule self, int numberOfCommands);
+
+void
+Schedule_sendReservedCommand(Schedule self, const SchedulerCommand* command);
+
+bool
+Schedule_checkEnable(Schedule self);
+
+void
+Schedule_setEventFd(Schedule self, int eventFd);
+
+uint64_t
+ScheduleHotState_getNextDeadline(ScheduleHotState* hot, uint64_t currentTime);
+
+uint64_t
+ScheduleController_getNextDeadline(ScheduleController self);
+
+void
+Schedule_executeCommands(Schedule self);
+
+void
+Schedule_cancelCommands(Schedule self);
+
+void
+CommandQueue_initialize(CommandQueue* self);
+
+bool
+CommandQueue_push(CommandQueue* self, const SchedulerCommand* command);
+
+bool
+CommandQueue_reserve(CommandQueue* self, int numberOfCommands);
+
+void
+CommandQueue_releaseReservation(CommandQueue* self, int numberOfCommands);
+
+void
+CommandQueue_pushReserved(CommandQueue* self, const SchedulerCommand* command);
+
+bool
+CommandQueue_pop(CommandQueue* self, SchedulerCommand* command);
+
+void
+scheduleController_connectSchedule(ScheduleController self, Schedule schedule, Schedule oldSchedule);
+
 void
 Schedule_enableScheduleControl(Schedule self, bool enable);
 
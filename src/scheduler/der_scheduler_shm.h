@@ -0,0 +1,114 @@
+#ifndef DER_SCHEDULER_SHM_H_
+#define DER_SCHEDULER_SHM_H_
+
+/*
+ * Layout of the shared memory region used to publish the schedule controller outputs
+ * (see Scheduler_enableSharedMemoryPublication).
+ *
+ * This header has no dependencies on the scheduler or libiec61850 and can be used by
+ * other processes (e.g. protocol adapters) to read the latest setpoints. Reading a slot
+ * requires no system call. Each slot is protected by a sequence lock: the sequence number
+ * is odd while the scheduler updates the slot.
+ *
+ * When the scheduler is reconfigured the region is replaced: the magic number of the old
+ * region is cleared and the update counter is incremented. A reader has to map the region
+ * again when DerSchedulerShm_isValid returns false.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#define DER_SCHEDULER_SHM_MAGIC 0x53524544 /* "DERS" */
+#define DER_SCHEDULER_SHM_VERSION 1
+
+#define DER_SCHEDULER_SHM_REF_SIZE 130
+
+typedef enum {
+    DER_SCHEDULER_SHM_VALUE_NONE = 0,
+    DER_SCHEDULER_SHM_VALUE_FLOAT = 1,
+    DER_SCHEDULER_SHM_VALUE_INT = 2,
+    DER_SCHEDULER_SHM_VALUE_BOOLEAN = 3
+} DerSchedulerShmValueType;
+
+typedef struct {
+    uint32_t sequence; /* sequence lock - odd while the slot is updated */
+    uint32_t valueType; /* DerSchedulerShmValueType */
+    double value; /* current target value */
+    uint32_t quality; /* IEC 61850 quality of the target value */
+    uint32_t updateCount; /* number of updates of this slot */
+    uint64_t timestampMs; /* timestamp of the target value (ms since epoch) */
+    char controllerRef[DER_SCHEDULER_SHM_REF_SIZE]; /* schedule controller (LDInst/LN) - constant */
+    char targetRef[DER_SCHEDULER_SHM_REF_SIZE]; /* object reference of the target value */
+    char activeScheduleRef[DER_SCHEDULER_SHM_REF_SIZE]; /* active schedule or empty string */
+} DerSchedulerShmSlot;
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t numberOfSlots;
+    uint32_t slotSize;
+    uint32_t updateCounter; /* incremented after each slot update (futex word for notifications) */
+    uint32_t reserved;
+    DerSchedulerShmSlot slots[];
+} DerSchedulerShmRegion;
+
+/**
+ * @brief Check if the region has the expected layout
+ */
+static inline bool
+DerSchedulerShm_isValid(const DerSchedulerShmRegion* region)
+{
+    return (region->magic == DER_SCHEDULER_SHM_MAGIC) && (region->version == DER_SCHEDULER_SHM_VERSION) &&
+        (region->slotSize == sizeof(DerSchedulerShmSlot));
+}
+
+/**
+ * @brief Get the current value of the global update counter
+ *
+ * Can be used with futex(FUTEX_WAIT) on &region->updateCounter to wait for updates.
+ */
+static inline uint32_t
+DerSchedulerShm_getUpdateCounter(const DerSchedulerShmRegion* region)
+{
+    return __atomic_load_n(&(region->updateCounter), __ATOMIC_ACQUIRE);
+}
+
+/**
+ * @brief Read a consistent snapshot of a slot
+ *
+ * @param region the mapped shared memory region
+ * @param slotIdx index of the slot (0 .. numberOfSlots - 1)
+ * @param slot user provided buffer for the slot content
+ *
+ * @return true on success, false when the slot index is invalid
+ */
+static inline bool
+DerSchedulerShm_readSlot(const DerSchedulerShmRegion* region, uint32_t slotIdx, DerSchedulerShmSlot* slot)
+{
+    if (slotIdx >= region->numberOfSlots)
+        return false;
+
+    const DerSchedulerShmSlot* shmSlot = &(region->slots[slotIdx]);
+
+    uint32_t seqStart;
+    uint32_t seqEnd;
+
+    do {
+        seqStart = __atomic_load_n(&(shmSlot->sequence), __ATOMIC_ACQUIRE);
+
+        if (seqStart & 1)
+            continue; /* writer active */
+
+        memcpy(slot, shmSlot, sizeof(DerSchedulerShmSlot));
+
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+        seqEnd = __atomic_load_n(&(shmSlot->sequence), __ATOMIC_RELAXED);
+
+    } while ((seqStart & 1) || (seqStart != seqEnd));
+
+    return true;
+}
+
+#endif /* DER_SCHEDULER_SHM_H_ */
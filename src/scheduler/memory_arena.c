@@ -0,0 +1,118 @@
+#include "der_scheduler_internal.h"
+
+#include <string.h>
+
+#define MEMORY_ARENA_ALIGNMENT 8
+
+typedef struct sMemoryArenaBlock MemoryArenaBlock;
+
+struct sMemoryArenaBlock {
+    MemoryArenaBlock* next;
+    size_t size;
+    size_t used;
+    uint64_t data[]; /* uint64_t for alignment */
+};
+
+struct sMemoryArena {
+    MemoryArenaBlock* firstBlock;
+    MemoryArenaBlock* currentBlock;
+    size_t reservedBytes; /* sum of all block sizes */
+    size_t usedBytes;
+};
+
+static MemoryArenaBlock*
+memoryArena_createBlock(size_t size)
+{
+    MemoryArenaBlock* block = (MemoryArenaBlock*)calloc(1, sizeof(MemoryArenaBlock) + size);
+
+    if (block) {
+        block->size = size;
+    }
+
+    return block;
+}
+
+MemoryArena
+MemoryArena_create(size_t initialSize)
+{
+    MemoryArena self = (MemoryArena)calloc(1, sizeof(struct sMemoryArena));
+
+    if (self) {
+        if (initialSize < 1024)
+            initialSize = 1024;
+
+        self->firstBlock = memoryArena_createBlock(initialSize);
+
+        if (self->firstBlock == NULL) {
+            free(self);
+            return NULL;
+        }
+
+        self->currentBlock = self->firstBlock;
+        self->reservedBytes = initialSize;
+    }
+
+    return self;
+}
+
+void*
+MemoryArena_alloc(MemoryArena self, size_t size)
+{
+    size = (size + MEMORY_ARENA_ALIGNMENT - 1) & ~((size_t)MEMORY_ARENA_ALIGNMENT - 1);
+
+    MemoryArenaBlock* block = self->currentBlock;
+
+    if ((block->size - block->used) < size) {
+        /* arena was sized too small (e.g. after a reconfiguration) -> add a new block */
+        size_t blockSize = (size > block->size) ? size : block->size;
+
+        MemoryArenaBlock* newBlock = memoryArena_createBlock(blockSize);
+
+        if (newBlock == NULL)
+            return NULL;
+
+        block->next = newBlock;
+        self->currentBlock = newBlock;
+        self->reservedBytes += blockSize;
+
+        block = newBlock;
+    }
+
+    void* ptr = (uint8_t*)(block->data) + block->used;
+
+    block->used += size;
+    self->usedBytes += size;
+
+    /* block memory is zeroed by calloc and never reused */
+    return ptr;
+}
+
+size_t
+MemoryArena_getReservedBytes(MemoryArena self)
+{
+    return self->reservedBytes;
+}
+
+size_t
+MemoryArena_getUsedBytes(MemoryArena self)
+{
+    return self->usedBytes;
+}
+
+void
+MemoryArena_destroy(MemoryArena self)
+{
+    if (self) {
+        MemoryArenaBlock* block = self->firstBlock;
+
+        while (block) {
+            MemoryArenaBlock* next = block->next;
+
+            free(block);
+
+            block = next;
+        }
+
+        free(self);
+    }
+}
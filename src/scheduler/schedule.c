@@ -1,13 +1,151 @@
 #include <stdio.h>
+#include <string.h>
 #include <math.h>
+#include <unistd.h>
 
 #include "der_scheduler_internal.h"
 
 void
 Schedule_setListeningController(Schedule self, ScheduleController controller)
 {
-    if (LinkedList_contains(self->knownScheduleControllers, controller) == false) {
-        LinkedList_add(self->knownScheduleControllers, controller);
+    int i;
+
+    for (i = 0; i < self->numberOfListeningControllers; i++) {
+        if (self->listeningControllers[i] == controller)
+            return;
+    }
+
+    if (self->numberOfListeningControllers < CONFIG_SCHEDULE_MAX_LISTENING_CONTROLLERS) {
+        self->listeningControllers[self->numberOfListeningControllers++] = controller;
+    }
+    else {
+        printf("ERROR: Schedule %s has too many schedule controllers (max. %i)\n", self->scheduleLn->name, CONFIG_SCHEDULE_MAX_LISTENING_CONTROLLERS);
+    }
+}
+
+void
+Schedule_clearListeningControllers(Schedule self)
+{
+    self->numberOfListeningControllers = 0;
+}
+
+void
+Schedule_setCoalescedReporting(Schedule self, bool enable)
+{
+    self->coalescedReporting = enable;
+}
+
+/**
+ * @brief Enable linear interpolation between the schedule entries (takes effect with the next start of the schedule)
+ */
+bool
+Schedule_setInterpolation(Schedule self, bool enable, int outputIntervalInMs)
+{
+    if (enable) {
+        if (self->targetType != SCHD_TYPE_MV) {
+            printf("WARN: Interpolation is only supported for MV schedules\n");
+            return false;
+        }
+
+        if (self->interpolatedValue == NULL) {
+            self->interpolatedValue = MmsValue_newFloat(0.f);
+
+            if (self->interpolatedValue == NULL)
+                return false;
+        }
+
+        self->interpolationIntervalInMs = (outputIntervalInMs > 0) ? outputIntervalInMs : 1000;
+    }
+
+    self->interpolation = enable;
+
+    return true;
+}
+
+/**
+ * @brief Set individual durations of the schedule entries (takes effect with the next start of the schedule)
+ *
+ * Entries without a configured duration use SchdIntv. NULL restores entries with fixed duration.
+ */
+bool
+Schedule_setEntryDurations(Schedule self, const int* durationsInMs, int numberOfDurations)
+{
+    int* durations = NULL;
+
+    if (durationsInMs && (numberOfDurations > 0)) {
+        int i;
+
+        for (i = 0; i < numberOfDurations; i++) {
+            if (durationsInMs[i] <= 0) {
+                printf("WARN: Invalid duration of schedule entry %i\n", i + 1);
+                return false;
+            }
+        }
+
+        durations = (int*)malloc(numberOfDurations * sizeof(int));
+
+        if (durations == NULL)
+            return false;
+
+        memcpy(durations, durationsInMs, numberOfDurations * sizeof(int));
+
+        /* allocated once with the maximum size because the table is used without lock */
+        if (self->entryEndOffsets == NULL) {
+            int size = (self->numberOfScheduleValues > 0) ? self->numberOfScheduleValues : 1;
+
+            self->entryEndOffsets = (uint64_t*)calloc(size, sizeof(uint64_t));
+
+            if (self->entryEndOffsets == NULL) {
+                free(durations);
+                return false;
+            }
+
+            self->entryEndOffsetsSize = size;
+        }
+    }
+    else {
+        numberOfDurations = 0;
+    }
+
+    Semaphore_wait(self->parameterLock);
+
+    free(self->entryDurations);
+
+    self->entryDurations = durations;
+    self->numberOfEntryDurations = numberOfDurations;
+    self->dirtyParameters |= SCHD_DIRTY_ENTRY_DURATIONS;
+
+    Semaphore_post(self->parameterLock);
+
+    return true;
+}
+
+/* coalesced reporting: keep the data model locked for all updates of a cycle (incl. the listening controllers) */
+static bool
+schedule_beginModelUpdate(Schedule self)
+{
+    bool coalesced = self->coalescedReporting;
+
+    if (coalesced)
+        scheduler_lockDataModel(self->server);
+
+    return coalesced;
+}
+
+static void
+schedule_endModelUpdate(Schedule self, bool coalesced)
+{
+    if (coalesced) {
+        scheduler_unlockDataModel(self->server);
+
+        /* target value callbacks must not be called with locked data model */
+        if (scheduler_isDataModelLocked() == false) {
+            int i;
+
+            for (i = 0; i < self->numberOfListeningControllers; i++) {
+                scheduleController_sendPendingNotification(self->listeningControllers[i]);
+            }
+        }
     }
 }
 
@@ -19,58 +157,179 @@ static bool checkIfStrTm(const char* name)
 static ScheduleState
 schedule_getState(Schedule self)
 {
-    ScheduleState state = SCHD_STATE_INVALID;
+    /* SchdSt is only written by the schedule -> use the cached value */
+    return self->hot->state;
+}
+
+/* writers of the hot state (schedule thread, server threads) - readers use the sequence to get a consistent copy */
+static void
+schedule_beginHotUpdate(Schedule self)
+{
+    scheduler_beginSequenceWrite(&(self->hot->sequence));
+}
+
+static void
+schedule_endHotUpdate(Schedule self)
+{
+    scheduler_endSequenceWrite(&(self->hot->sequence));
+}
 
-    if (self->schdSt) {
-        DataAttribute* schdSt_stVal = (DataAttribute*)ModelNode_getChild((ModelNode*)self->schdSt, "stVal");
+static void
+schedule_setNextStartTime(Schedule self, uint64_t nextStartTime)
+{
+    schedule_beginHotUpdate(self);
+    self->hot->nextStartTime = nextStartTime;
+    schedule_endHotUpdate(self);
+}
 
-        if (schdSt_stVal != NULL) {
-            int stateValue = IedServer_getInt32AttributeValue(self->server, schdSt_stVal);
+/**
+ * @brief Allocate a zeroed table from the arena of the schedule or from heap
+ */
+static void*
+schedule_allocateTable(Schedule self, int numberOfElements, size_t elementSize)
+{
+    if (self->arena)
+        return MemoryArena_alloc(self->arena, numberOfElements * elementSize);
+    else
+        return calloc(numberOfElements, elementSize);
+}
 
-            if ((stateValue >= SCHD_STATE_NOT_READY) && (stateValue <=  SCHD_STATE_RUNNING)) {
-                state = (ScheduleState)stateValue;
-            }
-            else {
-                printf("ERROR: Schedule has invalid state value: %i\n", stateValue);
-            }
+static void
+schedule_releaseTables(Schedule self)
+{
+    /* tables in the arena are released with the arena */
+    if (self->arena == NULL) {
+        free(self->startTimes);
+        free(self->sortedStartTimes);
+        free(self->scheduleValues);
+    }
+
+    self->startTimes = NULL;
+    self->sortedStartTimes = NULL;
+    self->scheduleValues = NULL;
+}
+
+static uint64_t
+getUtcTimeValue(DataAttribute* da)
+{
+    uint64_t timeVal = 0;
+
+    if (da && da->mmsValue) {
+        timeVal = MmsValue_getUtcTimeInMs(da->mmsValue);
+    }
+
+    return timeVal;
+}
+
+/* has to be called with parameterLock */
+static void
+schedule_removeSortedStartTime(Schedule self, uint64_t startTime)
+{
+    int i;
+
+    for (i = 0; i < self->numberOfSortedStartTimes; i++) {
+        if (self->sortedStartTimes[i] == startTime) {
+            memmove(self->sortedStartTimes + i, self->sortedStartTimes + i + 1,
+                (self->numberOfSortedStartTimes - i - 1) * sizeof(uint64_t));
+
+            self->numberOfSortedStartTimes--;
+
+            break;
         }
     }
+}
+
+/* has to be called with parameterLock */
+static void
+schedule_insertSortedStartTime(Schedule self, uint64_t startTime)
+{
+    int i = self->numberOfSortedStartTimes;
 
-    return state;
+    while ((i > 0) && (self->sortedStartTimes[i - 1] > startTime)) {
+        self->sortedStartTimes[i] = self->sortedStartTimes[i - 1];
+        i--;
+    }
+
+    self->sortedStartTimes[i] = startTime;
+
+    self->numberOfSortedStartTimes++;
 }
 
+/* has to be called with parameterLock */
 static void
-checkIfTimeTriggeredAndPeriodic(Schedule self)
+schedule_setStartTimeValue(Schedule self, ScheduleStartTime* strTm, uint64_t value)
+{
+    if (strTm->value != value) {
+        if (strTm->value != 0)
+            schedule_removeSortedStartTime(self, strTm->value);
+
+        if (value != 0)
+            schedule_insertSortedStartTime(self, value);
+
+        strTm->value = value;
+
+        /* restart the lookup from the beginning */
+        self->nextStartTimeIdx = 0;
+    }
+}
+
+/**
+ * Resolve all StrTm objects of the schedule once. The resolved attributes are used by
+ * the start time handling instead of scanning the data objects of the LN.
+ */
+static bool
+schedule_resolveStartTimes(Schedule self)
 {
     self->isTimeTriggerd = false;
     self->isPeriodic = false;
 
-    /* check if schedule has a StrTm object */
+    int numberOfStartTimes = 0;
+
+    DataObject* dObj = (DataObject*)self->scheduleLn->firstChild;
 
-    LinkedList dataObjects = ModelNode_getChildren((ModelNode*)self->scheduleLn);
+    while (dObj) {
+        /* check that data object name is "StrTmXXX" */
+        if (checkIfStrTm(dObj->name)) {
+            numberOfStartTimes++;
+        }
 
-    LinkedList doElem = LinkedList_getNext(dataObjects);
+        dObj = (DataObject*)dObj->sibling;
+    }
 
-    while (doElem) {
-        DataObject* dObj = (DataObject*)LinkedList_getData(doElem);
+    if (numberOfStartTimes > 0) {
+        self->startTimes = (ScheduleStartTime*)schedule_allocateTable(self, numberOfStartTimes, sizeof(ScheduleStartTime));
+        self->sortedStartTimes = (uint64_t*)schedule_allocateTable(self, numberOfStartTimes, sizeof(uint64_t));
 
-        /* check that data object name is "StrTmXXX" */
+        if ((self->startTimes == NULL) || (self->sortedStartTimes == NULL))
+            return false;
+    }
+
+    dObj = (DataObject*)self->scheduleLn->firstChild;
+
+    while (dObj) {
         if (checkIfStrTm(dObj->name)) {
-            self->isTimeTriggerd = true;
+            ScheduleStartTime* strTm = &(self->startTimes[self->numberOfStartTimes++]);
+
+            strTm->strTm = dObj;
+            strTm->setTm = (DataAttribute*)ModelNode_getChild((ModelNode*)dObj, "setTm");
 
-            /* check if "StrTm" has a "setVal" element */
-            ModelNode* setCal = ModelNode_getChild((ModelNode*)dObj, "setCal");
+            /* check if "StrTm" has a "setCal" element */
+            strTm->setCal = (DataAttribute*)ModelNode_getChild((ModelNode*)dObj, "setCal");
+
+            strTm->modelValue = getUtcTimeValue(strTm->setTm);
+
+            schedule_setStartTimeValue(self, strTm, strTm->modelValue);
+
+            self->isTimeTriggerd = true;
 
-            if (setCal) {
+            if (strTm->setCal)
                 self->isPeriodic = true;
-                break;
-            }
         }
 
-        doElem = LinkedList_getNext(doElem);
+        dObj = (DataObject*)dObj->sibling;
     }
 
-    LinkedList_destroyStatic(dataObjects);
+    return true;
 }
 
 static void
@@ -80,7 +339,9 @@ schedule_setState(Schedule self, ScheduleState newState)
     DataAttribute* schdSt_q = (DataAttribute*)ModelNode_getChild((ModelNode*)self->schdSt, "q");
     DataAttribute* schdSt_t = (DataAttribute*)ModelNode_getChild((ModelNode*)self->schdSt, "t");
 
-    IedServer_lockDataModel(self->server);
+    bool coalesced = schedule_beginModelUpdate(self);
+
+    scheduler_lockDataModel(self->server);
 
     if (schdSt_t) {
         Timestamp ts;
@@ -93,26 +354,30 @@ schedule_setState(Schedule self, ScheduleState newState)
     if (schdSt_q) {
         Quality q = 0;
         Quality_setValidity(&q, QUALITY_VALIDITY_GOOD);
-        IedServer_updateQuality(self->server, schdSt_q, q);            
+
+        if ((self->coalescedReporting == false) || (scheduler_isValueUnchanged(NULL, NULL, schdSt_q, q) == false))
+            IedServer_updateQuality(self->server, schdSt_q, q);
     }
 
     if (schdSt_stVal) {
         IedServer_updateInt32AttributeValue(self->server, schdSt_stVal, newState);
     }
 
-    IedServer_unlockDataModel(self->server);
-
-    /* send PRIO_UPDATED event to schedule controller(s) */
+    schedule_beginHotUpdate(self);
+    self->hot->state = newState;
+    schedule_endHotUpdate(self);
 
-    LinkedList controllerElem = LinkedList_getNext(self->knownScheduleControllers);
+    scheduler_unlockDataModel(self->server);
 
-    while (controllerElem) {
-        ScheduleController controller = (ScheduleController)LinkedList_getData(controllerElem);
+    /* send STATE_UPDATED event to schedule controller(s) */
 
-        scheduleController_scheduleStateUpdated(controller, self, newState);
+    int i;
 
-        controllerElem = LinkedList_getNext(controllerElem);
+    for (i = 0; i < self->numberOfListeningControllers; i++) {
+        scheduleController_scheduleStateUpdated(self->listeningControllers[i], self, newState);
     }
+
+    schedule_endModelUpdate(self, coalesced);
 }
 
 static void
@@ -136,7 +401,7 @@ updateIntStatusValue(IedServer server, DataObject* dobj, int32_t value, uint64_t
 
                 DataAttribute* t = (DataAttribute*)ModelNode_getChild((ModelNode*)dobj, "t");
 
-                IedServer_lockDataModel(server);
+                scheduler_lockDataModel(server);
 
                 if (t) {
                     IedServer_updateUTCTimeAttributeValue(server, t, timestamp);
@@ -144,7 +409,7 @@ updateIntStatusValue(IedServer server, DataObject* dobj, int32_t value, uint64_t
 
                 IedServer_updateInt32AttributeValue(server, stVal, value);
 
-                IedServer_unlockDataModel(server);
+                scheduler_unlockDataModel(server);
             }
         }
     }
@@ -176,7 +441,7 @@ updateTimeStatus(Schedule self, uint64_t startTime, const char* objName)
             Timestamp_clearFlags(&ts);
             Timestamp_setTimeInMilliseconds(&ts, startTime);
 
-            IedServer_lockDataModel(self->server);
+            scheduler_lockDataModel(self->server);
 
             IedServer_updateTimestampAttributeValue(self->server, stVal, &ts);
 
@@ -189,7 +454,7 @@ updateTimeStatus(Schedule self, uint64_t startTime, const char* objName)
 
             IedServer_updateTimestampAttributeValue(self->server, t, &ts);
 
-            IedServer_unlockDataModel(self->server);
+            scheduler_unlockDataModel(self->server);
         }
     }
 }
@@ -206,126 +471,87 @@ schedule_updateNxtStrTm(Schedule self, uint64_t nextStartTime)
     updateTimeStatus(self, nextStartTime, "NxtStrTm");
 }
 
-static uint64_t
-schedule_getNextStartTime(Schedule self)
+/**
+ * @brief Take over start times that were changed in the data model without write access handler
+ *
+ * The application can set StrTmXX.setTm locally (IedServer_updateUTCTimeAttributeValue). Only setTm
+ * values that changed in the data model since the last synchronization are taken over, so a start
+ * time set by a command is not replaced by the old model value before the server stored the new one.
+ *
+ * Reads every setTm with locked data model - only called when the schedule is enabled, not by the
+ * start time lookup.
+ */
+static void
+schedule_syncStartTimes(Schedule self)
 {
-    uint64_t nextStartTime = 0;
-
-    uint64_t currentTime = Hal_getTimeInMs();
-
-    LinkedList dataObjects = ModelNode_getChildren((ModelNode*)self->scheduleLn);
+    int i;
 
-    LinkedList doElem = LinkedList_getNext(dataObjects);
+    scheduler_lockDataModel(self->server);
 
-    while (doElem) {
-        DataObject* dObj = (DataObject*)LinkedList_getData(doElem);
+    Semaphore_wait(self->parameterLock);
 
-        // check that data object name is "StrTmXXX"
-        if (checkIfStrTm(dObj->name)) {
-
-            DataAttribute* setTm = (DataAttribute*)ModelNode_getChild((ModelNode*)dObj, "setTm");
+    for (i = 0; i < self->numberOfStartTimes; i++) {
+        ScheduleStartTime* strTm = &(self->startTimes[i]);
 
-            if (setTm->mmsValue) {
-                uint64_t strTmVal = MmsValue_getUtcTimeInMs(setTm->mmsValue);
+        uint64_t modelValue = getUtcTimeValue(strTm->setTm);
 
-                if (strTmVal > currentTime) {
+        if (modelValue != strTm->modelValue) {
+            strTm->modelValue = modelValue;
 
-                    if (nextStartTime == 0) {
-                        nextStartTime = strTmVal;
-                    }
-                    else {
-                        if (strTmVal <= nextStartTime) {
-                            nextStartTime = strTmVal;
-                        }
-                    }
-                }
-            }
+            schedule_setStartTimeValue(self, strTm, modelValue);
         }
-
-        doElem = LinkedList_getNext(doElem);
     }
 
-    LinkedList_destroyStatic(dataObjects);
+    Semaphore_post(self->parameterLock);
 
-    return nextStartTime;
+    scheduler_unlockDataModel(self->server);
 }
 
-/**
- * StrXX value has to be set to "00" when active
- */
-static void
-eraseStartTime(Schedule self, uint64_t startTime)
+static uint64_t
+schedule_getNextStartTime(Schedule self)
 {
-    LinkedList dataObjects = ModelNode_getChildren((ModelNode*)self->scheduleLn);
-
-    LinkedList doElem = LinkedList_getNext(dataObjects);
-
-    while (doElem) {
-        DataObject* dObj = (DataObject*)LinkedList_getData(doElem);
-
-        // check that data object name is "StrTmXXX"
-        if (checkIfStrTm(dObj->name)) {
+    uint64_t nextStartTime = 0;
 
-            DataAttribute* setTm = (DataAttribute*)ModelNode_getChild((ModelNode*)dObj, "setTm");
+    uint64_t currentTime = Hal_getTimeInMs();
 
-            if (setTm->mmsValue) {
-                uint64_t strTmVal = MmsValue_getUtcTimeInMs(setTm->mmsValue);
+    /* only the sorted start time set - locally set start times are taken over when enabling */
+    Semaphore_wait(self->parameterLock);
 
-                if (strTmVal == startTime) {
-                    IedServer_updateUTCTimeAttributeValue(self->server, setTm, 0);
-                }
-            }
-        }
+    nextStartTime = ScheduleCore_findNextStartTime(self->sortedStartTimes, self->numberOfSortedStartTimes, &(self->nextStartTimeIdx), currentTime);
 
-        doElem = LinkedList_getNext(doElem);
-    }
+    Semaphore_post(self->parameterLock);
 
-    LinkedList_destroyStatic(dataObjects);
+    return nextStartTime;
 }
 
-static int
-schedule_getNumberOfScheduleEntries(Schedule self)
+/**
+ * StrXX value has to be set to "00" when active
+ */
+static void
+eraseStartTime(Schedule self, uint64_t startTime)
 {
-    int scheduleEntryCount = 0;
+    int i;
 
-    char* multiObjStr = NULL;
+    /* same lock order as the write access handlers: data model before parameterLock */
+    scheduler_lockDataModel(self->server);
 
-    if (self->targetType == SCHD_TYPE_MV) {
-        multiObjStr = "ValASG";
-    }
-    else if (self->targetType == SCHD_TYPE_ENS) {
-        multiObjStr = "ValENG";
-    }
-    else if (self->targetType == SCHD_TYPE_INS) {
-        multiObjStr = "ValING";
-    }
-    else if (self->targetType == SCHD_TYPE_SPS) {
-        multiObjStr = "ValSPG";
-    }
-    else {
-        return 0;
-    }
+    Semaphore_wait(self->parameterLock);
 
-    LinkedList dataObjects = ModelNode_getChildren((ModelNode*)self->scheduleLn);
+    for (i = 0; i < self->numberOfStartTimes; i++) {
+        ScheduleStartTime* strTm = &(self->startTimes[i]);
 
-    LinkedList doElem = LinkedList_getNext(dataObjects);
+        if ((strTm->setTm) && (strTm->value == startTime)) {
+            IedServer_updateUTCTimeAttributeValue(self->server, strTm->setTm, 0);
 
-    while (doElem) {
-        DataObject* dObj = (DataObject*)LinkedList_getData(doElem);
+            strTm->modelValue = 0;
 
-        if (scheduler_checkIfMultiObjInst(dObj->name, multiObjStr)) {
-           // printf("Found schedule instance %s\n", dObj->name);
-            scheduleEntryCount++;
+            schedule_setStartTimeValue(self, strTm, 0);
         }
-
-        doElem = LinkedList_getNext(doElem);
     }
 
-    LinkedList_destroyStatic(dataObjects);
-
-    printf("INFO: Schedule has %i elements\n", scheduleEntryCount);
+    Semaphore_post(self->parameterLock);
 
-    return scheduleEntryCount;
+    scheduler_unlockDataModel(self->server);
 }
 
 static DataAttribute*
@@ -406,96 +632,138 @@ schedule_getCurrentValueSubAttribute(Schedule self, const char* attrName)
     return NULL;
 }
 
-/**
- * @brief Get the schedule attribute with index idx (e.g. idx=3 => "ValASG1" or "ValASG01", ...)
- * 
- * @param self 
- * @param idx 
- * @return DataAttribute* 
- */
-static DataAttribute*
-schedule_getScheduleValueAttribute(Schedule self, int idx)
+static const char*
+schedule_getValueObjectPrefix(Schedule self)
 {
-    DataAttribute* valueAttr = NULL;
-
-    char attrNameBuf[100];
-
-    char* multiObjStr = NULL;
-
     if (self->targetType == SCHD_TYPE_MV) {
-        multiObjStr = "ValASG";
+        return "ValASG";
     }
     else if (self->targetType == SCHD_TYPE_ENS) {
-        multiObjStr = "ValENG";
+        return "ValENG";
     }
     else if (self->targetType == SCHD_TYPE_INS) {
-        multiObjStr = "ValING";
+        return "ValING";
     }
     else if (self->targetType == SCHD_TYPE_SPS) {
-        multiObjStr = "ValSPG";
+        return "ValSPG";
     }
     else {
         return NULL;
     }
+}
 
-    sprintf(attrNameBuf, "%s%i", multiObjStr, idx);
-    valueAttr = (DataAttribute*)ModelNode_getChild((ModelNode*)self->scheduleLn, attrNameBuf);
+/**
+ * @brief Resolve the value attributes of all consecutive schedule entries (ValXXX objects)
+ * 
+ * The entry index is taken from the instance number of the data object name, so that
+ * "ValASG3", "ValASG03", "ValASG003" and "ValASG0003" are all mapped to entry 3. The LN
+ * is only traversed once.
+ */
+static bool
+schedule_resolveScheduleValues(Schedule self)
+{
+    const char* multiObjStr = schedule_getValueObjectPrefix(self);
 
-    if (valueAttr == NULL) {
-        sprintf(attrNameBuf, "%s%02i", multiObjStr, idx);
-        valueAttr = (DataAttribute*)ModelNode_getChild((ModelNode*)self->scheduleLn, attrNameBuf);
-    }
+    if (multiObjStr == NULL)
+        return true;
 
-    if (valueAttr == NULL) {
-        sprintf(attrNameBuf, "%s%03i", multiObjStr, idx);
-        valueAttr = (DataAttribute*)ModelNode_getChild((ModelNode*)self->scheduleLn, attrNameBuf);
-    }
+    int prefixLen = strlen(multiObjStr);
 
-    if (valueAttr == NULL) {
-        sprintf(attrNameBuf, "%s%04i", multiObjStr, idx);
-        valueAttr = (DataAttribute*)ModelNode_getChild((ModelNode*)self->scheduleLn, attrNameBuf);
-    };
+    int numberOfValueObjects = 0;
 
-    if (valueAttr) {
-        
-        if (self->targetType == SCHD_TYPE_MV) {
-            valueAttr = (DataAttribute*)ModelNode_getChild((ModelNode*)valueAttr, "setMag.f");
+    DataObject* dObj = (DataObject*)self->scheduleLn->firstChild;
 
-            if (valueAttr == NULL)
-                valueAttr = (DataAttribute*)ModelNode_getChild((ModelNode*)valueAttr, "setMag.i");
-        }
-        else {
-            valueAttr = (DataAttribute*)ModelNode_getChild((ModelNode*)valueAttr, "setVal");
+    while (dObj) {
+        if (scheduler_checkIfMultiObjInst(dObj->name, multiObjStr)) {
+            numberOfValueObjects++;
         }
-     
-        return valueAttr;
+
+        dObj = (DataObject*)dObj->sibling;
     }
 
-    return NULL;
-}
+    if (numberOfValueObjects == 0)
+        return true;
 
-static MmsDataAccessError
-strTm_writeAccessHandler(DataAttribute* dataAttribute, MmsValue* value, ClientConnection connection, void* parameter)
-{
-    Schedule self = (Schedule)parameter;
+    self->scheduleValues = (DataAttribute**)schedule_allocateTable(self, numberOfValueObjects, sizeof(DataAttribute*));
 
-    if (self->allowWriteToStrTm)
-    {
-        uint64_t newStrTm = MmsValue_getUtcTimeInMs(value);
+    if (self->scheduleValues == NULL)
+        return false;
 
-        char objRefBuf[130];
+    dObj = (DataObject*)self->scheduleLn->firstChild;
 
-        ModelNode_getObjectReference((ModelNode*) dataAttribute, objRefBuf);
+    while (dObj) {
+        if (scheduler_checkIfMultiObjInst(dObj->name, multiObjStr) && (dObj->name[prefixLen] != 0)) {
+            int idx = atoi(dObj->name + prefixLen);
 
-        // check if the time is valid (is in the future)
-        if (newStrTm > Hal_getTimeInMs()) {
-            //TODO check if the schedule is in the correct state?
+            if ((idx > 0) && (idx <= numberOfValueObjects) && (self->scheduleValues[idx - 1] == NULL)) {
+                DataAttribute* valueAttr = NULL;
 
-            if (schedule_getState(self) == SCHD_STATE_READY) {
-                //self->nextStartTime = schedule_getNextStartTime(self);
+                if (self->targetType == SCHD_TYPE_MV) {
+                    valueAttr = (DataAttribute*)ModelNode_getChild((ModelNode*)dObj, "setMag.f");
 
-                //schedule_updateNxtStrTm(self, newStrTm);
-            }
+                    if (valueAttr == NULL)
+                        valueAttr = (DataAttribute*)ModelNode_getChild((ModelNode*)dObj, "setMag.i");
+                }
+                else {
+                    valueAttr = (DataAttribute*)ModelNode_getChild((ModelNode*)dObj, "setVal");
+                }
+
+                self->scheduleValues[idx - 1] = valueAttr;
+            }
+        }
+
+        dObj = (DataObject*)dObj->sibling;
+    }
+
+    /* only consecutive entries starting with entry 1 can be used */
+    while ((self->numberOfScheduleValues < numberOfValueObjects) && (self->scheduleValues[self->numberOfScheduleValues] != NULL)) {
+        self->numberOfScheduleValues++;
+    }
+
+    printf("INFO: Schedule has %i elements\n", self->numberOfScheduleValues);
+
+    return true;
+}
+
+/**
+ * @brief Get the schedule attribute with index idx (starting with 1)
+ */
+static DataAttribute*
+schedule_getScheduleValueAttribute(Schedule self, int idx)
+{
+    if ((idx > 0) && (idx <= self->numberOfScheduleValues))
+        return self->scheduleValues[idx - 1];
+    else
+        return NULL;
+}
+
+static MmsDataAccessError
+strTm_writeAccessHandler(DataAttribute* dataAttribute, MmsValue* value, ClientConnection connection, void* parameter)
+{
+    Schedule self = (Schedule)parameter;
+
+    if (self->allowWriteToStrTm)
+    {
+        uint64_t newStrTm = MmsValue_getUtcTimeInMs(value);
+
+        char objRefBuf[130];
+
+        ModelNode_getObjectReference((ModelNode*) dataAttribute, objRefBuf);
+
+        // check if the time is valid (is in the future)
+        if (newStrTm > Hal_getTimeInMs()) {
+            //TODO check if the schedule is in the correct state?
+
+            SchedulerCommand command;
+
+            memset(&command, 0, sizeof(command));
+
+            command.type = SCHD_CMD_SET_START_TIME;
+            command.attribute = dataAttribute;
+            command.timeValue = newStrTm;
+
+            if (Schedule_sendCommand(self, &command) == false)
+                return DATA_ACCESS_ERROR_TEMPORARILY_UNAVAILABLE;
 
             printf("INFO: Write access to %s -> value accepted\n", objRefBuf);
 
@@ -518,21 +786,17 @@ schdPrio_writeAccessHandler(DataAttribute* dataAttribute, MmsValue* value, Clien
     Schedule self = (Schedule)parameter;
 
     if (self->allowWriteToSchdPrio) {
-        int prio = MmsValue_toInt32(value);
-
-        IedServer_updateAttributeValue(self->server, dataAttribute, value);
-
-        /* send PRIO_UPDATED event to schedule controller(s) */
+        SchedulerCommand command;
 
-        LinkedList controllerElem = LinkedList_getNext(self->knownScheduleControllers);
+        memset(&command, 0, sizeof(command));
 
-        while (controllerElem) {
-            ScheduleController controller = (ScheduleController)LinkedList_getData(controllerElem);
+        command.type = SCHD_CMD_SET_PRIO;
+        command.intValue = MmsValue_toInt32(value);
 
-            scheduleController_schedulePrioUpdated(controller, self, prio);
+        if (Schedule_sendCommand(self, &command) == false)
+            return DATA_ACCESS_ERROR_TEMPORARILY_UNAVAILABLE;
 
-            controllerElem = LinkedList_getNext(controllerElem);
-        }
+        IedServer_updateAttributeValue(self->server, dataAttribute, value);
 
         return DATA_ACCESS_ERROR_SUCCESS;
     }
@@ -623,75 +887,26 @@ isPeriodic(Schedule self)
 static void
 schedule_installWriteAccessHandlersForStrTm(Schedule self)
 {
-    LinkedList dataObjects = ModelNode_getChildren((ModelNode*)self->scheduleLn);
-
-    LinkedList doElem = LinkedList_getNext(dataObjects);
-
-    while (doElem) {
-        DataObject* dObj = (DataObject*)LinkedList_getData(doElem);
-
-        // check that data object name is "StrTmXXX"
-        if (checkIfStrTm(dObj->name)) {
-
-            DataAttribute* setTm = (DataAttribute*)ModelNode_getChild((ModelNode*)dObj, "setTm");
-
-            if (setTm) {
-                IedServer_handleWriteAccess(self->server, setTm, strTm_writeAccessHandler, self);            
-            }
-        }
-
-        doElem = LinkedList_getNext(doElem);
-    }
-
-    LinkedList_destroyStatic(dataObjects);
-}
-
-static uint64_t 
-getStartTime(DataObject* strTm)
-{
-    uint64_t strTmVal = 0;
-
-    DataAttribute* setTm = (DataAttribute*)ModelNode_getChild((ModelNode*)strTm, "setTm");
+    int i;
 
-    if (setTm) {
-        if (setTm->mmsValue) {
-            strTmVal = MmsValue_getUtcTimeInMs(setTm->mmsValue);
+    for (i = 0; i < self->numberOfStartTimes; i++) {
+        if (self->startTimes[i].setTm) {
+            IedServer_handleWriteAccess(self->server, self->startTimes[i].setTm, strTm_writeAccessHandler, self);
         }
     }
-
-    return strTmVal;
-}
-
-static bool
-hasSetTm(DataObject* dobj)
-{
-    ModelNode* setTm = ModelNode_getChild((ModelNode*)dobj, "setTm");
-
-    if (setTm) {
-        //TODO check type?
-        return true;
-    }
-    else {
-        return false;
-    }
 }
 
-static bool
-hasSetCal(DataObject* dobj)
+static int
+getIntAttributeValue(DataAttribute* da, int defaultValue)
 {
-    ModelNode* setCal = ModelNode_getChild((ModelNode*)dobj, "setCal");
-
-    if (setCal) {
-        //TODO check type?
-        return true;
-    }
-    else {
-        return false;
-    }
+    if (da && (da->mmsValue) && (MmsValue_getType(da->mmsValue) == MMS_INTEGER))
+        return MmsValue_toInt32(da->mmsValue);
+    else
+        return defaultValue;
 }
 
 static uint64_t
-getSchdIntvValueInMs(Schedule self)
+calculateIntervalInMs(Schedule self, int schedIntvValue)
 {
     uint64_t interval = 0;
 
@@ -701,11 +916,9 @@ getSchdIntvValueInMs(Schedule self)
 
     double multiPl = 1.0;
 
-    DataAttribute* unit = (DataAttribute*)ModelNode_getChild((ModelNode*)self->scheduleLn, "SchdIntv.units.SIUnit");
-
-    if (unit) {
-        if ((unit->mmsValue) && (MmsValue_getType(unit->mmsValue) == MMS_INTEGER)) {
-            int unitEnumValue = MmsValue_toInt32(unit->mmsValue);
+    if (self->schdIntvUnit) {
+        if ((self->schdIntvUnit->mmsValue) && (MmsValue_getType(self->schdIntvUnit->mmsValue) == MMS_INTEGER)) {
+            int unitEnumValue = MmsValue_toInt32(self->schdIntvUnit->mmsValue);
 
             if (unitEnumValue == 4) { /* second */
                 baseTime = 1;
@@ -722,45 +935,101 @@ getSchdIntvValueInMs(Schedule self)
         }
     }
 
-    DataAttribute* multiplier = (DataAttribute*)ModelNode_getChild((ModelNode*)self->scheduleLn, "SchdIntv.units.multiplier");
-
-    if (multiplier) {
-        if ((multiplier->mmsValue) && (MmsValue_getType(multiplier->mmsValue) == MMS_INTEGER)) {
-            multiplierEnumValue = MmsValue_toInt32(multiplier->mmsValue);
+    if (self->schdIntvMultiplier) {
+        if ((self->schdIntvMultiplier->mmsValue) && (MmsValue_getType(self->schdIntvMultiplier->mmsValue) == MMS_INTEGER)) {
+            multiplierEnumValue = MmsValue_toInt32(self->schdIntvMultiplier->mmsValue);
 
             multiPl = pow(10, multiplierEnumValue);
         }
     }
 
-    DataAttribute* schdIntv = (DataAttribute*)ModelNode_getChild((ModelNode*)self->scheduleLn, "SchdIntv.setVal");
+    if (self->schdIntv) {
+        double value = (schedIntvValue * baseTime * 1000) * multiPl;
 
-    if (schdIntv) {
-        if ((schdIntv->mmsValue) && (MmsValue_getType(schdIntv->mmsValue) == MMS_INTEGER)) {
-            int schedIntvValue = MmsValue_toInt32(schdIntv->mmsValue);
-
-            double value = (schedIntvValue * baseTime * 1000) * multiPl;
-
-            interval = (uint64_t)value;
-        }
+        interval = (uint64_t)value;
     }
 
     return interval;
 }
 
-static int
-schedule_getNumEntrValue(Schedule self)
+/**
+ * @brief Get the duration of an entry (index 0 -> entry 1)
+ *
+ * has to be called with parameterLock
+ */
+static uint64_t
+schedule_getEntryDurationInMs(Schedule self, int idx)
+{
+    if (idx < self->numberOfEntryDurations)
+        return self->entryDurations[idx];
+    else
+        return self->intervalInMs;
+}
+
+/**
+ * @brief Update the validation cache when parameters changed since the last validation
+ *
+ * NumEntr and SchdIntv are compared with the data model (written by clients or locally by the
+ * application), the entry durations are marked dirty by Schedule_setEntryDurations.
+ *
+ * has to be called with parameterLock
+ */
+static void
+schedule_updateValidationCache(Schedule self)
 {
-    int numEntrVal = -1;
+    int numEntrValue = getIntAttributeValue(self->numEntr, -1);
+
+    if (numEntrValue != self->numEntrValue) {
+        self->numEntrValue = numEntrValue;
+        self->dirtyParameters |= SCHD_DIRTY_NUM_ENTR;
+    }
+
+    int schdIntvValue = getIntAttributeValue(self->schdIntv, 0);
+    int schdIntvUnitValue = getIntAttributeValue(self->schdIntvUnit, 0);
+    int schdIntvMultiplierValue = getIntAttributeValue(self->schdIntvMultiplier, 0);
+
+    if ((schdIntvValue != self->schdIntvValue) || (schdIntvUnitValue != self->schdIntvUnitValue) ||
+        (schdIntvMultiplierValue != self->schdIntvMultiplierValue))
+    {
+        self->schdIntvValue = schdIntvValue;
+        self->schdIntvUnitValue = schdIntvUnitValue;
+        self->schdIntvMultiplierValue = schdIntvMultiplierValue;
+        self->dirtyParameters |= SCHD_DIRTY_SCHD_INTV;
+    }
 
-    DataAttribute* numEntr = (DataAttribute*)ModelNode_getChild((ModelNode*)self->scheduleLn, "NumEntr.setVal");
+    if (self->dirtyParameters == 0)
+        return;
 
-    if (numEntr) {
-        if ((numEntr->mmsValue) && (MmsValue_getType(numEntr->mmsValue) == MMS_INTEGER)) {
-            numEntrVal = MmsValue_toInt32(numEntr->mmsValue);
+    if (self->dirtyParameters & SCHD_DIRTY_SCHD_INTV) {
+        self->intervalInMs = calculateIntervalInMs(self, self->schdIntvValue);
+    }
+
+    if ((self->numEntrValue > 0) && (self->numEntrValue <= self->numberOfScheduleValues)) {
+
+        if (self->schdIntvValue > 0) {
+            self->validationResult = SCHD_ENA_ERR_NONE;
+        }
+        else {
+            self->validationResult = SCHD_ENA_ERR_MISSING_VALID_SCHDINTV;
         }
     }
-    
-    return numEntrVal;
+    else {
+        self->validationResult = SCHD_ENA_ERR_MISSING_VALID_NUMENTR;
+    }
+
+    self->scheduleDurationInMs = 0;
+
+    if (self->numberOfEntryDurations > 0) {
+        int i;
+
+        for (i = 0; i < self->numEntrValue; i++)
+            self->scheduleDurationInMs += schedule_getEntryDurationInMs(self, i);
+    }
+    else if (self->numEntrValue > 0) {
+        self->scheduleDurationInMs = self->intervalInMs * self->numEntrValue;
+    }
+
+    self->dirtyParameters = 0;
 }
 
 static bool
@@ -770,54 +1039,43 @@ checkForValidStartTimes(Schedule self)
 
     uint64_t currentTime = Hal_getTimeInMs();
 
-    LinkedList dataObjects = ModelNode_getChildren((ModelNode*)self->scheduleLn);
+    int i;
 
-    LinkedList doElem = LinkedList_getNext(dataObjects);
+    /* start times set locally by the application are only visible in the data model */
+    schedule_syncStartTimes(self);
 
-    uint64_t scheduleDurationMs = 0;
-    
-    int numEntryVal = schedule_getNumEntrValue(self);
+    Semaphore_wait(self->parameterLock);
 
-    if (numEntryVal > 0) {
-        scheduleDurationMs = getSchdIntvValueInMs(self) * numEntryVal;
-    }
-    
-    while (doElem) {
-        DataObject* dObj = (DataObject*)LinkedList_getData(doElem);
+    schedule_updateValidationCache(self);
 
-        // check that data object name is "StrTmXXX"
-        if (checkIfStrTm(dObj->name)) {
-            printf("INFO: Found start time: %s\n", dObj->name);
+    uint64_t scheduleDurationMs = self->scheduleDurationInMs;
 
-            if (isPeriodic(self)) {
-                if (hasSetCal(dObj)) {
-                    if (hasSetTm(dObj)) {
-                        if (getStartTime(dObj) < currentTime) {
-                            hasValidStartTimes = true;
-                        }
-                    }
-                    else {
-                        hasValidStartTimes = true;
-                    }
-                }
-                else {
-                    printf("DEBUG: start time of periodic schedule is missing setCal -> ignore\n");
+    for (i = 0; i < self->numberOfStartTimes; i++) {
+        ScheduleStartTime* strTm = &(self->startTimes[i]);
+
+        printf("INFO: Found start time: %s\n", strTm->strTm->name);
+
+        if (isPeriodic(self)) {
+            if (strTm->setCal) {
+                if (strTm->value < currentTime) {
+                    hasValidStartTimes = true;
                 }
             }
             else {
-                if (getStartTime(dObj) + scheduleDurationMs > currentTime) {
-                    hasValidStartTimes = true;
-                }
-                else {
-                    printf("     start time is in the past and consumed!\n");
-                }
+                printf("DEBUG: start time of periodic schedule is missing setCal -> ignore\n");
+            }
+        }
+        else {
+            if (strTm->value + scheduleDurationMs > currentTime) {
+                hasValidStartTimes = true;
+            }
+            else {
+                printf("     start time is in the past and consumed!\n");
             }
         }
-
-        doElem = LinkedList_getNext(doElem);
     }
 
-    LinkedList_destroyStatic(dataObjects);
+    Semaphore_post(self->parameterLock);
 
     return hasValidStartTimes;
 }
@@ -825,31 +1083,17 @@ checkForValidStartTimes(Schedule self)
 static bool
 performGenericScheduleValidityChecks(Schedule self)
 {
-    /* check if NumEntr is valid */
-    int numEntrVal = schedule_getNumEntrValue(self);
-
-    bool numEntrValid = false;
-
-    if (numEntrVal > 0) {
+    Semaphore_wait(self->parameterLock);
 
-        if (numEntrVal <= schedule_getNumberOfScheduleEntries(self)) {
+    schedule_updateValidationCache(self);
 
-            numEntrValid = true;
+    ScheduleEnablingError validationResult = self->validationResult;
 
-            int i;
+    uint64_t intervalInMs = self->intervalInMs;
 
-            for (i = 1; i <= numEntrVal; i++) {
-                if (schedule_getScheduleValueAttribute(self, i) == NULL) {
-                    numEntrValid = false;
-                    break;
-                }
-            }
-        }
-    }
-    
-    self->numberOfScheduleEntries = numEntrVal;
+    Semaphore_post(self->parameterLock);
 
-    if (numEntrValid == false) {
+    if (validationResult == SCHD_ENA_ERR_MISSING_VALID_NUMENTR) {
         schedule_updateScheduleEnableError(self, SCHD_ENA_ERR_MISSING_VALID_NUMENTR);
 
         return false;
@@ -859,39 +1103,30 @@ performGenericScheduleValidityChecks(Schedule self)
 
     /* check if SchdIntv is valied */
 
-    DataAttribute* schdIntv = (DataAttribute*)ModelNode_getChild((ModelNode*)self->scheduleLn, "SchdIntv.setVal");
-
-    bool schdIntvValid = false;
-
-    if (schdIntv) {
-        if ((schdIntv->mmsValue) && (MmsValue_getType(schdIntv->mmsValue) == MMS_INTEGER)) {
-            int schdIntvValue = MmsValue_toInt32(schdIntv->mmsValue);
-
-            if (schdIntvValue > 0) {
-                schdIntvValid = true;
-            }
-        }
-    }
-
-    if (schdIntvValid == false) {
+    if (validationResult == SCHD_ENA_ERR_MISSING_VALID_SCHDINTV) {
         schedule_updateScheduleEnableError(self, SCHD_ENA_ERR_MISSING_VALID_SCHDINTV);
 
         return false;
     }
 
-    printf("INFO: SchdIntv interval: %lu ms\n", getSchdIntvValueInMs(self));
+    printf("INFO: SchdIntv interval: %lu ms\n", intervalInMs);
 
     printf("INFO: SchdIntv is valid\n");
 
     return true;
  }
 
-static bool
-enabledSchedule(Schedule self)
+/**
+ * @brief Check the conditions for enabling the schedule without changing the schedule state
+ *
+ * Can be called by any thread (e.g. to validate a group of changes before they are queued). Sets
+ * SchdEnaErr when a condition is not met.
+ *
+ * @return true when the schedule can be enabled
+ */
+bool
+Schedule_checkEnable(Schedule self)
 {
-    ScheduleState newState = SCHD_STATE_NOT_READY;
-    /* TODO check for conditions to enable schedule */
-
     //TODO check if a Start time (StrTm) is defined or an external trigger option is set (EvTeg == true}
 
     if (performGenericScheduleValidityChecks(self)) {
@@ -899,14 +1134,14 @@ enabledSchedule(Schedule self)
         if (isEventDriven(self)) {
             if (checkSyncInput(self)) {
                 printf("INFO: valid trigger info set\n");
-                newState = SCHD_STATE_READY;
+                return true;
             }
         }
         else if(isTimeTriggered(self)) {
 
             if (checkForValidStartTimes(self)) {
                 printf("INFO: valid schedules found\n");
-                newState = SCHD_STATE_READY;
+                return true;
             }
             else {
                 schedule_updateScheduleEnableError(self, SCHD_ENA_ERR_MISSING_VALID_STRTM);
@@ -914,11 +1149,32 @@ enabledSchedule(Schedule self)
         }
     }
 
+    return false;
+}
+
+static bool
+enabledSchedule(Schedule self)
+{
+    ScheduleState newState = SCHD_STATE_NOT_READY;
+
+    if (Schedule_checkEnable(self))
+        newState = SCHD_STATE_READY;
+
+    Semaphore_wait(self->parameterLock);
+    int numberOfScheduleEntries = self->numEntrValue;
+    Semaphore_post(self->parameterLock);
+
+    schedule_beginHotUpdate(self);
+    self->hot->numberOfScheduleEntries = numberOfScheduleEntries;
+    schedule_endHotUpdate(self);
+
     schedule_udpateState(self, newState);
 
     if (newState == SCHD_STATE_READY) {
         uint64_t nextStartTime = schedule_getNextStartTime(self);
 
+        /* a ready schedule without start time is only processed again for a command */
+        schedule_setNextStartTime(self, nextStartTime);
         schedule_updateNxtStrTm(self, nextStartTime);
 
         schedule_updateScheduleEnableError(self, SCHD_ENA_ERR_NONE);
@@ -992,320 +1248,1098 @@ schedule_controlHandler(ControlAction action, void* parameter, MmsValue* ctlVal,
     char scheduleRef[130];
     ModelNode_getObjectReference((ModelNode*)self->scheduleLn, scheduleRef);
 
+    SchedulerCommand command;
+
+    memset(&command, 0, sizeof(command));
+
     if (ctrlObj == self->enaReq) {
         if ((test == false) && (MmsValue_getBoolean(ctlVal) == true)) {
-
-            if (enabledSchedule(self)) {
-                printf("INFO: Enabled schedule %s\n", scheduleRef);
-            }
-            else {
-                //TODO figure out how a negative answer can be sent?
-                printf("WARN: Cannot enable schedule %s\n", scheduleRef);
-            }
+            command.type = SCHD_CMD_ENABLE;
         }
     }
     else if (ctrlObj == self->dsaReq) {
         if ((test == false) && (MmsValue_getBoolean(ctlVal) == true)) {
+            command.type = SCHD_CMD_DISABLE;
+        }
+    }
 
-            disableSchedule(self);
-
-            printf("INFO: Disabled schedule %s\n", scheduleRef);
+    /* executed by the thread processing the schedule */
+    if (command.type != 0) {
+        if (Schedule_sendCommand(self, &command) == false) {
+            printf("WARN: Command queue of schedule %s is full\n", scheduleRef);
+            return CONTROL_RESULT_FAILED;
         }
     }
 
     return CONTROL_RESULT_OK;
 }
 
-static int
-schedule_getCurrentIdx(Schedule self, uint64_t currentTime)
+/**
+ * @brief Queue a command for the thread processing the schedule (can be called by any thread)
+ *
+ * @return true on success, false when the command queue is full
+ */
+static void
+schedule_signalCommand(Schedule self)
 {
-    int currentIdx = (currentTime - self->startTime) / self->entryDurationInMs;
+    __atomic_store_n(&(self->hot->hasCommands), true, __ATOMIC_RELEASE);
 
-    if (currentIdx >= self->numberOfScheduleEntries) 
-        currentIdx = -1;
+    /* wake up the event loop of the application */
+    if (self->eventFd != -1) {
+        uint64_t value = 1;
 
-    return currentIdx;
+        if (write(self->eventFd, &value, sizeof(value)) != sizeof(value))
+            printf("WARN: Failed to signal scheduler event\n");
+    }
 }
 
-static void
-schedule_updateCurrentValue(Schedule self, uint64_t currentTime, MmsValue* value)
+bool
+Schedule_sendCommand(Schedule self, const SchedulerCommand* command)
 {
-    DataAttribute* currentValAttr = schedule_getCurrentValueAttribute(self);
+    if (CommandQueue_push(&(self->commands), command) == false)
+        return false;
 
-    if (currentValAttr) {
-        DataAttribute* q = schedule_getCurrentValueSubAttribute(self, "q");
-        DataAttribute* t = schedule_getCurrentValueSubAttribute(self, "t");
+    schedule_signalCommand(self);
 
-        IedServer_lockDataModel(self->server);
+    return true;
+}
 
-        IedServer_updateAttributeValue(self->server, currentValAttr, value);
+/**
+ * @brief Reserve space in the command queue for commands sent with Schedule_sendReservedCommand
+ *
+ * @return false when the command queue doesn't have enough free space
+ */
+bool
+Schedule_reserveCommands(Schedule self, int numberOfCommands)
+{
+    return CommandQueue_reserve(&(self->commands), numberOfCommands);
+}
 
-        if (t) {
-            //TODO change to IedServer_updateTimestampAttributeValue 
-            IedServer_updateUTCTimeAttributeValue(self->server, t, currentTime);
-        }
+void
+Schedule_releaseCommandReservation(Schedule self, int numberOfCommands)
+{
+    CommandQueue_releaseReservation(&(self->commands), numberOfCommands);
+}
 
-        if (q) {
-            IedServer_updateQuality(self->server, q, QUALITY_VALIDITY_GOOD);
-        }
+/**
+ * @brief Send a command in space reserved with Schedule_reserveCommands (cannot fail)
+ */
+void
+Schedule_sendReservedCommand(Schedule self, const SchedulerCommand* command)
+{
+    CommandQueue_pushReserved(&(self->commands), command);
 
-        IedServer_unlockDataModel(self->server);
-    }
+    schedule_signalCommand(self);
 }
 
-static void
-schedule_updateSchdEntr(Schedule self, uint64_t currentTime, int idx)
+void
+Schedule_setEventFd(Schedule self, int eventFd)
 {
-    DataAttribute* schdEntr_stVal = (DataAttribute*)ModelNode_getChild((ModelNode*)self->scheduleLn, "SchdEntr.stVal");
+    self->eventFd = eventFd;
+}
 
-    if (schdEntr_stVal) {
-        DataAttribute* schdEntr_t = (DataAttribute*)ModelNode_getChild((ModelNode*)self->scheduleLn, "SchdEntr.t");
+/**
+ * @brief Set the thread configuration of the scheduler (used by the thread of the schedule)
+ */
+void
+Schedule_setThreadConfig(Schedule self, SchedulerRtConfig* config, uint32_t* sequence)
+{
+    self->threadConfig = config;
 
-        IedServer_lockDataModel(self->server);
+    /* the schedule thread can already be running */
+    __atomic_store_n(&(self->threadConfigSequence), sequence, __ATOMIC_RELEASE);
+}
 
-        if (schdEntr_t) {
-            //TODO change to IedServer_updateTimestampAttributeValue 
-            IedServer_updateUTCTimeAttributeValue(self->server, schdEntr_t, currentTime);
-        }
+/**
+ * @brief Enable or disable the schedule (only called by the thread processing the schedule)
+ *
+ * @return false when the schedule cannot be enabled
+ */
+static bool
+schedule_enable(Schedule self, bool enable)
+{
+    char scheduleRef[130];
 
-        IedServer_updateInt32AttributeValue(self->server, schdEntr_stVal, idx);
+    ModelNode_getObjectReference((ModelNode*)self->scheduleLn, scheduleRef);
+
+    if (enable) {
+        if (enabledSchedule(self)) {
+            printf("INFO: Enabled schedule %s\n", scheduleRef);
+            return true;
+        }
+        else {
+            //TODO figure out how a negative answer can be sent?
+            printf("WARN: Cannot enable schedule %s\n", scheduleRef);
+            return false;
+        }
+    }
+    else {
+        if (schedule_getState(self) != SCHD_STATE_NOT_READY) {
+            disableSchedule(self);
+        }
 
-        IedServer_unlockDataModel(self->server);
+        printf("INFO: Disabled schedule %s\n", scheduleRef);
+        return true;
     }
 }
 
 static void
-notifyControllers(Schedule self, MmsValue* val, uint64_t currentTime)
+schedule_executeCommand(Schedule self, SchedulerCommand* command)
 {
-    /* send new value to schedule controller(s) */
+    bool result = true;
 
-    LinkedList controllerElem = LinkedList_getNext(self->knownScheduleControllers);
+    int i;
 
-    while (controllerElem) {
-        ScheduleController controller = (ScheduleController)LinkedList_getData(controllerElem);
+    switch (command->type) {
+    case SCHD_CMD_ENABLE:
+        result = schedule_enable(self, true);
+        break;
 
-        scheduleController_scheduleValueUpdated(controller, self, val, currentTime);
+    case SCHD_CMD_DISABLE:
+        result = schedule_enable(self, false);
+        break;
 
-        controllerElem = LinkedList_getNext(controllerElem);
-    }
-}
+    case SCHD_CMD_SET_PRIO:
+        schedule_beginHotUpdate(self);
+        self->hot->prio = command->intValue;
+        schedule_endHotUpdate(self);
 
-MmsValue*
-Schedule_getCurrentValue(Schedule self)
-{
-    MmsValue* currentValue = NULL;
+        /* SchdPrio.setVal is already updated by the write access handler for client writes */
+        if (command->batch) {
+            DataAttribute* schdPrio_setVal = (DataAttribute*)ModelNode_getChild((ModelNode*)self->scheduleLn, "SchdPrio.setVal");
+
+            if (schdPrio_setVal) {
+                scheduler_lockDataModel(self->server);
+                IedServer_updateInt32AttributeValue(self->server, schdPrio_setVal, command->intValue);
+                scheduler_unlockDataModel(self->server);
+            }
+        }
+
+        /* send PRIO_UPDATED event to schedule controller(s) */
+
+        for (i = 0; i < self->numberOfListeningControllers; i++) {
+            scheduleController_schedulePrioUpdated(self->listeningControllers[i], self, command->intValue);
+        }
+        break;
+
+    case SCHD_CMD_SET_START_TIME:
+        Semaphore_wait(self->parameterLock);
+
+        for (i = 0; i < self->numberOfStartTimes; i++) {
+            if (self->startTimes[i].setTm == command->attribute) {
+                schedule_setStartTimeValue(self, &(self->startTimes[i]), command->timeValue);
+                break;
+            }
+        }
+
+        Semaphore_post(self->parameterLock);
+        break;
+
+    case SCHD_CMD_CONNECT_CONTROLLER:
+        scheduleController_connectSchedule(command->controller, self, command->oldSchedule);
+        break;
+    }
+
+    /* the caller waits for the result (see Schedule_enableSchedule) */
+    if (command->completion) {
+        command->completion->result = result;
+        Semaphore_post(command->completion->done);
+    }
+}
+
+/**
+ * @brief Execute the queued external commands (only called by the thread processing the schedule)
+ */
+void
+Schedule_executeCommands(Schedule self)
+{
+    /* clear the flag first - a command queued while executing sets it again */
+    __atomic_store_n(&(self->hot->hasCommands), false, __ATOMIC_SEQ_CST);
+
+    SchedulerCommand command;
+
+    while (CommandQueue_pop(&(self->commands), &command)) {
+        schedule_executeCommand(self, &command);
+
+        if (command.batch)
+            scheduler_finishBatchCommand(command.batch);
+    }
+}
+
+/**
+ * @brief Drop the queued external commands without executing them (the schedule is destroyed)
+ *
+ * Waiting callers get the result false and the commands of a batch are finished, so that the
+ * arbitration of the batch controllers is resumed and the batch is released. Has to be called
+ * before the schedule controllers of the batches are destroyed.
+ */
+void
+Schedule_cancelCommands(Schedule self)
+{
+    __atomic_store_n(&(self->hot->hasCommands), false, __ATOMIC_SEQ_CST);
+
+    SchedulerCommand command;
+
+    while (CommandQueue_pop(&(self->commands), &command)) {
+        if (command.completion) {
+            command.completion->result = false;
+            Semaphore_post(command.completion->done);
+        }
+
+        if (command.batch)
+            scheduler_finishBatchCommand(command.batch);
+    }
+}
+
+/**
+ * @brief Calculate the end offsets of the entries at the start of the schedule (variable entry durations)
+ *
+ * has to be called with parameterLock
+ *
+ * @return true when the schedule uses variable entry durations
+ */
+static bool
+schedule_prepareEntryOffsets(Schedule self, int numberOfEntries)
+{
+    if ((self->entryDurations == NULL) || (self->entryEndOffsets == NULL))
+        return false;
+
+    if (numberOfEntries > self->entryEndOffsetsSize) {
+        printf("WARN: Schedule %s has more entries than the entry offset table -> use SchdIntv\n", self->scheduleLn->name);
+        return false;
+    }
+
+    uint64_t offset = 0;
+
+    int i;
+
+    for (i = 0; i < numberOfEntries; i++) {
+        offset += schedule_getEntryDurationInMs(self, i);
+
+        self->entryEndOffsets[i] = offset;
+    }
+
+    return true;
+}
+
+static uint64_t
+schedule_getEntryStartOffset(Schedule self, int idx)
+{
+    if (self->variableEntries)
+        return (idx > 0) ? self->entryEndOffsets[idx - 1] : 0;
+    else
+        return (uint64_t)idx * self->hot->entryDurationInMs;
+}
+
+static uint64_t
+schedule_getEntryEndOffset(Schedule self, int idx)
+{
+    if (self->variableEntries)
+        return self->entryEndOffsets[idx];
+    else
+        return (uint64_t)(idx + 1) * self->hot->entryDurationInMs;
+}
+
+static int
+schedule_getCurrentIdx(Schedule self, uint64_t currentTime)
+{
+    if (self->variableEntries) {
+        if (currentTime < self->hot->startTime)
+            return -1;
+
+        /* the cursor is only a hint - the value of a concurrent lookup is also fine */
+        int cursor = __atomic_load_n(&(self->entryCursor), __ATOMIC_RELAXED);
+
+        int idx = ScheduleCore_findEntryIndex(self->entryEndOffsets, self->hot->numberOfScheduleEntries, currentTime - self->hot->startTime, &cursor);
+
+        __atomic_store_n(&(self->entryCursor), cursor, __ATOMIC_RELAXED);
+
+        return idx;
+    }
+
+    return ScheduleCore_getEntryIndex(self->hot->startTime, self->hot->entryDurationInMs, self->hot->numberOfScheduleEntries, currentTime);
+}
+
+static void
+schedule_updateCurrentValue(Schedule self, uint64_t currentTime, MmsValue* value)
+{
+    DataAttribute* currentValAttr = schedule_getCurrentValueAttribute(self);
+
+    if (currentValAttr) {
+        DataAttribute* q = schedule_getCurrentValueSubAttribute(self, "q");
+        DataAttribute* t = schedule_getCurrentValueSubAttribute(self, "t");
+
+        /* don't rewrite q and t when consecutive entries have the same value */
+        if (self->coalescedReporting && scheduler_isValueUnchanged(currentValAttr, value, q, QUALITY_VALIDITY_GOOD))
+            return;
+
+        scheduler_lockDataModel(self->server);
+
+        IedServer_updateAttributeValue(self->server, currentValAttr, value);
+
+        if (t) {
+            //TODO change to IedServer_updateTimestampAttributeValue 
+            IedServer_updateUTCTimeAttributeValue(self->server, t, currentTime);
+        }
+
+        if (q) {
+            IedServer_updateQuality(self->server, q, QUALITY_VALIDITY_GOOD);
+        }
+
+        scheduler_unlockDataModel(self->server);
+    }
+}
+
+static void
+schedule_updateSchdEntr(Schedule self, uint64_t currentTime, int idx)
+{
+    DataAttribute* schdEntr_stVal = (DataAttribute*)ModelNode_getChild((ModelNode*)self->scheduleLn, "SchdEntr.stVal");
+
+    if (schdEntr_stVal) {
+        DataAttribute* schdEntr_t = (DataAttribute*)ModelNode_getChild((ModelNode*)self->scheduleLn, "SchdEntr.t");
+
+        scheduler_lockDataModel(self->server);
+
+        if (schdEntr_t) {
+            //TODO change to IedServer_updateTimestampAttributeValue 
+            IedServer_updateUTCTimeAttributeValue(self->server, schdEntr_t, currentTime);
+        }
+
+        IedServer_updateInt32AttributeValue(self->server, schdEntr_stVal, idx);
+
+        scheduler_unlockDataModel(self->server);
+    }
+}
+
+static void
+notifyControllers(Schedule self, MmsValue* val, uint64_t currentTime)
+{
+    /* send new value to schedule controller(s) - val is only valid during the call (the controllers copy what they keep) */
+
+    int i;
+
+    for (i = 0; i < self->numberOfListeningControllers; i++) {
+        scheduleController_scheduleValueUpdated(self->listeningControllers[i], self, val, currentTime);
+    }
+}
+
+/**
+ * @brief Calculate the values and slopes of all entries at the start of the schedule (interpolation mode)
+ */
+static void
+schedule_prepareInterpolation(Schedule self, int numberOfEntries)
+{
+    self->interpolationValid = false;
+
+    if ((self->interpolation == false) || (numberOfEntries <= 0) || ((self->hot->entryDurationInMs <= 0) && (self->variableEntries == false)))
+        return;
+
+    if (numberOfEntries > self->interpolationTableSize) {
+        double* table = (double*)realloc(self->interpolationTable, 2 * numberOfEntries * sizeof(double));
+
+        if (table == NULL)
+            return;
+
+        self->interpolationTable = table;
+        self->interpolationTableSize = numberOfEntries;
+    }
+
+    double* values = self->interpolationTable;
+    double* slopes = self->interpolationTable + numberOfEntries;
+
+    int i;
+
+    for (i = 0; i < numberOfEntries; i++) {
+        DataAttribute* valueAttr = schedule_getScheduleValueAttribute(self, i + 1);
+
+        if ((valueAttr == NULL) || (valueAttr->mmsValue == NULL) || (scheduler_getNumericValue(valueAttr->mmsValue, &(values[i])) == false)) {
+            printf("WARN: Schedule %s has non-numeric values -> no interpolation\n", self->scheduleLn->name);
+            return;
+        }
+    }
+
+    for (i = 0; i < numberOfEntries - 1; i++) {
+        slopes[i] = (values[i + 1] - values[i]) / (double)(schedule_getEntryEndOffset(self, i) - schedule_getEntryStartOffset(self, i));
+    }
+
+    /* the last entry keeps its value */
+    slopes[numberOfEntries - 1] = 0;
+
+    self->interpolationEntries = numberOfEntries;
+    self->interpolationValid = true;
+}
+
+/**
+ * @brief Calculate the interpolated value for the current time (single multiply-add)
+ */
+static MmsValue*
+schedule_interpolate(Schedule self, int idx, uint64_t currentTime)
+{
+    uint64_t entryStartTime = self->hot->startTime + schedule_getEntryStartOffset(self, idx);
+
+    double value = self->interpolationTable[idx] + self->interpolationTable[self->interpolationEntries + idx] * (double)(currentTime - entryStartTime);
+
+    MmsValue_setFloat(self->interpolatedValue, (float)value);
+
+    schedule_beginHotUpdate(self);
+    self->hot->value = value;
+    self->hot->hasValue = true;
+    self->hot->nextOutputTime = currentTime + self->interpolationIntervalInMs;
+    schedule_endHotUpdate(self);
+
+    return self->interpolatedValue;
+}
+
+static bool
+schedule_writeEntryValue(Schedule self, DataAttribute* valueAttr, double value)
+{
+    if ((valueAttr == NULL) || (valueAttr->mmsValue == NULL))
+        return false;
+
+    switch (MmsValue_getType(valueAttr->mmsValue)) {
+    case MMS_FLOAT:
+        IedServer_updateFloatAttributeValue(self->server, valueAttr, (float)value);
+        return true;
+
+    case MMS_INTEGER:
+        IedServer_updateInt32AttributeValue(self->server, valueAttr, (int32_t)value);
+        return true;
+
+    case MMS_BOOLEAN:
+        IedServer_updateBooleanAttributeValue(self->server, valueAttr, (value != 0));
+        return true;
+
+    default:
+        return false;
+    }
+}
+
+/**
+ * @brief Write the values of the entries and NumEntr from run-length compressed values (bulk upload)
+ */
+bool
+Schedule_writeCompressedValues(Schedule self, ScheduleRleReader* reader)
+{
+    int numberOfValues = ScheduleRleReader_getNumberOfValues(reader);
+
+    if ((numberOfValues <= 0) || (numberOfValues > self->numberOfScheduleValues)) {
+        printf("WARN: Schedule %s has %i entries (upload has %i values)\n", self->scheduleLn->name, self->numberOfScheduleValues, numberOfValues);
+        return false;
+    }
+
+    double value;
+
+    int i;
+
+    /* check the complete data before the data model is changed */
+    for (i = 0; i < numberOfValues; i++) {
+        if (ScheduleRleReader_getValue(reader, i, &value) == false) {
+            printf("WARN: Compressed values for schedule %s are invalid\n", self->scheduleLn->name);
+            return false;
+        }
+    }
+
+    scheduler_lockDataModel(self->server);
+
+    for (i = 0; i < numberOfValues; i++) {
+        ScheduleRleReader_getValue(reader, i, &value);
+
+        schedule_writeEntryValue(self, self->scheduleValues[i], value);
+    }
+
+    if (self->numEntr)
+        IedServer_updateInt32AttributeValue(self->server, self->numEntr, numberOfValues);
+
+    scheduler_unlockDataModel(self->server);
+
+    return true;
+}
+
+/**
+ * @brief Export the values of the first NumEntr entries as run-length compressed values
+ *
+ * @return the size of the compressed values or -1 when the buffer is too small
+ */
+int
+Schedule_readCompressedValues(Schedule self, uint8_t* buffer, int bufferSize)
+{
+    Semaphore_wait(self->parameterLock);
+
+    schedule_updateValidationCache(self);
+
+    int numberOfValues = self->numEntrValue;
+
+    Semaphore_post(self->parameterLock);
+
+    if (numberOfValues > self->numberOfScheduleValues)
+        numberOfValues = self->numberOfScheduleValues;
+
+    ScheduleRleEncoder encoder;
+
+    ScheduleRleEncoder_initialize(&encoder, buffer, bufferSize);
+
+    scheduler_lockDataModel(self->server);
+
+    int i;
+
+    for (i = 0; i < numberOfValues; i++) {
+        DataAttribute* valueAttr = self->scheduleValues[i];
+
+        double value = 0;
+
+        if (valueAttr && valueAttr->mmsValue)
+            scheduler_getNumericValue(valueAttr->mmsValue, &value);
+
+        ScheduleRleEncoder_addValue(&encoder, value);
+    }
+
+    scheduler_unlockDataModel(self->server);
+
+    return ScheduleRleEncoder_finish(&encoder);
+}
+
+/**
+ * @brief Copy the current value of the schedule into a value of the caller
+ *
+ * Can be called by other threads than the processing thread of the schedule. The interpolated
+ * value is taken from the hot state, the value of the current entry from the data model.
+ *
+ * @param value the value to update (created or replaced when NULL or of another type)
+ *
+ * @return the updated value or NULL when the schedule has no current value
+ */
+MmsValue*
+Schedule_copyCurrentValue(Schedule self, MmsValue** value)
+{
+    ScheduleHotState* hot = self->hot;
+    ScheduleHotState copy;
+
+    uint32_t seq;
+
+    do {
+        seq = scheduler_beginSequenceRead(&(hot->sequence));
+
+        memcpy(&copy, hot, sizeof(ScheduleHotState));
+
+    } while (scheduler_retrySequenceRead(&(hot->sequence), seq));
+
+    MmsValue* currentValue = NULL;
+
+    if ((copy.state == SCHD_STATE_RUNNING) && (copy.currentEntryIdx >= 0) && copy.nextOutputTime && copy.hasValue) {
+        /* interpolation mode */
+        if (*value && (MmsValue_getType(*value) != MMS_FLOAT)) {
+            MmsValue_delete(*value);
+            *value = NULL;
+        }
+
+        if (*value == NULL)
+            *value = MmsValue_newFloat((float)copy.value);
+        else
+            MmsValue_setFloat(*value, (float)copy.value);
+
+        return *value;
+    }
 
     int currentIdx = schedule_getCurrentIdx(self, Hal_getTimeInMs());
 
-    if (currentIdx != -1) {
+    if (currentIdx == -1)
+        return NULL;
+
+    scheduler_lockDataModel(self->server);
 
-        DataAttribute* valueAttr = schedule_getScheduleValueAttribute(self, currentIdx + 1);
+    DataAttribute* valueAttr = schedule_getScheduleValueAttribute(self, currentIdx + 1);
 
-        if (valueAttr) {
-            currentValue = valueAttr->mmsValue;
+    if (valueAttr && valueAttr->mmsValue) {
+        if (*value && (MmsValue_getType(*value) != MmsValue_getType(valueAttr->mmsValue))) {
+            MmsValue_delete(*value);
+            *value = NULL;
         }
+
+        if (*value == NULL)
+            *value = MmsValue_clone(valueAttr->mmsValue);
+        else
+            MmsValue_update(*value, valueAttr->mmsValue);
+
+        currentValue = *value;
     }
 
+    scheduler_unlockDataModel(self->server);
+
     return currentValue;
 }
 
-static void*
-schedule_thread(void* parameter)
+/**
+ * @brief Execute one cycle of the schedule state machine
+ * 
+ * Called periodically by the schedule thread or by the scheduler thread (low footprint mode).
+ */
+void
+Schedule_process(Schedule self, uint64_t currentTime)
 {
-    Schedule self = (Schedule)parameter;
-
     char scheduleRef[130];
-    ModelNode_getObjectReference((ModelNode*)self->scheduleLn, scheduleRef);
 
-    schedule_updateActStrTm(self, 0);
+    if (__atomic_load_n(&(self->hot->hasCommands), __ATOMIC_ACQUIRE))
+        Schedule_executeCommands(self);
 
-    while (self->alive) {
+    ScheduleState state = schedule_getState(self);
 
-        ScheduleState state = schedule_getState(self);
+    ScheduleState newState = state;
 
-        uint64_t currentTime = Hal_getTimeInMs();
+    bool coalesced = schedule_beginModelUpdate(self);
 
-        ScheduleState newState = state;
+    if (state == SCHD_STATE_READY) {
 
-        if (state == SCHD_STATE_READY) {
+        if (self->hot->nextStartTime == 0) {
+            schedule_setNextStartTime(self, schedule_getNextStartTime(self));
+        }
+        
+        if ((self->hot->nextStartTime != 0) && (currentTime > self->hot->nextStartTime)) {
 
-            if (self->nextStartTime == 0) {
-                self->nextStartTime = schedule_getNextStartTime(self);
-            }
-            
-            if ((self->nextStartTime != 0) && (currentTime > self->nextStartTime)) {
+            Semaphore_wait(self->parameterLock);
 
-                self->startTime = self->nextStartTime;
-                self->entryDurationInMs = getSchdIntvValueInMs(self);
-                self->numberOfScheduleEntries = schedule_getNumEntrValue(self);
-                self->currentEntryIdx = -2;
+            schedule_updateValidationCache(self);
 
-                /* calculate current index */
-                int currentIdx = schedule_getCurrentIdx(self, currentTime);
-                
-                /* update ActStrTm */
-                schedule_updateActStrTm(self, self->startTime);
+            int entryDurationInMs = self->intervalInMs;
+            int numberOfScheduleEntries = self->numEntrValue;
 
-                eraseStartTime(self, self->startTime);
+            self->variableEntries = schedule_prepareEntryOffsets(self, numberOfScheduleEntries);
+            self->entryCursor = 0;
 
-                self->nextStartTime = schedule_getNextStartTime(self);
+            Semaphore_post(self->parameterLock);
 
-                schedule_updateNxtStrTm(self, self->nextStartTime);
+            schedule_beginHotUpdate(self);
 
-                newState = SCHD_STATE_RUNNING;
-                printf("INFO: Schedule %s switchted to running state\n", scheduleRef);
+            self->hot->startTime = self->hot->nextStartTime;
+            self->hot->entryDurationInMs = entryDurationInMs;
+            self->hot->numberOfScheduleEntries = numberOfScheduleEntries;
+            self->hot->currentEntryIdx = -2;
+            self->hot->hasValue = false;
+            self->hot->nextOutputTime = 0;
+
+            schedule_endHotUpdate(self);
+
+            schedule_prepareInterpolation(self, numberOfScheduleEntries);
+
+            /* update ActStrTm */
+            schedule_updateActStrTm(self, self->hot->startTime);
+
+            eraseStartTime(self, self->hot->startTime);
+
+            schedule_setNextStartTime(self, schedule_getNextStartTime(self));
+
+            schedule_updateNxtStrTm(self, self->hot->nextStartTime);
+
+            newState = SCHD_STATE_RUNNING;
+            ModelNode_getObjectReference((ModelNode*)self->scheduleLn, scheduleRef);
+            printf("INFO: Schedule %s switchted to running state\n", scheduleRef);
 
-            }
         }
-        else if (state == SCHD_STATE_RUNNING) {
+    }
+    else if (state == SCHD_STATE_RUNNING) {
+
+        int currentIdx = schedule_getCurrentIdx(self, currentTime);
+
+        if ((currentIdx != -1) && (currentIdx != self->hot->currentEntryIdx)) {
+            DataAttribute* valueAttr = schedule_getScheduleValueAttribute(self, currentIdx + 1);
+
+            if (valueAttr) {
+                char objRef[130];
 
-            int currentIdx = schedule_getCurrentIdx(self, currentTime);
+                ModelNode_getObjectReferenceEx((ModelNode*)valueAttr, objRef, true);
 
-            if ((currentIdx != -1) && (currentIdx != self->currentEntryIdx)) {
-                DataAttribute* valueAttr = schedule_getScheduleValueAttribute(self, currentIdx + 1);
+                MmsValue* val = valueAttr->mmsValue;
 
-                if (valueAttr) {
-                    char objRef[130];
+                if (val) {
+                    char valBuf[256];
 
-                    ModelNode_getObjectReferenceEx((ModelNode*)valueAttr, objRef, true);
+                    MmsValue_printToBuffer(val, valBuf, 256);
 
-                    MmsValue* val = valueAttr->mmsValue;
+                    ModelNode_getObjectReference((ModelNode*)self->scheduleLn, scheduleRef);
+                    printf("INFO: schedule %s - value %s [%i]: %s\n", scheduleRef, objRef, currentIdx, valBuf);
 
-                    if (val) {
-                        char valBuf[256];
+                    if (self->interpolationValid) {
+                        /* the values may have been changed since the start of the schedule */
+                        if (scheduler_getNumericValue(val, &(self->interpolationTable[currentIdx]))) {
+                            double* slopes = self->interpolationTable + self->interpolationEntries;
 
-                        MmsValue_printToBuffer(val, valBuf, 256);
+                            if (currentIdx < (self->interpolationEntries - 1)) {
+                                DataAttribute* nextValueAttr = schedule_getScheduleValueAttribute(self, currentIdx + 2);
 
-                        printf("INFO: schedule %s - value %s [%i]: %s\n", scheduleRef, objRef, currentIdx, valBuf);
+                                /* the next entry keeps the value of the table when it is not numeric anymore */
+                                if (nextValueAttr && nextValueAttr->mmsValue)
+                                    scheduler_getNumericValue(nextValueAttr->mmsValue, &(self->interpolationTable[currentIdx + 1]));
 
-                        // update ValMV, ValINS, ValSPS, ValENS
-                        schedule_updateCurrentValue(self, currentTime, val);
-            
-                        schedule_updateSchdEntr(self, currentTime, currentIdx + 1);
+                                slopes[currentIdx] = (self->interpolationTable[currentIdx + 1] - self->interpolationTable[currentIdx]) /
+                                    (double)(schedule_getEntryEndOffset(self, currentIdx) - schedule_getEntryStartOffset(self, currentIdx));
+                            }
 
-                        notifyControllers(self, val, currentTime);
+                            val = schedule_interpolate(self, currentIdx, currentTime);
+                        }
+                    }
+                    else {
+                        schedule_beginHotUpdate(self);
+                        self->hot->hasValue = scheduler_getNumericValue(val, &(self->hot->value));
+                        schedule_endHotUpdate(self);
                     }
-                }
 
-                self->currentEntryIdx = currentIdx;
+                    // update ValMV, ValINS, ValSPS, ValENS
+                    schedule_updateCurrentValue(self, currentTime, val);
+        
+                    schedule_updateSchdEntr(self, currentTime, currentIdx + 1);
+
+                    notifyControllers(self, val, currentTime);
+                }
             }
-            else {
 
-                if (currentIdx == -1) {
-                    printf("INFO: schedule %s ended\n", scheduleRef);
+            schedule_beginHotUpdate(self);
+            self->hot->currentEntryIdx = currentIdx;
+            self->hot->entryStartOffset = schedule_getEntryStartOffset(self, currentIdx);
+            self->hot->entryEndOffset = schedule_getEntryEndOffset(self, currentIdx);
+            schedule_endHotUpdate(self);
+        }
+        else if ((currentIdx != -1) && self->interpolationValid && self->hot->nextOutputTime && (currentTime >= self->hot->nextOutputTime)) {
+            MmsValue* val = schedule_interpolate(self, currentIdx, currentTime);
 
-                    //TODO check for next state
-                    self->nextStartTime = schedule_getNextStartTime(self);
-                   
-                    if (self->nextStartTime) {
-                        // update ActStrTime = 0(invalid)
+            schedule_updateCurrentValue(self, currentTime, val);
 
-                        schedule_updateNxtStrTm(self, self->nextStartTime);
+            notifyControllers(self, val, currentTime);
+        }
+        else {
 
-                        newState = SCHD_STATE_READY;
-                    }
-                    else {
-                        schedule_updateNxtStrTm(self, 0);
+            if (currentIdx == -1) {
+                ModelNode_getObjectReference((ModelNode*)self->scheduleLn, scheduleRef);
+                printf("INFO: schedule %s ended\n", scheduleRef);
 
-                        newState = SCHD_STATE_NOT_READY;
-                    }
+                self->interpolationValid = false;
+
+                schedule_beginHotUpdate(self);
+                self->hot->nextOutputTime = 0;
+                schedule_endHotUpdate(self);
+
+                //TODO check for next state
+                schedule_setNextStartTime(self, schedule_getNextStartTime(self));
+               
+                if (self->hot->nextStartTime) {
+                    // update ActStrTime = 0(invalid)
 
-                    schedule_updateActStrTm(self, 0);           
+                    schedule_updateNxtStrTm(self, self->hot->nextStartTime);
+
+                    newState = SCHD_STATE_READY;
+                }
+                else {
+                    schedule_updateNxtStrTm(self, 0);
+
+                    newState = SCHD_STATE_NOT_READY;
                 }
 
+                schedule_updateActStrTm(self, 0);           
             }
-        }
 
-        if (newState != state) {
-            printf("INFO: schedule %s switch from state %i to state %i\n", scheduleRef, state, newState);
-            schedule_setState(self, newState);
-        }        
+        }
+    }
 
-        Thread_sleep(100);
+    if (newState != state) {
+        ModelNode_getObjectReference((ModelNode*)self->scheduleLn, scheduleRef);
+        printf("INFO: schedule %s switch from state %i to state %i\n", scheduleRef, state, newState);
+        schedule_setState(self, newState);
     }
+
+    schedule_endModelUpdate(self, coalesced);
 }
 
+/**
+ * @brief Check if Schedule_process has anything to do (only uses the hot state)
+ */
+bool
+ScheduleHotState_needsProcessing(ScheduleHotState* hot, uint64_t currentTime)
+{
+    if (__atomic_load_n(&(hot->hasCommands), __ATOMIC_ACQUIRE))
+        return true;
 
-Schedule
-Schedule_create(LogicalNode* schedLn, IedServer server, IedModel* model)
+    if (hot->state == SCHD_STATE_READY) {
+        /* without a valid start time only a command (e.g. a new StrTm) can start the schedule */
+        return (hot->nextStartTime != 0) && (currentTime > hot->nextStartTime);
+    }
+    else if (hot->state == SCHD_STATE_RUNNING) {
+        if (hot->currentEntryIdx < 0)
+            return true;
+
+        if (hot->nextOutputTime && (currentTime >= hot->nextOutputTime))
+            return true;
+
+        /* current time is outside of the current entry */
+        return (currentTime < hot->startTime + hot->entryStartOffset) || (currentTime >= hot->startTime + hot->entryEndOffset);
+    }
+    else {
+        return false;
+    }
+}
+
+/**
+ * @brief Get the time when ScheduleHotState_needsProcessing becomes true (only uses the hot state)
+ * 
+ * @return the time in ms since epoch or 0 when the schedule is not active or waits for a start time
+ */
+uint64_t
+ScheduleHotState_getNextDeadline(ScheduleHotState* hot, uint64_t currentTime)
 {
-    Schedule self = NULL;
+    if (__atomic_load_n(&(hot->hasCommands), __ATOMIC_ACQUIRE))
+        return currentTime;
 
-    /* check for other indications DO "ActSchdRef", DO "CtlEnt", DO "ValXX", DO "SchdXX" */
-    bool isSchedule = true;
+    if (hot->state == SCHD_STATE_READY) {
+        /* no valid start time -> woken up by the next command */
+        if (hot->nextStartTime == 0)
+            return 0;
 
-    ScheduleTargetType targetType = SCHD_TYPE_UNKNOWN;
+        return hot->nextStartTime + 1;
+    }
+    else if (hot->state == SCHD_STATE_RUNNING) {
+        if ((hot->currentEntryIdx < 0) || (currentTime < hot->startTime + hot->entryStartOffset))
+            return currentTime;
 
-    DataAttribute* schdPrio_setVal = NULL;
+        /* end of the current entry */
+        uint64_t deadline = hot->startTime + hot->entryEndOffset;
 
-    ModelNode* schdSt = ModelNode_getChild((ModelNode*)schedLn, "SchdSt");
+        if (hot->nextOutputTime && (hot->nextOutputTime < deadline))
+            deadline = hot->nextOutputTime;
 
-    if (schdSt == NULL) {
-        printf("SchdSt not found in LN %s -> skip LN\n", schedLn->name);
-        isSchedule = false;
+        return deadline;
+    }
+    else {
+        return 0;
     }
+}
 
-    ModelNode* nxtStrTm = ModelNode_getChild((ModelNode*)schedLn, "NxtStrTm");
+/* schedule processed by the current thread when it is the thread of the schedule */
+static __thread Schedule ownThreadSchedule = NULL;
 
-    if (nxtStrTm == NULL) {
-        printf("NxtStrTm not found in LN %s -> skip LN\n", schedLn->name);
-        isSchedule = false;
+static void*
+schedule_thread(void* parameter)
+{
+    Schedule self = (Schedule)parameter;
+
+    ownThreadSchedule = self;
+
+    while (self->alive) {
+        scheduler_updateThreadConfig(self->threadConfig, __atomic_load_n(&(self->threadConfigSequence), __ATOMIC_ACQUIRE),
+            &(self->appliedThreadConfig));
+
+        uint64_t currentTime = Hal_getTimeInMs();
+
+        if (ScheduleHotState_needsProcessing(self->hot, currentTime))
+            Schedule_process(self, currentTime);
+
+        uint64_t sleepStart = SchedulerRt_getMonotonicTimeInUs();
+
+        Thread_sleep(100);
+
+        SchedulerRtLatency_addWakeup(&(self->latency), sleepStart, 100);
     }
 
-    ModelNode* schdPrio = ModelNode_getChild((ModelNode*)schedLn, "SchdPrio");
+    return NULL;
+}
+
 
-    if (schdPrio == NULL) {
-        printf("SchdPrio not found in LN %s -> skip LN\n", schedLn->name);
-        isSchedule = false;
+static const char* scheduleBindingNodeNames[SCHD_BINDING_NUMBER_OF_NODES] = {
+    "SchdSt",
+    "NxtStrTm",
+    "SchdPrio",
+    "SchdPrio.setVal",
+    "EnaReq",
+    "DsaReq",
+    NULL, /* depends on the target type */
+    "EvTrg",
+    "InSyn.setSrcRef",
+    "NumEntr.setVal",
+    "SchdIntv.setVal",
+    "SchdIntv.units.SIUnit",
+    "SchdIntv.units.multiplier",
+    "SchdReuse.setVal"
+};
+
+/**
+ * @brief Get the name (relative to the schedule LN) of an element that is resolved when the schedule is bound
+ */
+const char*
+Schedule_getBindingNodeName(ScheduleTargetType targetType, ScheduleBindingNode node)
+{
+    if (node == SCHD_BINDING_VAL) {
+        if (targetType == SCHD_TYPE_MV)
+            return "ValMV";
+        else if (targetType == SCHD_TYPE_INS)
+            return "ValINS";
+        else if (targetType == SCHD_TYPE_SPS)
+            return "ValSPS";
+        else if (targetType == SCHD_TYPE_ENS)
+            return "ValENS";
+        else
+            return NULL;
+    }
+
+    return scheduleBindingNodeNames[node];
+}
+
+/**
+ * @brief Resolve the elements of the schedule LN by name
+ *
+ * The binding cache stores the positions of the resolved elements (see BindingCache_addScheduleEntry).
+ */
+void
+Schedule_resolveBinding(LogicalNode* schedLn, ScheduleBinding* binding)
+{
+    memset(binding, 0, sizeof(ScheduleBinding));
+
+    /* the last present value object defines the target type */
+    if (ModelNode_getChild((ModelNode*)schedLn, "ValMV"))
+        binding->targetType = SCHD_TYPE_MV;
+
+    if (ModelNode_getChild((ModelNode*)schedLn, "ValINS"))
+        binding->targetType = SCHD_TYPE_INS;
+
+    if (ModelNode_getChild((ModelNode*)schedLn, "ValSPS"))
+        binding->targetType = SCHD_TYPE_SPS;
+
+    if (ModelNode_getChild((ModelNode*)schedLn, "ValENS"))
+        binding->targetType = SCHD_TYPE_ENS;
+
+    int i;
+
+    for (i = 0; i < SCHD_BINDING_NUMBER_OF_NODES; i++) {
+        const char* name = Schedule_getBindingNodeName(binding->targetType, (ScheduleBindingNode)i);
+
+        if (name)
+            binding->nodes[i] = ModelNode_getChild((ModelNode*)schedLn, name);
     }
-    else {
-        schdPrio_setVal = (DataAttribute*)ModelNode_getChild(schdPrio, "setVal");
+}
+
+/**
+ * @brief Take over the resolved data model elements of the schedule LN and install the handlers
+ *
+ * Used when the schedule is created and when it is moved to a new data model.
+ */
+static bool
+schedule_bindDataModel(Schedule self, ScheduleBinding* binding)
+{
+    LogicalNode* schedLn = self->scheduleLn;
 
-        if (schdPrio_setVal == NULL) {
-            printf("SchdPrio.setVal not found in LN %s -> skip LN\n", schedLn->name);
-            isSchedule = false;
+    self->enaReq = (DataObject*)binding->nodes[SCHD_BINDING_ENA_REQ];
+    self->dsaReq = (DataObject*)binding->nodes[SCHD_BINDING_DSA_REQ];
+    self->schdSt = (DataObject*)binding->nodes[SCHD_BINDING_SCHD_ST];
+    self->val = (DataObject*)binding->nodes[SCHD_BINDING_VAL];
+    self->evTrg = (DataObject*)binding->nodes[SCHD_BINDING_EV_TRG];
+
+    if (self->evTrg) {
+        if (binding->nodes[SCHD_BINDING_IN_SYN_SET_SRC_REF] == NULL) {
+            printf("ERROR: Found EvTrg but InSyn.setSrcRef not present\n");
         }
     }
 
-    ModelNode* enaReq = ModelNode_getChild((ModelNode*)schedLn, "EnaReq");
+    if (schedule_resolveStartTimes(self) == false) {
+        printf("ERROR: Failed to resolve start times of schedule %s\n", schedLn->name);
+        return false;
+    }
 
-    if (enaReq == NULL) {
-        printf("EnaReq not found in LN %s -> skip LN\n", schedLn->name);
-        isSchedule = false;
+    if (schedule_resolveScheduleValues(self) == false) {
+        printf("ERROR: Failed to resolve values of schedule %s\n", schedLn->name);
+        return false;
     }
 
-    ModelNode* dsaReq = ModelNode_getChild((ModelNode*)schedLn, "DsaReq");
+    self->numEntr = (DataAttribute*)binding->nodes[SCHD_BINDING_NUM_ENTR_SET_VAL];
+    self->schdIntv = (DataAttribute*)binding->nodes[SCHD_BINDING_SCHD_INTV_SET_VAL];
+    self->schdIntvUnit = (DataAttribute*)binding->nodes[SCHD_BINDING_SCHD_INTV_UNIT];
+    self->schdIntvMultiplier = (DataAttribute*)binding->nodes[SCHD_BINDING_SCHD_INTV_MULTIPLIER];
 
-    if (enaReq == NULL) {
-        printf("DsaReq not found in LN %s -> skip LN\n", schedLn->name);
-        isSchedule = false;
+    Semaphore_wait(self->parameterLock);
+
+    /* the cached values are read from the data model with the next validation */
+    self->dirtyParameters = SCHD_DIRTY_NUM_ENTR | SCHD_DIRTY_SCHD_INTV;
+
+    Semaphore_post(self->parameterLock);
+
+    DataAttribute* schdPrio_setVal = (DataAttribute*)binding->nodes[SCHD_BINDING_SCHD_PRIO_SET_VAL];
+
+    self->hot->prio = getIntAttributeValue(schdPrio_setVal, 0);
+
+    if (schdPrio_setVal) {
+        IedServer_handleWriteAccess(self->server, schdPrio_setVal, schdPrio_writeAccessHandler, self);
     }
 
-    ModelNode* scheduleValue = ModelNode_getChild((ModelNode*)schedLn, "ValMV");
+    DataAttribute* schdResue_setVal = (DataAttribute*)binding->nodes[SCHD_BINDING_SCHD_REUSE_SET_VAL];
 
-    if (scheduleValue) {
-        targetType = SCHD_TYPE_MV;
+    if (schdResue_setVal) {
+        IedServer_handleWriteAccess(self->server, schdResue_setVal, schdReuse_writeAccessHandler, self);
     }
 
-    scheduleValue = ModelNode_getChild((ModelNode*)schedLn, "ValINS");
+    schedule_installWriteAccessHandlersForStrTm(self);
+
+    IedServer_setPerformCheckHandler(self->server, self->dsaReq, schedule_performCheckHandler, self);
+    IedServer_setPerformCheckHandler(self->server, self->enaReq, schedule_performCheckHandler, self);
+
+    IedServer_setControlHandler(self->server, self->dsaReq, schedule_controlHandler, self);
+    IedServer_setControlHandler(self->server, self->enaReq, schedule_controlHandler, self);
+
+    return true;
+}
+
+Schedule
+Schedule_create(LogicalNode* schedLn, IedServer server, IedModel* model)
+{
+    return Schedule_createEx(schedLn, server, model, NULL, NULL, true, NULL);
+}
+
+/**
+ * @brief Create a schedule instance
+ * 
+ * @param arena arena for the instance and its tables (owned by the scheduler) or NULL to allocate from heap
+ * @param hot zeroed element of the hot state array of the scheduler or NULL to use storage inside the instance
+ * @param ownThread true to run the schedule in its own thread, false when Schedule_process is called by the owner
+ * @param binding the resolved elements of the LN (e.g. from the binding cache) or NULL to resolve them by name
+ */
+Schedule
+Schedule_createEx(LogicalNode* schedLn, IedServer server, IedModel* model, MemoryArena arena, ScheduleHotState* hot, bool ownThread, ScheduleBinding* binding)
+{
+    Schedule self = NULL;
+
+    ScheduleBinding resolvedBinding;
 
-    if (scheduleValue) {
-        targetType = SCHD_TYPE_INS;
+    if (binding == NULL) {
+        Schedule_resolveBinding(schedLn, &resolvedBinding);
+        binding = &resolvedBinding;
     }
 
-    scheduleValue = ModelNode_getChild((ModelNode*)schedLn, "ValSPS");
+    /* check for other indications DO "ActSchdRef", DO "CtlEnt", DO "ValXX", DO "SchdXX" */
+    bool isSchedule = true;
+
+    ScheduleTargetType targetType = binding->targetType;
+
+    if (binding->nodes[SCHD_BINDING_SCHD_ST] == NULL) {
+        printf("SchdSt not found in LN %s -> skip LN\n", schedLn->name);
+        isSchedule = false;
+    }
 
-    if (scheduleValue) {
-        targetType = SCHD_TYPE_SPS;
+    if (binding->nodes[SCHD_BINDING_NXT_STR_TM] == NULL) {
+        printf("NxtStrTm not found in LN %s -> skip LN\n", schedLn->name);
+        isSchedule = false;
     }
 
-    scheduleValue = ModelNode_getChild((ModelNode*)schedLn, "ValENS");
+    if (binding->nodes[SCHD_BINDING_SCHD_PRIO] == NULL) {
+        printf("SchdPrio not found in LN %s -> skip LN\n", schedLn->name);
+        isSchedule = false;
+    }
+    else if (binding->nodes[SCHD_BINDING_SCHD_PRIO_SET_VAL] == NULL) {
+        printf("SchdPrio.setVal not found in LN %s -> skip LN\n", schedLn->name);
+        isSchedule = false;
+    }
 
-    if (scheduleValue) {
-        targetType = SCHD_TYPE_ENS;
+    if (binding->nodes[SCHD_BINDING_ENA_REQ] == NULL) {
+        printf("EnaReq not found in LN %s -> skip LN\n", schedLn->name);
+        isSchedule = false;
     }
 
-    ModelNode* schdResue_setVal = ModelNode_getChild((ModelNode*)schedLn, "SchdReuse.setVal");
+    if (binding->nodes[SCHD_BINDING_DSA_REQ] == NULL) {
+        printf("DsaReq not found in LN %s -> skip LN\n", schedLn->name);
+        isSchedule = false;
+    }
 
     if (targetType == SCHD_TYPE_UNKNOWN) {
         printf("ERROR: Found schedule %s/%s but with unknown target type!\n", schedLn->parent->name, schedLn->name);
@@ -1317,69 +2351,49 @@ Schedule_create(LogicalNode* schedLn, IedServer server, IedModel* model)
 
     if (isSchedule) {
 
-        LinkedList knownScheduleControllers = LinkedList_create();
+        if (arena)
+            self = (Schedule)MemoryArena_alloc(arena, sizeof(struct sSchedule));
+        else
+            self = (Schedule)calloc(1, sizeof(struct sSchedule));
+
+        if (self) {
+            self->arena = arena;
+
+            if (hot)
+                self->hot = hot;
+            else
+                self->hot = &(self->hotStorage);
 
-        self = (Schedule)calloc(1, sizeof(struct sSchedule));
+            self->hot->schedule = self;
 
-        if (self && knownScheduleControllers) {
             self->scheduleLn = schedLn;
             self->server = server;
             self->model = model;
-            self->enaReq = (DataObject*)enaReq;
-            self->dsaReq = (DataObject*)dsaReq;
-            self->schdSt = (DataObject*)schdSt;
-            self->val = (DataObject*)scheduleValue;
-            self->knownScheduleControllers = knownScheduleControllers;
-
-            self->evTrg = (DataObject*)ModelNode_getChild((ModelNode*)schedLn, "EvTrg");
-
-            if (self->evTrg) {
-                DataAttribute* inSyn_setSrcRef = (DataAttribute*)ModelNode_getChild((ModelNode*)schedLn, "InSyn.setSrcRef");
-
-                if (inSyn_setSrcRef == NULL) {
-                    printf("ERROR: Found EvTrg but InSyn.setSrcRef not present\n");
-                }
-            }
-
-            checkIfTimeTriggeredAndPeriodic(self);
-
             self->targetType = targetType;
+            self->hasOwnThread = ownThread;
 
-            IedServer_handleWriteAccess(self->server, schdPrio_setVal, schdPrio_writeAccessHandler, self);
-
-            if (schdResue_setVal) {
-                IedServer_handleWriteAccess(self->server, (DataAttribute*)schdResue_setVal, schdReuse_writeAccessHandler, self);
-            }
+            self->parameterLock = Semaphore_create(1);
 
-            schedule_installWriteAccessHandlersForStrTm(self);
+            CommandQueue_initialize(&(self->commands));
 
-            IedServer_setPerformCheckHandler(self->server, self->dsaReq, schedule_performCheckHandler, self);
-            IedServer_setPerformCheckHandler(self->server, self->enaReq, schedule_performCheckHandler, self);
+            self->eventFd = -1;
 
-            IedServer_setControlHandler(self->server, self->dsaReq, schedule_controlHandler, self);
-            IedServer_setControlHandler(self->server, self->enaReq, schedule_controlHandler, self);
+            if (schedule_bindDataModel(self, binding) == false) {
+                Schedule_destroy(self);
+                return NULL;
+            }
 
             schedule_setState(self, SCHD_STATE_NOT_READY);
 
             schedule_updateNxtStrTm(self, 0);
-
-            self->thread = Thread_create(schedule_thread, self, false);
-
-            self->alive = true;
+            schedule_updateActStrTm(self, 0);
 
             self->allowRemoteControl = true;
             self->allowWriteToSchdPrio = true;
             self->allowWriteToStrTm = true;
             self->allowWriteToSchdReuse = true;
 
-            Thread_start(self->thread);
-        }
-        else {
-            if (knownScheduleControllers)
-                LinkedList_destroyStatic(knownScheduleControllers);
-
-            if (self)
-                Schedule_destroy(self);
+            Schedule_resume(self);
         }
     }
 
@@ -1387,30 +2401,116 @@ Schedule_create(LogicalNode* schedLn, IedServer server, IedModel* model)
 }
 
 void
-Schedule_destroy(Schedule self)
+Schedule_suspend(Schedule self)
 {
-    if (self) {
+    if (self->thread) {
         self->alive = false;
+
         Thread_destroy(self->thread);
 
-        free(self);
+        self->thread = NULL;
     }
 }
 
-int
-Schedule_getPrio(Schedule self)
+void
+Schedule_resume(Schedule self)
 {
-    int prio = 0;
+    if (self->hasOwnThread && (self->thread == NULL)) {
+        self->thread = Thread_create(schedule_thread, self, false);
 
-    DataAttribute* schdPrio_setVal = (DataAttribute*)ModelNode_getChild((ModelNode*)self->scheduleLn, "SchdPrio.setVal");
+        if (self->thread) {
+            self->alive = true;
 
-    if (schdPrio_setVal) {
-        if (schdPrio_setVal->mmsValue && MmsValue_getType(schdPrio_setVal->mmsValue) == MMS_INTEGER) {
-            prio = MmsValue_toInt32(schdPrio_setVal->mmsValue);
+            Thread_start(self->thread);
         }
     }
+}
+
+bool
+Schedule_rebind(Schedule self, LogicalNode* schedLn, IedServer server, IedModel* model)
+{
+    /* take over the values (parameters, start times, status) of the old data model */
+    scheduler_copyDataModelValues(server, (ModelNode*)schedLn, (ModelNode*)self->scheduleLn);
+
+    Semaphore_wait(self->parameterLock);
+
+    /* tables in the arena are not reused (released with the arena) */
+    schedule_releaseTables(self);
+
+    self->numberOfStartTimes = 0;
+    self->numberOfSortedStartTimes = 0;
+    self->nextStartTimeIdx = 0;
+    self->numberOfScheduleValues = 0;
+
+    Semaphore_post(self->parameterLock);
+
+    self->scheduleLn = schedLn;
+    self->server = server;
+    self->model = model;
+
+    ScheduleBinding binding;
+
+    Schedule_resolveBinding(schedLn, &binding);
+
+    return schedule_bindDataModel(self, &binding);
+}
+
+void
+Schedule_destroy(Schedule self)
+{
+    if (self) {
+        self->alive = false;
+
+        if (self->thread)
+            Thread_destroy(self->thread);
+
+        /* don't leave callers waiting for a command that is never executed */
+        Schedule_cancelCommands(self);
+
+        if (self->parameterLock)
+            Semaphore_destroy(self->parameterLock);
+
+        schedule_releaseTables(self);
+
+        free(self->interpolationTable);
+        free(self->entryDurations);
+        free(self->entryEndOffsets);
 
-    return prio;
+        if (self->interpolatedValue)
+            MmsValue_delete(self->interpolatedValue);
+
+        if (self->hot->schedule == self)
+            self->hot->schedule = NULL;
+
+        if (self->arena == NULL)
+            free(self);
+    }
+}
+
+/**
+ * @brief Get the number of heap bytes used by the schedule outside of the scheduler arena
+ */
+size_t
+Schedule_getMemoryUsage(Schedule self)
+{
+    size_t size = 0;
+
+    if (self->arena == NULL) {
+        size += sizeof(struct sSchedule);
+        size += self->numberOfStartTimes * sizeof(ScheduleStartTime);
+        size += self->numberOfStartTimes * sizeof(uint64_t);
+        size += self->numberOfScheduleValues * sizeof(DataAttribute*);
+    }
+
+    size += 2 * self->interpolationTableSize * sizeof(double);
+
+    return size;
+}
+
+int
+Schedule_getPrio(Schedule self)
+{
+    return self->hot->prio;
 }
 
 bool
@@ -1430,19 +2530,58 @@ Schedule_enableScheduleControl(Schedule self, bool enable)
     self->allowRemoteControl = enable;
 }
 
+/**
+ * @brief Enable or disable the schedule
+ *
+ * The schedule state is only changed by the thread processing the schedule. When the caller is
+ * that thread (e.g. the caller of Scheduler_process in external mode) the command is executed
+ * directly. Otherwise the caller waits until the processing thread has executed the command
+ * (at most one cycle). Only the threads of the scheduler (e.g. in a target value handler) and
+ * callers with locked data model don't wait, because the processing thread could wait for them.
+ *
+ * @return true when the schedule was enabled/disabled, false when the schedule is not valid or
+ *         the command queue is full (when not waiting: true when the command was queued)
+ */
 bool
 Schedule_enableSchedule(Schedule self, bool enable)
 {
-    if (enable) {
-        return enabledSchedule(self);
+    SchedulerCommand command;
+
+    memset(&command, 0, sizeof(command));
+
+    command.type = enable ? SCHD_CMD_ENABLE : SCHD_CMD_DISABLE;
+
+    bool processingThread = (ownThreadSchedule == self) ||
+        ((self->hasOwnThread == false) && (scheduler_isSharedProcessingThread() || self->processedByApplication));
+
+    if (processingThread) {
+        /* keep the order of previously queued commands */
+        Schedule_executeCommands(self);
+
+        return schedule_enable(self, enable);
     }
-    else {
-        if (schedule_getState(self) != SCHD_STATE_NOT_READY) {
-            disableSchedule(self);
-        }
 
-        return true;
+    if (ownThreadSchedule || scheduler_isSharedProcessingThread() || scheduler_isDataModelLocked())
+        return Schedule_sendCommand(self, &command);
+
+    SchedulerCommandCompletion completion;
+
+    completion.done = Semaphore_create(0);
+    completion.result = false;
+
+    command.completion = &completion;
+
+    bool result = false;
+
+    if (Schedule_sendCommand(self, &command)) {
+        Semaphore_wait(completion.done);
+
+        result = completion.result;
     }
+
+    Semaphore_destroy(completion.done);
+
+    return result;
 }
 
 void
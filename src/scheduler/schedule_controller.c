@@ -1,6 +1,8 @@
 #include "der_scheduler_internal.h"
 
 #include <stdio.h>
+#include <string.h>
+#include <time.h>
 
 static void
 scheduleController_updateActSchdRef(ScheduleController self, Schedule schedule)
@@ -14,6 +16,18 @@ scheduleController_updateActSchdRef(ScheduleController self, Schedule schedule)
 
         //IedServer_lockDataModel(self->server);
 
+        if (self->scheduler->coalescedReporting) {
+            char objRefBuf[130];
+
+            const char* objRef = schedule ? ModelNode_getObjectReference((ModelNode*)schedule->scheduleLn, objRefBuf) : "";
+
+            Quality q = schedule ? QUALITY_VALIDITY_GOOD : QUALITY_VALIDITY_INVALID;
+
+            /* the active schedule didn't change -> nothing to report */
+            if ((strcmp(self->activeScheduleRef, objRef) == 0) && scheduler_isValueUnchanged(NULL, NULL, actSchdRef_q, q))
+                return;
+        }
+
         if (schedule) {
             if (actSchdRef_stVal) {
                 char objRefBuf[130];
@@ -21,6 +35,10 @@ scheduleController_updateActSchdRef(ScheduleController self, Schedule schedule)
                 char* objRef = ModelNode_getObjectReference((ModelNode*)schedule->scheduleLn, objRefBuf);
 
                 IedServer_updateVisibleStringAttributeValue(self->server, actSchdRef_stVal, objRef);
+
+                scheduler_beginSequenceWrite(&(self->outputSequence));
+                strncpy(self->activeScheduleRef, objRef, sizeof(self->activeScheduleRef) - 1);
+                scheduler_endSequenceWrite(&(self->outputSequence));
             }
 
             if (actSchdRef_q)
@@ -30,6 +48,10 @@ scheduleController_updateActSchdRef(ScheduleController self, Schedule schedule)
             if (actSchdRef_stVal)
                 IedServer_updateVisibleStringAttributeValue(self->server, actSchdRef_stVal, "");
 
+            scheduler_beginSequenceWrite(&(self->outputSequence));
+            self->activeScheduleRef[0] = 0;
+            scheduler_endSequenceWrite(&(self->outputSequence));
+
             if (actSchdRef_q)
                 IedServer_updateQuality(self->server, actSchdRef_q, QUALITY_VALIDITY_INVALID);
         }
@@ -46,89 +68,330 @@ scheduleController_updateActSchdRef(ScheduleController self, Schedule schedule)
     }
 }
 
+static bool
+scheduleController_containsSchedule(ScheduleController self, Schedule schedule)
+{
+    int i;
+
+    for (i = 0; i < self->numberOfSchedules; i++) {
+        if (self->schedules[i] == schedule)
+            return true;
+    }
+
+    return false;
+}
+
+static bool
+scheduleController_addSchedule(ScheduleController self, Schedule schedule)
+{
+    if (self->numberOfSchedules < self->maxSchedules) {
+        self->schedules[self->numberOfSchedules++] = schedule;
+        return true;
+    }
+    else {
+        return false;
+    }
+}
+
+static void
+scheduleController_removeSchedule(ScheduleController self, Schedule schedule)
+{
+    int i;
+
+    for (i = 0; i < self->numberOfSchedules; i++) {
+        if (self->schedules[i] == schedule) {
+            memmove(&(self->schedules[i]), &(self->schedules[i + 1]), (self->numberOfSchedules - i - 1) * sizeof(Schedule));
+            self->numberOfSchedules--;
+            break;
+        }
+    }
+}
+
 static Schedule
 scheduleController_getActiveSchedule(ScheduleController self)
 {
     Schedule activeSchedule = NULL;
 
-    LinkedList schedElem = LinkedList_getNext(self->schedules);
+    int i;
 
-    while (schedElem) {
-        Schedule schedule = (Schedule)LinkedList_getData(schedElem);
+    for (i = 0; i < self->numberOfSchedules; i++) {
+        Schedule schedule = self->schedules[i];
 
         if (Schedule_isRunning(schedule)) {
             if (activeSchedule == NULL) {
                 activeSchedule = schedule;
             }
             else {
-                if (Schedule_getPrio(schedule) > Schedule_getPrio(activeSchedule)) {
+                if (ScheduleCore_hasPrecedence(Schedule_getPrio(schedule), Schedule_getPrio(activeSchedule))) {
                     activeSchedule = schedule;
                 }
             }
         }
-
-        schedElem = LinkedList_getNext(schedElem);
     }
 
     return activeSchedule;
 }
 
 static void
-scheduleController_updateTargetValue(ScheduleController self, ScheduleTargetType targetType, MmsValue* val, uint64_t currentTime)
+scheduleController_getTargetAttributes(ScheduleController self, ScheduleTargetType targetType, DataAttribute** valueAttr, DataAttribute** qAttr, DataAttribute** tAttr)
 {
-    if (self->controlEntity) {
-
-        DataAttribute* valueAttr = NULL;
-        DataAttribute* qAttr = NULL;
-        DataAttribute* tAttr = NULL;
+    *valueAttr = NULL;
+    *qAttr = NULL;
+    *tAttr = NULL;
 
-        if (self->controlEntity->modelType == DataObjectModelType) {
+    if (self->controlEntity->modelType == DataObjectModelType) {
 
-            if (targetType == SCHD_TYPE_MV) {
-                ModelNode* mag_f = ModelNode_getChild(self->controlEntity, "mag.f");
-
-                if (mag_f) {
-                    valueAttr = (DataAttribute*)mag_f;
-                }
-                else {
-                    ModelNode* mag_i = ModelNode_getChild(self->controlEntity, "mag.i");
+        if (targetType == SCHD_TYPE_MV) {
+            ModelNode* mag_f = ModelNode_getChild(self->controlEntity, "mag.f");
 
-                    valueAttr = (DataAttribute*)mag_i;
-                }
-                //TODO handle instMag?
+            if (mag_f) {
+                *valueAttr = (DataAttribute*)mag_f;
             }
             else {
-                ModelNode* stVal = ModelNode_getChild(self->controlEntity, "stVal");
+                ModelNode* mag_i = ModelNode_getChild(self->controlEntity, "mag.i");
 
-                valueAttr = (DataAttribute*)stVal;
+                *valueAttr = (DataAttribute*)mag_i;
             }
+            //TODO handle instMag?
+        }
+        else {
+            ModelNode* stVal = ModelNode_getChild(self->controlEntity, "stVal");
 
-            tAttr = (DataAttribute*)ModelNode_getChild(self->controlEntity, "t");
-            qAttr = (DataAttribute*)ModelNode_getChild(self->controlEntity, "q");
+            *valueAttr = (DataAttribute*)stVal;
         }
-        else if (self->controlEntity->modelType == DataAttributeModelType) {
-            valueAttr = (DataAttribute*)self->controlEntity;
 
-            ModelNode* parent = ModelNode_getParent(self->controlEntity);
+        *tAttr = (DataAttribute*)ModelNode_getChild(self->controlEntity, "t");
+        *qAttr = (DataAttribute*)ModelNode_getChild(self->controlEntity, "q");
+    }
+    else if (self->controlEntity->modelType == DataAttributeModelType) {
+        *valueAttr = (DataAttribute*)self->controlEntity;
 
-            if (parent) {
-                if (parent->modelType != DataObjectModelType) {
-                    parent = ModelNode_getParent(parent);
-                }
+        ModelNode* parent = ModelNode_getParent(self->controlEntity);
 
-                if (parent->modelType == DataObjectModelType) {
-                    tAttr = (DataAttribute*)ModelNode_getChild(parent, "t");
-                    qAttr = (DataAttribute*)ModelNode_getChild(parent, "q");
-                }
+        if (parent) {
+            if (parent->modelType != DataObjectModelType) {
+                parent = ModelNode_getParent(parent);
+            }
+
+            if (parent->modelType == DataObjectModelType) {
+                *tAttr = (DataAttribute*)ModelNode_getChild(parent, "t");
+                *qAttr = (DataAttribute*)ModelNode_getChild(parent, "q");
             }
         }
+    }
+}
 
-        Quality q = QUALITY_VALIDITY_GOOD;
+/**
+ * @brief Apply the target value filter (has to be called inside the outputSequence write section)
+ * 
+ * @return true when the update has to be suppressed
+ */
+static bool
+scheduleController_filterOutput(ScheduleController self, ScheduleTargetType targetType, MmsValue* val, Quality q, uint64_t currentTime)
+{
+    if (self->hasFilter == false)
+        return false;
 
-        if (val == NULL) {
-            q = QUALITY_VALIDITY_INVALID;
+    Scheduler_TargetValueFilter* filter = &(self->filter);
+
+    double value = 0;
+    bool hasValue = val ? scheduler_getNumericValue(val, &value) : false;
+
+    /* quality changes and the first output are always sent */
+    if ((self->hasLastOutput == false) || (q != self->lastOutputQuality))
+        return false;
+
+    if (val && (hasValue == false))
+        return false;
+
+    if (hasValue && self->hasLastOutputValue) {
+        double diff = value - self->lastOutputValue;
+
+        if (diff < 0)
+            diff = -diff;
+
+        bool suppress = false;
+
+        if ((targetType == SCHD_TYPE_MV) && ((filter->absoluteDeadband > 0) || (filter->relativeDeadband > 0))) {
+            double lastValue = (self->lastOutputValue < 0) ? -self->lastOutputValue : self->lastOutputValue;
+
+            suppress = true;
+
+            if ((filter->absoluteDeadband > 0) && (diff >= filter->absoluteDeadband))
+                suppress = false;
+
+            if ((filter->relativeDeadband > 0) && (diff >= (filter->relativeDeadband * lastValue)))
+                suppress = false;
+        }
+        else if (filter->suppressEqualValues) {
+            suppress = (diff == 0);
+        }
+
+        if (suppress) {
+            /* the effective setpoint didn't change -> a value held back by the minimum interval is obsolete */
+            self->hasHeldOutput = false;
+            return true;
         }
+    }
+    else if (val == NULL) {
+        /* target is already invalid */
+        self->hasHeldOutput = false;
+        return true;
+    }
+
+    if ((filter->minUpdateIntervalInMs > 0) && (currentTime < (self->lastOutputTime + filter->minUpdateIntervalInMs))) {
+        /* sent by ScheduleController_processOutput when the interval expired */
+        /* keep a copy - the schedule changes its value while the update is held back */
+        if (self->heldValue && (MmsValue_getType(self->heldValue) != MmsValue_getType(val))) {
+            MmsValue_delete(self->heldValue);
+            self->heldValue = NULL;
+        }
+
+        if (self->heldValue)
+            MmsValue_update(self->heldValue, val);
+        else
+            self->heldValue = MmsValue_clone(val);
+
+        if (self->heldValue == NULL)
+            return false;
+
+        self->hasHeldOutput = true;
+        self->heldTargetType = targetType;
+        self->heldQuality = q;
+
+        return true;
+    }
+
+    return false;
+}
+
+/**
+ * @brief Start a ramp from the current output to the new target value (inside the outputSequence write section)
+ * 
+ * @return true when the output is generated by the ramp (ScheduleController_processOutput)
+ */
+static bool
+scheduleController_startRamp(ScheduleController self, ScheduleTargetType targetType, MmsValue* val, Quality q, uint64_t currentTime)
+{
+    bool softStart = self->softStartPending;
+
+    self->softStartPending = false;
+
+    if ((self->hasRamp == false) || (targetType != SCHD_TYPE_MV) || (val == NULL) || (q != QUALITY_VALIDITY_GOOD))
+        return false;
+
+    MmsType valueType = MmsValue_getType(val);
+
+    if ((valueType != MMS_FLOAT) && (valueType != MMS_INTEGER))
+        return false;
+
+    double targetValue;
+
+    scheduler_getNumericValue(val, &targetValue);
+
+    double rate = self->ramp.rampRate;
+
+    if (softStart && (self->ramp.softStartRampRate > 0))
+        rate = self->ramp.softStartRampRate;
+
+    if (rate <= 0)
+        return false;
+
+    double startValue;
+
+    if (self->rampActive)
+        startValue = self->rampCurrentValue;
+    else if (self->hasOutputValue && (self->outputQuality == QUALITY_VALIDITY_GOOD))
+        startValue = self->outputValue;
+    else if (softStart)
+        startValue = 0;
+    else
+        return false;
+
+    if (startValue == targetValue)
+        return false;
+
+    /* the ramp value keeps the type of the first ramped value */
+    if (self->rampValue == NULL) {
+        if (valueType == MMS_FLOAT)
+            self->rampValue = MmsValue_newFloat((float)startValue);
+        else
+            self->rampValue = MmsValue_newIntegerFromInt32((int32_t)startValue);
+
+        if (self->rampValue == NULL)
+            return false;
+    }
+    else if (MmsValue_getType(self->rampValue) != valueType) {
+        return false;
+    }
+
+    self->rampActive = true;
+    self->rampCurrentValue = startValue;
+    self->rampTargetValue = targetValue;
+    self->rampRatePerMs = rate / 1000.0;
+    self->lastRampTime = currentTime;
+
+    return true;
+}
+
+/**
+ * @brief Take a new (not filtered) target value as output (inside the outputSequence write section)
+ * 
+ * @return true when the value has to be written to the target now, false when it is generated by the ramp
+ */
+static bool
+scheduleController_acceptOutput(ScheduleController self, ScheduleTargetType targetType, MmsValue* val, Quality q, uint64_t currentTime)
+{
+    double outputValue = 0;
+    bool hasOutputValue = val ? scheduler_getNumericValue(val, &outputValue) : false;
+
+    /* the filter compares with the requested value - not with the intermediate values of the ramp */
+    self->hasLastOutput = true;
+    self->hasLastOutputValue = hasOutputValue;
+    self->lastOutputValue = outputValue;
+    self->lastOutputQuality = q;
+    self->lastOutputTime = currentTime;
+    self->hasHeldOutput = false;
+
+    if (scheduleController_startRamp(self, targetType, val, q, currentTime))
+        return false;
+
+    self->rampActive = false;
+
+    self->hasOutputValue = hasOutputValue;
+    self->outputValue = outputValue;
+    self->outputQuality = q;
+    self->outputTimestamp = currentTime;
+
+    return true;
+}
+
+/**
+ * @brief Get the source of the target value for the setpoint history
+ */
+static int
+scheduleController_getHistorySource(ScheduleController self)
+{
+    if (self->overrideActive)
+        return SCHED_HISTORY_SOURCE_OVERRIDE;
+
+    Schedule activeSchedule = self->activeSchedule;
+
+    /* the position in the schedule list is set when the controllers are initialized */
+    return activeSchedule ? activeSchedule->listIdx : SCHED_HISTORY_SOURCE_NONE;
+}
+
+static void
+scheduleController_writeTargetValue(ScheduleController self, ScheduleTargetType targetType, MmsValue* val, Quality q, uint64_t currentTime)
+{
+    DataAttribute* valueAttr;
+    DataAttribute* qAttr;
+    DataAttribute* tAttr;
+
+    scheduleController_getTargetAttributes(self, targetType, &valueAttr, &qAttr, &tAttr);
 
+    /* in coalesced reporting mode the target is only rewritten when value or quality changed */
+    if ((self->scheduler->coalescedReporting == false) || (scheduler_isValueUnchanged(valueAttr, val, qAttr, q) == false)) {
         if (tAttr) {
             IedServer_updateUTCTimeAttributeValue(self->server, tAttr, currentTime);
         }
@@ -141,10 +404,77 @@ scheduleController_updateTargetValue(ScheduleController self, ScheduleTargetType
             IedServer_updateAttributeValue(self->server, valueAttr, val);
         }
 
-        if (valueAttr) {
-            scheduler_targetValueChanged(self->scheduler, valueAttr, val, q, currentTime);
+        if (self->history) {
+            double numericValue = 0;
+
+            if (val)
+                scheduler_getNumericValue(val, &numericValue);
+
+            SetpointHistory_append(self->history, currentTime, numericValue, q, scheduleController_getHistorySource(self));
+        }
+    }
+
+    if (valueAttr) {
+        /* keep a copy - the written value can be changed by the schedule before the notification is sent */
+        if (self->pendingValue && ((val == NULL) || (MmsValue_getType(self->pendingValue) != MmsValue_getType(val)))) {
+            MmsValue_delete(self->pendingValue);
+            self->pendingValue = NULL;
+        }
+
+        if (val) {
+            if (self->pendingValue)
+                MmsValue_update(self->pendingValue, val);
+            else
+                self->pendingValue = MmsValue_clone(val);
+        }
+
+        self->pendingTargetAttr = valueAttr;
+        self->pendingQuality = q;
+        self->pendingTimestamp = currentTime;
+        __atomic_store_n(&(self->hasPendingNotification), true, __ATOMIC_RELEASE);
+
+        /* when called inside a coalesced data model update the schedule sends the notification after the update */
+        if (scheduler_isDataModelLocked() == false)
+            scheduleController_sendPendingNotification(self);
+    }
+}
+
+static void
+scheduleController_updateTargetValue(ScheduleController self, ScheduleTargetType targetType, MmsValue* val, uint64_t currentTime)
+{
+    if (self->controlEntity) {
+
+        Quality q = QUALITY_VALIDITY_GOOD;
+
+        if (val == NULL) {
+            q = QUALITY_VALIDITY_INVALID;
+        }
+
+        bool write = false;
+
+        /* the output sequence also serializes the filter and ramp state between schedule and scheduler threads */
+        scheduler_beginSequenceWrite(&(self->outputSequence));
+
+        /* an emergency override preempts the schedules (the output is updated again when the override ends) */
+        if (self->overrideActive == false) {
+            if (scheduleController_filterOutput(self, targetType, val, q, currentTime) == false)
+                write = scheduleController_acceptOutput(self, targetType, val, q, currentTime);
+        }
+
+        scheduler_endSequenceWrite(&(self->outputSequence));
+
+        if (write) {
+            scheduler_lockDataModel(self->server);
+
+            /* an override can be applied between the decision and the write */
+            if (__atomic_load_n(&(self->overrideActive), __ATOMIC_ACQUIRE) == false)
+                scheduleController_writeTargetValue(self, targetType, val, q, currentTime);
+
+            scheduler_unlockDataModel(self->server);
+
+            if (scheduler_isDataModelLocked() == false)
+                scheduleController_sendPendingNotification(self);
         }
-        
     }
 }
 
@@ -214,7 +544,14 @@ scheduleController_updateCurrentValue(ScheduleController self, ScheduleTargetTyp
         qAttr = (DataAttribute*)ModelNode_getChild((ModelNode*)valueObj, "q");
         tAttr = (DataAttribute*)ModelNode_getChild((ModelNode*)valueObj, "t");
 
-        IedServer_lockDataModel(self->server);
+        if (self->scheduler->coalescedReporting) {
+            Quality q = (valueAttr && val) ? QUALITY_VALIDITY_GOOD : QUALITY_VALIDITY_INVALID;
+
+            if (scheduler_isValueUnchanged(valueAttr, val, qAttr, q))
+                return;
+        }
+
+        scheduler_lockDataModel(self->server);
 
         if (valueAttr && val) {
             IedServer_updateAttributeValue(self->server, valueAttr, val);
@@ -226,7 +563,7 @@ scheduleController_updateCurrentValue(ScheduleController self, ScheduleTargetTyp
 
         if (tAttr) IedServer_updateUTCTimeAttributeValue(self->server, tAttr, currentTime);
 
-        IedServer_unlockDataModel(self->server);
+        scheduler_unlockDataModel(self->server);
     }
 
     return;
@@ -235,6 +572,60 @@ scheduleController_updateCurrentValue(ScheduleController self, ScheduleTargetTyp
 
 /* functions called by Schedule */
 
+/**
+ * @brief Call the target value handlers for the last target value update (if not already done)
+ * 
+ * Has to be called without locked data model.
+ * 
+ * @param self 
+ */
+void
+scheduleController_sendPendingNotification(ScheduleController self)
+{
+    if (__atomic_load_n(&(self->hasPendingNotification), __ATOMIC_ACQUIRE) == false)
+        return;
+
+    /* take the notification under the lock - another thread can write the target and send at the same time */
+    scheduler_lockDataModel(self->server);
+
+    bool hasNotification = self->hasPendingNotification;
+
+    DataAttribute* targetAttr = self->pendingTargetAttr;
+    MmsValue* value = self->pendingValue;
+    Quality quality = self->pendingQuality;
+    uint64_t timestamp = self->pendingTimestamp;
+
+    if (hasNotification) {
+        __atomic_store_n(&(self->hasPendingNotification), false, __ATOMIC_RELEASE);
+
+        /* the value is owned by this call until the handlers returned */
+        self->pendingValue = NULL;
+    }
+
+    scheduler_unlockDataModel(self->server);
+
+    if (hasNotification == false)
+        return;
+
+    scheduler_publishTargetValue(self->scheduler, self, targetAttr, value, quality, timestamp);
+    scheduler_targetValueChanged(self->scheduler, targetAttr, value, quality, timestamp);
+
+    if (value) {
+        scheduler_lockDataModel(self->server);
+
+        /* reuse the value for the next notification */
+        if (self->pendingValue == NULL) {
+            self->pendingValue = value;
+            value = NULL;
+        }
+
+        scheduler_unlockDataModel(self->server);
+
+        if (value)
+            MmsValue_delete(value);
+    }
+}
+
 /**
  * @brief Schedule informs the controller that its priority was updated
  * 
@@ -245,6 +636,13 @@ scheduleController_updateCurrentValue(ScheduleController self, ScheduleTargetTyp
 void
 scheduleController_schedulePrioUpdated(ScheduleController self, Schedule sched, int newPrio)
 {
+    if (__atomic_load_n(&(self->arbitrationSuspended), __ATOMIC_ACQUIRE) > 0) {
+        __atomic_store_n(&(self->arbitrationPending), true, __ATOMIC_RELEASE);
+        return;
+    }
+
+    scheduler_lockDataModel(self->server);
+
     Schedule activeSchedule = scheduleController_getActiveSchedule(self);
 
     if (activeSchedule) {
@@ -261,6 +659,8 @@ scheduleController_schedulePrioUpdated(ScheduleController self, Schedule sched,
         // there is no running schedule
         scheduleController_updateActSchdRef(self, NULL);
     }
+
+    scheduler_unlockDataModel(self->server);
 }
 
 /**
@@ -273,6 +673,15 @@ scheduleController_schedulePrioUpdated(ScheduleController self, Schedule sched,
 void
 scheduleController_scheduleStateUpdated(ScheduleController self, Schedule sched, ScheduleState newState)
 {
+    /* a group operation is in progress - select the active schedule when it is completed */
+    if (__atomic_load_n(&(self->arbitrationSuspended), __ATOMIC_ACQUIRE) > 0) {
+        __atomic_store_n(&(self->arbitrationPending), true, __ATOMIC_RELEASE);
+        return;
+    }
+
+    /* the schedules report from their own threads - the arbitration is serialized by the data model lock */
+    scheduler_lockDataModel(self->server);
+
     Schedule activeSchedule = scheduleController_getActiveSchedule(self);
 
     if (activeSchedule) {
@@ -281,12 +690,19 @@ scheduleController_scheduleStateUpdated(ScheduleController self, Schedule sched,
             printf("INFO: Active schedule changed %s -> %s\n", 
                 self->activeSchedule ? self->activeSchedule->scheduleLn->name : "", activeSchedule->scheduleLn->name);
             
+            /* a schedule becomes active while no schedule was active -> soft start ramp */
+            if (self->activeSchedule == NULL) {
+                scheduler_beginSequenceWrite(&(self->outputSequence));
+                self->softStartPending = true;
+                scheduler_endSequenceWrite(&(self->outputSequence));
+            }
+
             // change active schedule
             self->activeSchedule = activeSchedule;
 
             //TODO get current value from new running schedule
 
-            MmsValue* outputValue = Schedule_getCurrentValue(activeSchedule);
+            MmsValue* outputValue = Schedule_copyCurrentValue(activeSchedule, &(self->scheduleValue));
 
             scheduleController_updateActSchdRef(self, self->activeSchedule);
             scheduleController_updateCurrentValue(self, activeSchedule->targetType, outputValue, Hal_getTimeInMs());
@@ -300,6 +716,11 @@ scheduleController_scheduleStateUpdated(ScheduleController self, Schedule sched,
         scheduleController_updateTargetValue(self,  SCHD_TYPE_UNKNOWN, NULL, Hal_getTimeInMs());
         self->activeSchedule = NULL;
     }
+
+    scheduler_unlockDataModel(self->server);
+
+    if (scheduler_isDataModelLocked() == false)
+        scheduleController_sendPendingNotification(self);
 }
 /**
  * @brief Schedule informs the controller that its scheduled value was updated
@@ -310,6 +731,8 @@ scheduleController_scheduleStateUpdated(ScheduleController self, Schedule sched,
 void
 scheduleController_scheduleValueUpdated(ScheduleController self, Schedule sched, MmsValue* val, uint64_t timestamp)
 {
+    scheduler_lockDataModel(self->server);
+
     // check if the schedule is the actve schedule
 
     if (sched == self->activeSchedule) {
@@ -319,31 +742,554 @@ scheduleController_scheduleValueUpdated(ScheduleController self, Schedule sched,
     else {
         //ignore new value
     }
+
+    scheduler_unlockDataModel(self->server);
+
+    if (scheduler_isDataModelLocked() == false)
+        scheduleController_sendPendingNotification(self);
 }
 
 ScheduleController
 ScheduleController_create(LogicalNode* fsccLn, Scheduler scheduler)
 {
-    ScheduleController self = (ScheduleController)calloc(1, sizeof(struct sScheduleController));
+    int maxSchedules = 0;
+
+    DataObject* dObj = (DataObject*)fsccLn->firstChild;
+
+    while (dObj) {
+        if (scheduler_checkIfMultiObjInst(dObj->name, "Schd"))
+            maxSchedules++;
+
+        dObj = (DataObject*)dObj->sibling;
+    }
+
+    ScheduleController self = NULL;
+    Schedule* schedules = NULL;
+
+    if (scheduler->arena) {
+        self = (ScheduleController)MemoryArena_alloc(scheduler->arena, sizeof(struct sScheduleController));
+
+        if (maxSchedules > 0)
+            schedules = (Schedule*)MemoryArena_alloc(scheduler->arena, maxSchedules * sizeof(Schedule));
+    }
+    else {
+        self = (ScheduleController)calloc(1, sizeof(struct sScheduleController));
+
+        if (maxSchedules > 0)
+            schedules = (Schedule*)calloc(maxSchedules, sizeof(Schedule));
+    }
 
     if (self) {
         self->controllerLn = fsccLn;
         self->server = scheduler->server;
         self->model = scheduler->model;
         self->scheduler = scheduler;
-        self->schedules = LinkedList_create();
+        self->arena = scheduler->arena;
+        self->schedules = schedules;
+        self->maxSchedules = schedules ? maxSchedules : 0;
         self->controlEntity = NULL;
+        self->shmSlot = -1;
+    }
+    else if (scheduler->arena == NULL) {
+        free(schedules);
     }
 
     return self;
 }
 
+void
+ScheduleController_rebind(ScheduleController self, LogicalNode* fsccLn)
+{
+    /* take over the values (schedule references, control entity, status) of the old data model */
+    scheduler_copyDataModelValues(self->scheduler->server, (ModelNode*)fsccLn, (ModelNode*)self->controllerLn);
+
+    self->controllerLn = fsccLn;
+    self->server = self->scheduler->server;
+    self->model = self->scheduler->model;
+    self->controlEntity = NULL;
+
+    /* held back value may refer to the old data model */
+    self->hasHeldOutput = false;
+    self->rampActive = false;
+
+    /* the schedule table is filled again by ScheduleController_initialize (same number of SchdXX objects) */
+    self->numberOfSchedules = 0;
+}
+
+/**
+ * @brief Select the active schedule again after the schedule list was recreated
+ * 
+ * The target value is only updated when the active schedule changed.
+ * 
+ * @param activeScheduleRemoved true when the previously active schedule was removed
+ */
+void
+ScheduleController_updateActiveSchedule(ScheduleController self, bool activeScheduleRemoved)
+{
+    scheduler_lockDataModel(self->server);
+
+    if (activeScheduleRemoved) {
+        self->activeSchedule = NULL;
+        scheduleController_scheduleStateUpdated(self, NULL, SCHD_STATE_INVALID);
+    }
+    else if (scheduleController_getActiveSchedule(self) != self->activeSchedule) {
+        scheduleController_scheduleStateUpdated(self, NULL, SCHD_STATE_INVALID);
+    }
+
+    scheduler_unlockDataModel(self->server);
+
+    if (scheduler_isDataModelLocked() == false)
+        scheduleController_sendPendingNotification(self);
+}
+
+/**
+ * @brief Defer the selection of the active schedule (nested calls are allowed)
+ */
+void
+ScheduleController_suspendArbitration(ScheduleController self)
+{
+    __atomic_add_fetch(&(self->arbitrationSuspended), 1, __ATOMIC_ACQ_REL);
+}
+
+/**
+ * @brief End a ScheduleController_suspendArbitration and select the active schedule when a schedule changed
+ */
+void
+ScheduleController_resumeArbitration(ScheduleController self)
+{
+    if (__atomic_sub_fetch(&(self->arbitrationSuspended), 1, __ATOMIC_ACQ_REL) == 0) {
+        if (__atomic_exchange_n(&(self->arbitrationPending), false, __ATOMIC_ACQ_REL))
+            scheduleController_scheduleStateUpdated(self, NULL, SCHD_STATE_INVALID);
+    }
+}
+
+/**
+ * @brief Set the target value filter (NULL to disable filtering)
+ */
+void
+ScheduleController_setTargetValueFilter(ScheduleController self, const Scheduler_TargetValueFilter* filter)
+{
+    scheduler_beginSequenceWrite(&(self->outputSequence));
+
+    if (filter) {
+        self->filter = *filter;
+        self->hasFilter = true;
+    }
+    else {
+        self->hasFilter = false;
+    }
+
+    scheduler_endSequenceWrite(&(self->outputSequence));
+
+    /* send a held back value immediately */
+    if (filter == NULL)
+        ScheduleController_processOutput(self, Hal_getTimeInMs());
+}
+
+/**
+ * @brief Set the ramp rate limitation of the target value (NULL to disable)
+ */
+void
+ScheduleController_setRamp(ScheduleController self, const Scheduler_RampConfig* ramp)
+{
+    scheduler_beginSequenceWrite(&(self->outputSequence));
+
+    if (ramp) {
+        self->ramp = *ramp;
+        self->hasRamp = true;
+    }
+    else {
+        self->hasRamp = false;
+
+        /* jump to the target value with the next call of ScheduleController_processOutput */
+        self->rampRatePerMs = 0;
+    }
+
+    scheduler_endSequenceWrite(&(self->outputSequence));
+}
+
+/**
+ * @brief Periodic output processing - called by the scheduler thread
+ * 
+ * Sends a target value that was held back by the minimum update interval and the intermediate
+ * values of an active ramp.
+ */
+void
+ScheduleController_processOutput(ScheduleController self, uint64_t currentTime)
+{
+    if (self->overrideActive && self->overrideExpiryTime && (currentTime >= self->overrideExpiryTime)) {
+        printf("INFO: Emergency override of %s expired\n", self->controllerLn->name);
+
+        ScheduleController_clearOverride(self);
+    }
+
+    if ((self->hasHeldOutput == false) && (self->rampActive == false))
+        return;
+
+    bool write = false;
+
+    ScheduleTargetType targetType = SCHD_TYPE_UNKNOWN;
+    MmsValue* val = NULL;
+    Quality q = QUALITY_VALIDITY_INVALID;
+
+    scheduler_beginSequenceWrite(&(self->outputSequence));
+
+    if (self->hasHeldOutput) {
+        if ((self->hasFilter == false) || (currentTime >= (self->lastOutputTime + self->filter.minUpdateIntervalInMs))) {
+            targetType = self->heldTargetType;
+            val = self->heldValue;
+            q = self->heldQuality;
+
+            write = scheduleController_acceptOutput(self, targetType, val, q, currentTime);
+        }
+    }
+
+    if (self->rampActive) {
+        int updateInterval = self->hasRamp ? self->ramp.updateIntervalInMs : 0;
+
+        if ((currentTime > self->lastRampTime) && (currentTime >= (self->lastRampTime + updateInterval))) {
+            double step = self->rampRatePerMs * (double)(currentTime - self->lastRampTime);
+            double diff = self->rampTargetValue - self->rampCurrentValue;
+
+            /* rate 0 -> ramp was disabled */
+            if ((self->rampRatePerMs <= 0) || (((diff < 0) ? -diff : diff) <= step)) {
+                self->rampCurrentValue = self->rampTargetValue;
+                self->rampActive = false;
+            }
+            else {
+                self->rampCurrentValue += (diff < 0) ? -step : step;
+            }
+
+            self->lastRampTime = currentTime;
+
+            if (MmsValue_getType(self->rampValue) == MMS_FLOAT)
+                MmsValue_setFloat(self->rampValue, (float)self->rampCurrentValue);
+            else
+                MmsValue_setInt32(self->rampValue, (int32_t)(self->rampCurrentValue + ((self->rampCurrentValue < 0) ? -0.5 : 0.5)));
+
+            self->hasOutputValue = true;
+            self->outputValue = self->rampCurrentValue;
+            self->outputQuality = QUALITY_VALIDITY_GOOD;
+            self->outputTimestamp = currentTime;
+
+            targetType = SCHD_TYPE_MV;
+            val = self->rampValue;
+            q = QUALITY_VALIDITY_GOOD;
+
+            write = true;
+        }
+    }
+
+    scheduler_endSequenceWrite(&(self->outputSequence));
+
+    if (write && self->controlEntity) {
+        scheduler_lockDataModel(self->server);
+
+        if (__atomic_load_n(&(self->overrideActive), __ATOMIC_ACQUIRE) == false)
+            scheduleController_writeTargetValue(self, targetType, val, q, currentTime);
+
+        scheduler_unlockDataModel(self->server);
+
+        scheduleController_sendPendingNotification(self);
+    }
+}
+
+/**
+ * @brief Get the time when ScheduleController_processOutput has something to do
+ * 
+ * @return the time in ms since epoch or 0 when there is no held back value and no active ramp
+ */
+uint64_t
+ScheduleController_getNextDeadline(ScheduleController self)
+{
+    uint64_t deadline = 0;
+
+    if (self->hasHeldOutput)
+        deadline = self->lastOutputTime + (self->hasFilter ? self->filter.minUpdateIntervalInMs : 0);
+
+    if (self->rampActive) {
+        int updateInterval = self->hasRamp ? self->ramp.updateIntervalInMs : 0;
+
+        /* at least 1 ms - ScheduleController_processOutput doesn't create a new value for the same time */
+        uint64_t rampDeadline = self->lastRampTime + ((updateInterval > 0) ? updateInterval : 1);
+
+        if ((deadline == 0) || (rampDeadline < deadline))
+            deadline = rampDeadline;
+    }
+
+    if (self->overrideActive && self->overrideExpiryTime) {
+        if ((deadline == 0) || (self->overrideExpiryTime < deadline))
+            deadline = self->overrideExpiryTime;
+    }
+
+    return deadline;
+}
+
+static uint64_t
+scheduleController_getMonotonicTimeInUs(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ((uint64_t)ts.tv_sec * 1000000) + (ts.tv_nsec / 1000);
+}
+
+/**
+ * @brief Prepare the MmsValue for an override with the type of the target value
+ * 
+ * @return the target type or SCHD_TYPE_UNKNOWN when the target has no suitable value attribute
+ */
+static ScheduleTargetType
+scheduleController_prepareOverrideValue(ScheduleController self, double value)
+{
+    DataAttribute* valueAttr;
+    DataAttribute* qAttr;
+    DataAttribute* tAttr;
+
+    ScheduleTargetType targetType = SCHD_TYPE_MV;
+
+    scheduleController_getTargetAttributes(self, targetType, &valueAttr, &qAttr, &tAttr);
+
+    if (valueAttr == NULL) {
+        /* stVal for INS, ENS and SPS targets */
+        targetType = SCHD_TYPE_INS;
+
+        scheduleController_getTargetAttributes(self, targetType, &valueAttr, &qAttr, &tAttr);
+    }
+
+    if ((valueAttr == NULL) || (valueAttr->mmsValue == NULL))
+        return SCHD_TYPE_UNKNOWN;
+
+    MmsType valueType = MmsValue_getType(valueAttr->mmsValue);
+
+    if (self->overrideMmsValue && (MmsValue_getType(self->overrideMmsValue) != valueType)) {
+        MmsValue_delete(self->overrideMmsValue);
+        self->overrideMmsValue = NULL;
+    }
+
+    switch (valueType) {
+    case MMS_FLOAT:
+        if (self->overrideMmsValue == NULL)
+            self->overrideMmsValue = MmsValue_newFloat(0.f);
+
+        if (self->overrideMmsValue)
+            MmsValue_setFloat(self->overrideMmsValue, (float)value);
+        break;
+
+    case MMS_INTEGER:
+        if (self->overrideMmsValue == NULL)
+            self->overrideMmsValue = MmsValue_newIntegerFromInt32(0);
+
+        if (self->overrideMmsValue)
+            MmsValue_setInt32(self->overrideMmsValue, (int32_t)(value + ((value < 0) ? -0.5 : 0.5)));
+        break;
+
+    case MMS_BOOLEAN:
+        if (self->overrideMmsValue == NULL)
+            self->overrideMmsValue = MmsValue_newBoolean(false);
+
+        if (self->overrideMmsValue)
+            MmsValue_setBoolean(self->overrideMmsValue, (value != 0));
+        break;
+
+    default:
+        printf("WARN: Emergency override is not supported for the target of %s\n", self->controllerLn->name);
+        return SCHD_TYPE_UNKNOWN;
+    }
+
+    return self->overrideMmsValue ? targetType : SCHD_TYPE_UNKNOWN;
+}
+
+/**
+ * @brief Apply an emergency override (written to the target by the calling thread)
+ * 
+ * @param durationInMs duration of the override or 0 for an override until ScheduleController_clearOverride
+ */
+bool
+ScheduleController_setOverride(ScheduleController self, double value, int durationInMs)
+{
+    uint64_t requestTime = scheduleController_getMonotonicTimeInUs();
+
+    if (self->controlEntity == NULL) {
+        printf("WARN: Schedule controller %s has no target for the emergency override\n", self->controllerLn->name);
+        return false;
+    }
+
+    uint64_t currentTime = Hal_getTimeInMs();
+
+    /* the data model lock also serializes concurrent overrides (overrideMmsValue is written to the target) */
+    scheduler_lockDataModel(self->server);
+
+    scheduler_beginSequenceWrite(&(self->outputSequence));
+
+    ScheduleTargetType targetType = scheduleController_prepareOverrideValue(self, value);
+
+    if (targetType != SCHD_TYPE_UNKNOWN) {
+        __atomic_store_n(&(self->overrideActive), true, __ATOMIC_RELEASE);
+
+        self->overrideValue = value;
+        self->overrideExpiryTime = (durationInMs > 0) ? (currentTime + durationInMs) : 0;
+
+        /* held back values and ramps of the schedule output are obsolete */
+        self->hasHeldOutput = false;
+        self->rampActive = false;
+
+        /* the ramp and the filter continue from the override value when the override ends */
+        self->hasLastOutput = true;
+        self->hasLastOutputValue = true;
+        self->lastOutputValue = value;
+        self->lastOutputQuality = QUALITY_VALIDITY_GOOD;
+        self->lastOutputTime = currentTime;
+
+        self->hasOutputValue = true;
+        self->outputValue = value;
+        self->outputQuality = QUALITY_VALIDITY_GOOD;
+        self->outputTimestamp = currentTime;
+    }
+
+    scheduler_endSequenceWrite(&(self->outputSequence));
+
+    if (targetType == SCHD_TYPE_UNKNOWN) {
+        scheduler_unlockDataModel(self->server);
+        return false;
+    }
+
+    scheduleController_writeTargetValue(self, targetType, self->overrideMmsValue, QUALITY_VALIDITY_GOOD, currentTime);
+
+    scheduler_unlockDataModel(self->server);
+
+    scheduleController_sendPendingNotification(self);
+
+    uint64_t latency = scheduleController_getMonotonicTimeInUs() - requestTime;
+
+    bool violation = (self->scheduler->overrideLatencyLimitInUs > 0) && (latency > (uint64_t)self->scheduler->overrideLatencyLimitInUs);
+
+    /* statistics are read together with the override state (ScheduleController_getOverrideStatus) */
+    scheduler_beginSequenceWrite(&(self->outputSequence));
+
+    self->numberOfOverrides++;
+    self->lastOverrideLatencyInUs = (uint32_t)latency;
+
+    if (latency > self->maxOverrideLatencyInUs)
+        self->maxOverrideLatencyInUs = (uint32_t)latency;
+
+    if (violation)
+        self->overrideLatencyViolations++;
+
+    scheduler_endSequenceWrite(&(self->outputSequence));
+
+    if (violation) {
+        printf("WARN: Emergency override of %s applied after %llu us (limit %i us)\n", self->controllerLn->name,
+            (unsigned long long)latency, self->scheduler->overrideLatencyLimitInUs);
+    }
+    else {
+        printf("INFO: Emergency override of %s applied after %llu us\n", self->controllerLn->name, (unsigned long long)latency);
+    }
+
+    return true;
+}
+
+/**
+ * @brief End the emergency override and set the target value to the value of the active schedule
+ */
+void
+ScheduleController_clearOverride(ScheduleController self)
+{
+    scheduler_beginSequenceWrite(&(self->outputSequence));
+
+    bool wasActive = self->overrideActive;
+
+    __atomic_store_n(&(self->overrideActive), false, __ATOMIC_RELEASE);
+    self->overrideExpiryTime = 0;
+
+    scheduler_endSequenceWrite(&(self->outputSequence));
+
+    if (wasActive) {
+        scheduler_lockDataModel(self->server);
+
+        Schedule activeSchedule = self->activeSchedule;
+
+        if (activeSchedule)
+            scheduleController_updateTargetValue(self, activeSchedule->targetType, Schedule_copyCurrentValue(activeSchedule, &(self->scheduleValue)), Hal_getTimeInMs());
+        else
+            scheduleController_updateTargetValue(self, SCHD_TYPE_UNKNOWN, NULL, Hal_getTimeInMs());
+
+        scheduler_unlockDataModel(self->server);
+
+        if (scheduler_isDataModelLocked() == false)
+            scheduleController_sendPendingNotification(self);
+    }
+}
+
+void
+ScheduleController_getOverrideStatus(ScheduleController self, Scheduler_OverrideStatus* status)
+{
+    uint32_t seq;
+
+    do {
+        seq = scheduler_beginSequenceRead(&(self->outputSequence));
+
+        status->active = self->overrideActive;
+        status->value = self->overrideValue;
+        status->expiryTime = self->overrideExpiryTime;
+        status->numberOfOverrides = self->numberOfOverrides;
+        status->latencyViolations = self->overrideLatencyViolations;
+        status->lastApplyLatencyInUs = self->lastOverrideLatencyInUs;
+        status->maxApplyLatencyInUs = self->maxOverrideLatencyInUs;
+
+    } while (scheduler_retrySequenceRead(&(self->outputSequence), seq));
+}
+
+/**
+ * @brief Get the number of heap bytes used by the schedule controller
+ */
+size_t
+ScheduleController_getMemoryUsage(ScheduleController self)
+{
+    if (self->arena)
+        return 0;
+    else
+        return sizeof(struct sScheduleController) + (self->maxSchedules * sizeof(Schedule));
+}
+
 void
 ScheduleController_destroy(ScheduleController self)
 {
-    if (self) {
+    if (self && self->rampValue) {
+        MmsValue_delete(self->rampValue);
+        self->rampValue = NULL;
+    }
+
+    if (self && self->overrideMmsValue) {
+        MmsValue_delete(self->overrideMmsValue);
+        self->overrideMmsValue = NULL;
+    }
+
+    if (self && self->heldValue) {
+        MmsValue_delete(self->heldValue);
+        self->heldValue = NULL;
+    }
+
+    if (self && self->scheduleValue) {
+        MmsValue_delete(self->scheduleValue);
+        self->scheduleValue = NULL;
+    }
+
+    if (self && self->pendingValue) {
+        MmsValue_delete(self->pendingValue);
+        self->pendingValue = NULL;
+    }
 
-        LinkedList_destroyStatic(self->schedules);
+    if (self && self->history) {
+        SetpointHistory_destroy(self->history);
+        self->history = NULL;
+    }
+
+    /* instances in the arena are released with the arena */
+    if (self && (self->arena == NULL)) {
+
+        free(self->schedules);
 
         free(self);
     }
@@ -356,15 +1302,17 @@ scheduleController_lookUpTargetObject(ScheduleController self, const char* targe
 
     if (targetRef && targetRef[0] != 0) {
 
-        bool withoutIedName = false;
-
+        /* CtlEnt values are resolved as short references with and without leading "@" */
         if (targetRef[0] == '@') {
-            withoutIedName = true;
             targetRef = targetRef + 1;
         }
 
         ModelNode* targetNode = IedModel_getModelNodeByShortObjectReference(self->model, targetRef);
 
+        if (targetNode == NULL) {
+            printf("WARN: Control entity %s not found\n", targetRef);
+            return NULL;
+        }
 
         if (targetNode->modelType == DataObjectModelType) {
             //TODO check for stVal or mxVal
@@ -429,34 +1377,80 @@ schd_setSrcRef_writeAccessHandler(DataAttribute* dataAttribute, MmsValue* value,
         return DATA_ACCESS_ERROR_OBJECT_VALUE_INVALID;
     }
 
-    if (LinkedList_contains(self->schedules, sched)) {
+    if (scheduleController_containsSchedule(self, sched)) {
         printf("ERROR: schedule %s already conntected with schedule controller\n", scheduleRef);
         return DATA_ACCESS_ERROR_OBJECT_VALUE_INVALID;
     }
 
+    Schedule oldSchedule = NULL;
+
     if (dataAttribute->mmsValue) {
         const char* oldScheduleRef = MmsValue_toString(dataAttribute->mmsValue);
 
-        Schedule oldSchedule = Scheduler_getScheduleByObjRef(self->scheduler, oldScheduleRef);
+        oldSchedule = Scheduler_getScheduleByObjRef(self->scheduler, oldScheduleRef);
+
+        if (oldSchedule && (scheduleController_containsSchedule(self, oldSchedule) == false))
+            oldSchedule = NULL;
+    }
 
-        if (oldSchedule) {
-            printf("WARNING: disconnect schedule %s from schedule controller\n", oldScheduleRef);
+    if ((oldSchedule == NULL) && (self->numberOfSchedules >= self->maxSchedules)) {
+        printf("ERROR: schedule controller cannot reference more schedules\n");
+        return DATA_ACCESS_ERROR_OBJECT_VALUE_INVALID;
+    }
 
-            //TODO how to handle the situation when multiple Schd have the same reference?
+    /* the schedule table is changed by the thread processing the new schedule */
+    SchedulerCommand command;
 
-            //TODO remove listener??? (or remove automatically when called from unknown schedule?)
+    memset(&command, 0, sizeof(command));
 
-            LinkedList_remove(self->schedules, oldSchedule);
-        }
+    command.type = SCHD_CMD_CONNECT_CONTROLLER;
+    command.controller = self;
+    command.oldSchedule = oldSchedule;
+
+    if (Schedule_sendCommand(sched, &command) == false) {
+        printf("WARN: Command queue of schedule %s is full\n", scheduleRef);
+        return DATA_ACCESS_ERROR_TEMPORARILY_UNAVAILABLE;
     }
 
-    printf("INFO: connect schedule %s to schedule controller\n", scheduleRef);
+    return DATA_ACCESS_ERROR_SUCCESS;
+}
+
+/**
+ * @brief Replace oldSchedule (can be NULL) by schedule in the schedule table (called by the thread processing schedule)
+ */
+void
+scheduleController_connectSchedule(ScheduleController self, Schedule schedule, Schedule oldSchedule)
+{
+    /* the schedule table is also read by the threads of the other schedules */
+    scheduler_lockDataModel(self->server);
 
-    LinkedList_add(self->schedules, sched);
+    if (scheduleController_containsSchedule(self, schedule)) {
+        scheduler_unlockDataModel(self->server);
+        return;
+    }
 
-    Schedule_setListeningController(sched, self);
-    
-    return DATA_ACCESS_ERROR_SUCCESS;
+    if (oldSchedule) {
+        printf("WARNING: disconnect schedule %s from schedule controller\n", oldSchedule->scheduleLn->name);
+
+        //TODO how to handle the situation when multiple Schd have the same reference?
+
+        //TODO remove listener??? (or remove automatically when called from unknown schedule?)
+
+        scheduleController_removeSchedule(self, oldSchedule);
+    }
+
+    printf("INFO: connect schedule %s to schedule controller\n", schedule->scheduleLn->name);
+
+    bool added = scheduleController_addSchedule(self, schedule);
+
+    scheduler_unlockDataModel(self->server);
+
+    if (added == false) {
+        printf("ERROR: schedule controller cannot reference more schedules\n");
+        return;
+    }
+
+    Schedule_setListeningController(schedule, self);
 }
 
 void
@@ -464,12 +1458,9 @@ ScheduleController_initialize(ScheduleController self)
 {
     /* create list of referenced (known) schedules */
 
-    LinkedList dataObjects = ModelNode_getChildren((ModelNode*)self->controllerLn);
-
-    LinkedList doElem = LinkedList_getNext(dataObjects);
+    DataObject* dObj = (DataObject*)self->controllerLn->firstChild;
 
-    while (doElem) {
-        DataObject* dObj = (DataObject*)LinkedList_getData(doElem);
+    while (dObj) {
 
         if (scheduler_checkIfMultiObjInst(dObj->name, "Schd")) {
             DataAttribute* schd_setSrcRef = (DataAttribute*)ModelNode_getChild((ModelNode*)dObj, "setSrcRef");
@@ -484,11 +1475,18 @@ ScheduleController_initialize(ScheduleController self)
 
                         Schedule sched = Scheduler_getScheduleByObjRef(self->scheduler, scheduleRef);
 
-                        printf("INFO:       -> schedule found\n");
+                        if (sched) {
+                            printf("INFO:       -> schedule found\n");
 
-                        LinkedList_add(self->schedules, sched);
+                            scheduler_lockDataModel(self->server);
+                            scheduleController_addSchedule(self, sched);
+                            scheduler_unlockDataModel(self->server);
 
-                        Schedule_setListeningController(sched, self);
+                            Schedule_setListeningController(sched, self);
+                        }
+                        else {
+                            printf("ERROR: schedule %s not found\n", scheduleRef);
+                        }
                     }
 
                     IedServer_handleWriteAccess(self->server, schd_setSrcRef, schd_setSrcRef_writeAccessHandler, self);
@@ -530,14 +1528,16 @@ ScheduleController_initialize(ScheduleController self)
             }
         }
 
-        doElem = LinkedList_getNext(doElem);
+        dObj = (DataObject*)dObj->sibling;
     }
 
-    LinkedList_destroyStatic(dataObjects);
-
     /* initialized ActSchdRef */
 
+    scheduler_lockDataModel(self->server);
+
     Schedule activeSchedule = scheduleController_getActiveSchedule(self);
     scheduleController_updateActSchdRef(self, activeSchedule);
+
+    scheduler_unlockDataModel(self->server);
 }
 
@@ -0,0 +1,250 @@
+#include "schedule_core.h"
+
+#include <stddef.h>
+
+void
+ScheduleCore_initialize(ScheduleCore* self)
+{
+    self->state = SCHEDULE_CORE_STATE_NOT_READY;
+    self->currentEntryIdx = -1;
+    self->startTime = 0;
+    self->nextStartTime = 0;
+    self->nextStartTimeIdx = 0;
+    self->value = 0;
+}
+
+int
+ScheduleCore_getEntryIndex(uint64_t startTime, int intervalInMs, int numberOfEntries, uint64_t currentTime)
+{
+    if ((intervalInMs <= 0) || (currentTime < startTime))
+        return -1;
+
+    uint64_t idx = (currentTime - startTime) / (uint64_t)intervalInMs;
+
+    if (idx >= (uint64_t)numberOfEntries)
+        return -1;
+
+    return (int)idx;
+}
+
+static bool
+scheduleCore_entryContains(const uint64_t* entryEndOffsets, int idx, uint64_t offset)
+{
+    uint64_t entryStart = (idx > 0) ? entryEndOffsets[idx - 1] : 0;
+
+    return (offset >= entryStart) && (offset < entryEndOffsets[idx]);
+}
+
+int
+ScheduleCore_findEntryIndex(const uint64_t* entryEndOffsets, int numberOfEntries, uint64_t offset, int* cursor)
+{
+    if ((numberOfEntries <= 0) || (offset >= entryEndOffsets[numberOfEntries - 1]))
+        return -1;
+
+    int idx = -1;
+
+    if (cursor && (*cursor >= 0) && (*cursor < numberOfEntries)) {
+        if (scheduleCore_entryContains(entryEndOffsets, *cursor, offset))
+            idx = *cursor;
+        else if ((*cursor + 1 < numberOfEntries) && scheduleCore_entryContains(entryEndOffsets, *cursor + 1, offset))
+            idx = *cursor + 1;
+    }
+
+    if (idx == -1) {
+        /* first entry that ends after offset */
+        int low = 0;
+        int high = numberOfEntries - 1;
+
+        while (low < high) {
+            int mid = low + (high - low) / 2;
+
+            if (entryEndOffsets[mid] > offset)
+                high = mid;
+            else
+                low = mid + 1;
+        }
+
+        idx = low;
+    }
+
+    if (cursor)
+        *cursor = idx;
+
+    return idx;
+}
+
+static int
+scheduleCore_getEntryIndex(ScheduleCore* self, uint64_t currentTime)
+{
+    if (self->entryEndOffsets) {
+        if (currentTime < self->startTime)
+            return -1;
+
+        int cursor = self->currentEntryIdx;
+
+        return ScheduleCore_findEntryIndex(self->entryEndOffsets, self->numberOfValues, currentTime - self->startTime, &cursor);
+    }
+    else {
+        return ScheduleCore_getEntryIndex(self->startTime, self->intervalInMs, self->numberOfValues, currentTime);
+    }
+}
+
+uint64_t
+ScheduleCore_findNextStartTime(const uint64_t* startTimes, int numberOfStartTimes, int* cursor, uint64_t currentTime)
+{
+    /* start times before the cursor were already in the past at the last lookup */
+    while ((*cursor < numberOfStartTimes) && (startTimes[*cursor] <= currentTime)) {
+        (*cursor)++;
+    }
+
+    if (*cursor < numberOfStartTimes)
+        return startTimes[*cursor];
+    else
+        return 0;
+}
+
+bool
+ScheduleCore_hasPrecedence(int prio, int activePrio)
+{
+    /* with equal priority the active schedule stays active */
+    return (prio > activePrio);
+}
+
+bool
+ScheduleCore_enable(ScheduleCore* self, uint64_t currentTime)
+{
+    self->currentEntryIdx = -1;
+
+    if (self->compressedValues)
+        self->numberOfValues = ScheduleRleReader_getNumberOfValues(self->compressedValues);
+
+    if ((self->numberOfValues <= 0) || ((self->values == NULL) && (self->compressedValues == NULL)) ||
+        ((self->intervalInMs <= 0) && (self->entryEndOffsets == NULL)))
+    {
+        self->state = SCHEDULE_CORE_STATE_NOT_READY;
+        return false;
+    }
+
+    self->nextStartTimeIdx = 0;
+    self->nextStartTime = ScheduleCore_findNextStartTime(self->startTimes, self->numberOfStartTimes, &(self->nextStartTimeIdx), currentTime);
+
+    if (self->nextStartTime == 0) {
+        self->state = SCHEDULE_CORE_STATE_START_TIME_REQUIRED;
+        return false;
+    }
+
+    self->state = SCHEDULE_CORE_STATE_READY;
+
+    return true;
+}
+
+void
+ScheduleCore_disable(ScheduleCore* self)
+{
+    self->state = SCHEDULE_CORE_STATE_NOT_READY;
+    self->currentEntryIdx = -1;
+    self->nextStartTime = 0;
+}
+
+ScheduleCoreEvent
+ScheduleCore_process(ScheduleCore* self, uint64_t currentTime)
+{
+    if (self->state == SCHEDULE_CORE_STATE_READY) {
+
+        if ((self->nextStartTime != 0) && (currentTime > self->nextStartTime)) {
+            self->startTime = self->nextStartTime;
+            self->currentEntryIdx = -1;
+
+            self->nextStartTime = ScheduleCore_findNextStartTime(self->startTimes, self->numberOfStartTimes, &(self->nextStartTimeIdx), currentTime);
+
+            self->state = SCHEDULE_CORE_STATE_RUNNING;
+
+            return SCHEDULE_CORE_EVENT_STARTED;
+        }
+    }
+    else if (self->state == SCHEDULE_CORE_STATE_RUNNING) {
+
+        int idx = scheduleCore_getEntryIndex(self, currentTime);
+
+        if (idx == -1) {
+            self->currentEntryIdx = -1;
+
+            self->nextStartTime = ScheduleCore_findNextStartTime(self->startTimes, self->numberOfStartTimes, &(self->nextStartTimeIdx), currentTime);
+
+            if (self->nextStartTime)
+                self->state = SCHEDULE_CORE_STATE_READY;
+            else
+                self->state = SCHEDULE_CORE_STATE_NOT_READY;
+
+            return SCHEDULE_CORE_EVENT_ENDED;
+        }
+
+        if (idx != self->currentEntryIdx) {
+            self->currentEntryIdx = idx;
+
+            if (self->compressedValues) {
+                if (ScheduleRleReader_getValue(self->compressedValues, idx, &(self->value)) == false)
+                    self->value = 0;
+            }
+            else {
+                self->value = self->values[idx];
+            }
+
+            return SCHEDULE_CORE_EVENT_ENTRY_CHANGED;
+        }
+    }
+
+    return SCHEDULE_CORE_EVENT_NONE;
+}
+
+uint64_t
+ScheduleCore_getNextDeadline(const ScheduleCore* self, uint64_t currentTime)
+{
+    if (self->state == SCHEDULE_CORE_STATE_READY) {
+        if (self->nextStartTime == 0)
+            return 0;
+
+        return self->nextStartTime + 1;
+    }
+    else if (self->state == SCHEDULE_CORE_STATE_RUNNING) {
+        if (self->currentEntryIdx < 0)
+            return currentTime;
+
+        /* end of the current entry */
+        if (self->entryEndOffsets)
+            return self->startTime + self->entryEndOffsets[self->currentEntryIdx];
+        else
+            return self->startTime + ((uint64_t)(self->currentEntryIdx + 1) * self->intervalInMs);
+    }
+    else {
+        return 0;
+    }
+}
+
+bool
+ScheduleControllerCore_update(ScheduleControllerCore* self)
+{
+    ScheduleCore* activeSchedule = NULL;
+
+    int i;
+
+    for (i = 0; i < self->numberOfSchedules; i++) {
+        ScheduleCore* schedule = self->schedules[i];
+
+        if (schedule && (schedule->state == SCHEDULE_CORE_STATE_RUNNING)) {
+            if ((activeSchedule == NULL) || ScheduleCore_hasPrecedence(schedule->prio, activeSchedule->prio))
+                activeSchedule = schedule;
+        }
+    }
+
+    bool hasOutput = (activeSchedule && (activeSchedule->currentEntryIdx >= 0));
+    double output = hasOutput ? activeSchedule->value : 0;
+
+    bool changed = (activeSchedule != self->activeSchedule) || (hasOutput != self->hasOutput) || (output != self->output);
+
+    self->activeSchedule = activeSchedule;
+    self->hasOutput = hasOutput;
+    self->output = output;
+
+    return changed;
+}
@@ -0,0 +1,152 @@
+#ifndef SCHEDULE_CORE_H_
+#define SCHEDULE_CORE_H_
+
+/*
+ * Protocol independent core of the schedule execution
+ *
+ * The core works on plain C structures and doesn't depend on the IEC 61850 data model. It can be
+ * used directly by applications that get their schedules by other protocols (MQTT, Modbus, REST ...).
+ * The IEC 61850 scheduler (der_scheduler.h) is not built on ScheduleCore/ScheduleControllerCore: it
+ * has its own state machine for the schedule and schedule controller LNs. It only shares the lookup
+ * functions (ScheduleCore_getEntryIndex, ScheduleCore_findEntryIndex, ScheduleCore_findNextStartTime)
+ * and the priority rule (ScheduleCore_hasPrecedence) with the core.
+ *
+ * The core doesn't lock: each ScheduleCore/ScheduleControllerCore has to be accessed by a single
+ * thread (e.g. the event loop of the application).
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "schedule_rle.h"
+
+typedef enum {
+    SCHEDULE_CORE_STATE_NOT_READY = 1,
+    SCHEDULE_CORE_STATE_START_TIME_REQUIRED = 2,
+    SCHEDULE_CORE_STATE_READY = 3,
+    SCHEDULE_CORE_STATE_RUNNING = 4
+} ScheduleCoreState;
+
+typedef enum {
+    SCHEDULE_CORE_EVENT_NONE = 0,
+    SCHEDULE_CORE_EVENT_STARTED, /* schedule switched to running state */
+    SCHEDULE_CORE_EVENT_ENTRY_CHANGED, /* new entry is active (currentEntryIdx, value) */
+    SCHEDULE_CORE_EVENT_ENDED /* schedule ended (state is READY when there is another start time, NOT_READY otherwise) */
+} ScheduleCoreEvent;
+
+typedef struct {
+    /* parameters - set by the user (the arrays are not copied) */
+    const double* values; /* values of the entries (values[0] is the first entry) */
+    ScheduleRleReader* compressedValues; /* alternative to values: run-length compressed values (decoded on the fly) */
+    int numberOfValues;
+    int intervalInMs; /* duration of each entry */
+    const uint64_t* entryEndOffsets; /* optional: end of each entry in ms after the start (ascending) - NULL for fixed intervalInMs */
+    const uint64_t* startTimes; /* start times in ms since epoch in ascending order */
+    int numberOfStartTimes;
+    int prio;
+
+    /* state - maintained by the core */
+    ScheduleCoreState state;
+    int currentEntryIdx; /* active entry (-1 when no entry is active) */
+    uint64_t startTime; /* start time of the running schedule */
+    uint64_t nextStartTime; /* 0 when there is no next start time */
+    int nextStartTimeIdx; /* first element of startTimes that was in the future at the last lookup */
+    double value; /* value of the active entry */
+} ScheduleCore;
+
+typedef struct {
+    ScheduleCore** schedules; /* schedules that can control the output (set by the user) */
+    int numberOfSchedules;
+
+    ScheduleCore* activeSchedule; /* running schedule with the highest priority or NULL */
+    bool hasOutput;
+    double output; /* value of the active entry of the active schedule */
+} ScheduleControllerCore;
+
+/**
+ * @brief Initialize the state of a schedule (parameters are not changed)
+ */
+void
+ScheduleCore_initialize(ScheduleCore* self);
+
+/**
+ * @brief Enable the schedule
+ *
+ * @return true when the parameters are valid and the schedule has a start time in the future (state READY)
+ */
+bool
+ScheduleCore_enable(ScheduleCore* self, uint64_t currentTime);
+
+/**
+ * @brief Disable the schedule (state NOT_READY)
+ */
+void
+ScheduleCore_disable(ScheduleCore* self);
+
+/**
+ * @brief Process the schedule
+ *
+ * Has to be called until it returns SCHEDULE_CORE_EVENT_NONE (at most one event per call).
+ */
+ScheduleCoreEvent
+ScheduleCore_process(ScheduleCore* self, uint64_t currentTime);
+
+/**
+ * @brief Get the time when ScheduleCore_process has to be called next
+ *
+ * @return time in ms since epoch or 0 when the schedule is not active
+ */
+uint64_t
+ScheduleCore_getNextDeadline(const ScheduleCore* self, uint64_t currentTime);
+
+/**
+ * @brief Get the index of the entry that is active at currentTime
+ *
+ * @return the index (starting with 0) or -1 when the schedule ended
+ */
+int
+ScheduleCore_getEntryIndex(uint64_t startTime, int intervalInMs, int numberOfEntries, uint64_t currentTime);
+
+/**
+ * @brief Get the index of the entry that contains offset (entries with variable duration)
+ *
+ * Checks the entry at the cursor and the following entry first, and falls back to a binary search.
+ * With a monotonic offset the lookup is O(1) amortized.
+ *
+ * @param entryEndOffsets end of each entry in ms after the start of the schedule (ascending)
+ * @param numberOfEntries number of elements in entryEndOffsets
+ * @param offset time since the start of the schedule in ms
+ * @param cursor last found index (hint) - updated with the result; can be NULL
+ *
+ * @return the index (starting with 0) or -1 when the schedule ended
+ */
+int
+ScheduleCore_findEntryIndex(const uint64_t* entryEndOffsets, int numberOfEntries, uint64_t offset, int* cursor);
+
+/**
+ * @brief Find the first start time after currentTime
+ *
+ * @param startTimes start times in ascending order
+ * @param numberOfStartTimes number of elements in startTimes
+ * @param cursor first element to check - moved behind the start times that are in the past
+ *
+ * @return the start time or 0 when there is no start time in the future
+ */
+uint64_t
+ScheduleCore_findNextStartTime(const uint64_t* startTimes, int numberOfStartTimes, int* cursor, uint64_t currentTime);
+
+/**
+ * @brief Check if a running schedule with priority prio replaces the active schedule with priority activePrio
+ */
+bool
+ScheduleCore_hasPrecedence(int prio, int activePrio);
+
+/**
+ * @brief Select the active schedule and update the output
+ *
+ * @return true when the active schedule or the output changed
+ */
+bool
+ScheduleControllerCore_update(ScheduleControllerCore* self);
+
+#endif /* SCHEDULE_CORE_H_ */
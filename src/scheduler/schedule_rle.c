@@ -0,0 +1,300 @@
+#include "schedule_rle.h"
+
+#include <string.h>
+
+#define SCHEDULE_RLE_KIND_INT_DELTA 0
+#define SCHEDULE_RLE_KIND_FLOAT 1
+#define SCHEDULE_RLE_KIND_DOUBLE 2
+
+/* integer values up to this magnitude are delta encoded (the delta always fits into int64) */
+#define SCHEDULE_RLE_MAX_INT_VALUE 4503599627370496.0 /* 2^52 */
+
+static void
+scheduleRleEncoder_writeByte(ScheduleRleEncoder* self, uint8_t value)
+{
+    if (self->size < self->bufferSize)
+        self->buffer[self->size++] = value;
+    else
+        self->overflow = true;
+}
+
+static void
+scheduleRleEncoder_writeVarint(ScheduleRleEncoder* self, uint64_t value)
+{
+    while (value >= 0x80) {
+        scheduleRleEncoder_writeByte(self, (uint8_t)(value | 0x80));
+        value >>= 7;
+    }
+
+    scheduleRleEncoder_writeByte(self, (uint8_t)value);
+}
+
+static void
+scheduleRleEncoder_writeLittleEndian(ScheduleRleEncoder* self, uint64_t value, int numberOfBytes)
+{
+    int i;
+
+    for (i = 0; i < numberOfBytes; i++) {
+        scheduleRleEncoder_writeByte(self, (uint8_t)(value >> (8 * i)));
+    }
+}
+
+static void
+scheduleRleEncoder_writeRun(ScheduleRleEncoder* self)
+{
+    double value = self->runValue;
+
+    if ((value >= -SCHEDULE_RLE_MAX_INT_VALUE) && (value <= SCHEDULE_RLE_MAX_INT_VALUE) && (value == (double)(int64_t)value)) {
+        int64_t intValue = (int64_t)value;
+        int64_t delta = intValue - self->lastIntValue;
+
+        scheduleRleEncoder_writeVarint(self, ((uint64_t)self->runLength << 2) | SCHEDULE_RLE_KIND_INT_DELTA);
+        scheduleRleEncoder_writeVarint(self, ((uint64_t)delta << 1) ^ (uint64_t)(delta >> 63));
+
+        self->lastIntValue = intValue;
+    }
+    else if ((double)(float)value == value) {
+        float floatValue = (float)value;
+        uint32_t bits;
+
+        memcpy(&bits, &floatValue, sizeof(bits));
+
+        scheduleRleEncoder_writeVarint(self, ((uint64_t)self->runLength << 2) | SCHEDULE_RLE_KIND_FLOAT);
+        scheduleRleEncoder_writeLittleEndian(self, bits, 4);
+    }
+    else {
+        uint64_t bits;
+
+        memcpy(&bits, &value, sizeof(bits));
+
+        scheduleRleEncoder_writeVarint(self, ((uint64_t)self->runLength << 2) | SCHEDULE_RLE_KIND_DOUBLE);
+        scheduleRleEncoder_writeLittleEndian(self, bits, 8);
+    }
+}
+
+void
+ScheduleRleEncoder_initialize(ScheduleRleEncoder* self, uint8_t* buffer, int bufferSize)
+{
+    memset(self, 0, sizeof(ScheduleRleEncoder));
+
+    self->buffer = buffer;
+    self->bufferSize = bufferSize;
+
+    /* header - the number of values is updated by ScheduleRleEncoder_finish */
+    scheduleRleEncoder_writeByte(self, SCHEDULE_RLE_VERSION);
+    scheduleRleEncoder_writeLittleEndian(self, 0, 4);
+}
+
+void
+ScheduleRleEncoder_addValue(ScheduleRleEncoder* self, double value)
+{
+    /* memcmp to treat equal NaN values as a run */
+    if (self->hasRun && ((self->runValue == value) || (memcmp(&(self->runValue), &value, sizeof(double)) == 0))) {
+        self->runLength++;
+    }
+    else {
+        if (self->hasRun)
+            scheduleRleEncoder_writeRun(self);
+
+        self->hasRun = true;
+        self->runValue = value;
+        self->runLength = 1;
+    }
+
+    self->numberOfValues++;
+}
+
+int
+ScheduleRleEncoder_finish(ScheduleRleEncoder* self)
+{
+    if (self->hasRun) {
+        scheduleRleEncoder_writeRun(self);
+        self->hasRun = false;
+    }
+
+    if (self->overflow)
+        return -1;
+
+    int i;
+
+    for (i = 0; i < 4; i++)
+        self->buffer[1 + i] = (uint8_t)((uint32_t)self->numberOfValues >> (8 * i));
+
+    return self->size;
+}
+
+int
+ScheduleRle_encode(const double* values, int numberOfValues, uint8_t* buffer, int bufferSize)
+{
+    ScheduleRleEncoder encoder;
+
+    ScheduleRleEncoder_initialize(&encoder, buffer, bufferSize);
+
+    int i;
+
+    for (i = 0; i < numberOfValues; i++)
+        ScheduleRleEncoder_addValue(&encoder, values[i]);
+
+    return ScheduleRleEncoder_finish(&encoder);
+}
+
+static bool
+scheduleRleReader_readVarint(ScheduleRleReader* self, uint64_t* value)
+{
+    uint64_t result = 0;
+    int shift = 0;
+
+    while (self->readPos < self->size) {
+        uint8_t byte = self->data[self->readPos++];
+
+        result |= (uint64_t)(byte & 0x7f) << shift;
+
+        if ((byte & 0x80) == 0) {
+            *value = result;
+            return true;
+        }
+
+        shift += 7;
+
+        if (shift > 63)
+            return false;
+    }
+
+    return false;
+}
+
+static bool
+scheduleRleReader_readLittleEndian(ScheduleRleReader* self, uint64_t* value, int numberOfBytes)
+{
+    if (self->readPos + numberOfBytes > self->size)
+        return false;
+
+    uint64_t result = 0;
+
+    int i;
+
+    for (i = 0; i < numberOfBytes; i++)
+        result |= (uint64_t)self->data[self->readPos + i] << (8 * i);
+
+    self->readPos += numberOfBytes;
+
+    *value = result;
+
+    return true;
+}
+
+static bool
+scheduleRleReader_readRun(ScheduleRleReader* self)
+{
+    uint64_t header;
+    uint64_t value;
+
+    if (scheduleRleReader_readVarint(self, &header) == false)
+        return false;
+
+    uint64_t runLength = header >> 2;
+
+    if ((runLength == 0) || (runLength > (uint64_t)(self->numberOfValues - (self->runStart + self->runLength))))
+        return false;
+
+    self->runStart += self->runLength;
+    self->runLength = (int)runLength;
+
+    switch (header & 3) {
+    case SCHEDULE_RLE_KIND_INT_DELTA:
+        if (scheduleRleReader_readVarint(self, &value) == false)
+            return false;
+
+        self->lastIntValue += (int64_t)((value >> 1) ^ (~(value & 1) + 1));
+        self->runValue = (double)self->lastIntValue;
+        break;
+
+    case SCHEDULE_RLE_KIND_FLOAT:
+        {
+            if (scheduleRleReader_readLittleEndian(self, &value, 4) == false)
+                return false;
+
+            uint32_t bits = (uint32_t)value;
+            float floatValue;
+
+            memcpy(&floatValue, &bits, sizeof(floatValue));
+
+            self->runValue = floatValue;
+        }
+        break;
+
+    case SCHEDULE_RLE_KIND_DOUBLE:
+        if (scheduleRleReader_readLittleEndian(self, &value, 8) == false)
+            return false;
+
+        memcpy(&(self->runValue), &value, sizeof(double));
+        break;
+
+    default:
+        return false;
+    }
+
+    return true;
+}
+
+static void
+scheduleRleReader_rewind(ScheduleRleReader* self)
+{
+    self->readPos = SCHEDULE_RLE_HEADER_SIZE;
+    self->runStart = 0;
+    self->runLength = 0;
+    self->runValue = 0;
+    self->lastIntValue = 0;
+}
+
+bool
+ScheduleRleReader_initialize(ScheduleRleReader* self, const uint8_t* data, int size)
+{
+    memset(self, 0, sizeof(ScheduleRleReader));
+
+    if ((data == NULL) || (size < SCHEDULE_RLE_HEADER_SIZE) || (data[0] != SCHEDULE_RLE_VERSION))
+        return false;
+
+    uint32_t numberOfValues = 0;
+
+    int i;
+
+    for (i = 0; i < 4; i++)
+        numberOfValues |= (uint32_t)data[1 + i] << (8 * i);
+
+    if (numberOfValues > INT32_MAX)
+        return false;
+
+    self->data = data;
+    self->size = size;
+    self->numberOfValues = (int)numberOfValues;
+
+    scheduleRleReader_rewind(self);
+
+    return true;
+}
+
+int
+ScheduleRleReader_getNumberOfValues(ScheduleRleReader* self)
+{
+    return self->numberOfValues;
+}
+
+bool
+ScheduleRleReader_getValue(ScheduleRleReader* self, int idx, double* value)
+{
+    if ((idx < 0) || (idx >= self->numberOfValues))
+        return false;
+
+    if (idx < self->runStart)
+        scheduleRleReader_rewind(self);
+
+    while (idx >= self->runStart + self->runLength) {
+        if (scheduleRleReader_readRun(self) == false)
+            return false;
+    }
+
+    *value = self->runValue;
+
+    return true;
+}
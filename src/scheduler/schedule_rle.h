@@ -0,0 +1,112 @@
+#ifndef SCHEDULE_RLE_H_
+#define SCHEDULE_RLE_H_
+
+/*
+ * Run-length compressed representation of schedule values
+ *
+ * Consecutive equal values are stored as one run. Integer values are stored as the
+ * difference to the previous integer run (zigzag varint), other values as float or
+ * double. A day-ahead schedule with 1440 entries and a few dozen value changes needs
+ * only a few hundred bytes.
+ *
+ * Format (all multi-byte numbers little endian):
+ *
+ *   version (1 byte) | number of values (uint32) | runs ...
+ *
+ *   run: varint (runLength << 2 | kind) followed by the value
+ *        kind 0: zigzag varint delta to the value of the previous integer run
+ *        kind 1: float (4 bytes)
+ *        kind 2: double (8 bytes)
+ *
+ * Has no dependencies on the scheduler or libiec61850.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define SCHEDULE_RLE_VERSION 1
+
+#define SCHEDULE_RLE_HEADER_SIZE 5
+
+/* buffer size that is sufficient for any schedule with n values */
+#define SCHEDULE_RLE_MAX_ENCODED_SIZE(n) (SCHEDULE_RLE_HEADER_SIZE + ((n) * 19))
+
+typedef struct {
+    uint8_t* buffer;
+    int bufferSize;
+    int size; /* number of bytes written */
+    int numberOfValues;
+    bool overflow; /* buffer was too small */
+
+    bool hasRun;
+    double runValue;
+    int runLength;
+    int64_t lastIntValue;
+} ScheduleRleEncoder;
+
+typedef struct {
+    const uint8_t* data;
+    int size;
+    int numberOfValues;
+
+    int readPos; /* position of the next run in data */
+    int runStart; /* index of the first value of the current run */
+    int runLength; /* 0 before the first run */
+    double runValue;
+    int64_t lastIntValue;
+} ScheduleRleReader;
+
+/**
+ * @brief Start encoding into a user provided buffer
+ */
+void
+ScheduleRleEncoder_initialize(ScheduleRleEncoder* self, uint8_t* buffer, int bufferSize);
+
+/**
+ * @brief Append the next value
+ */
+void
+ScheduleRleEncoder_addValue(ScheduleRleEncoder* self, double value);
+
+/**
+ * @brief Complete the encoding
+ *
+ * @return the size of the encoded data or -1 when the buffer was too small
+ */
+int
+ScheduleRleEncoder_finish(ScheduleRleEncoder* self);
+
+/**
+ * @brief Encode an array of values
+ *
+ * @return the size of the encoded data or -1 when the buffer was too small
+ */
+int
+ScheduleRle_encode(const double* values, int numberOfValues, uint8_t* buffer, int bufferSize);
+
+/**
+ * @brief Prepare the decoding of compressed values (the data is not copied)
+ *
+ * @return true when the header is valid
+ */
+bool
+ScheduleRleReader_initialize(ScheduleRleReader* self, const uint8_t* data, int size);
+
+/**
+ * @brief Get the number of values
+ */
+int
+ScheduleRleReader_getNumberOfValues(ScheduleRleReader* self);
+
+/**
+ * @brief Get the value with index idx (decoded on the fly)
+ *
+ * Accessing the values in ascending order is O(1) amortized. A smaller index than the last one
+ * restarts the decoding at the beginning.
+ *
+ * @return true on success, false when the index is out of range or the data is corrupted
+ */
+bool
+ScheduleRleReader_getValue(ScheduleRleReader* self, int idx, double* value);
+
+#endif /* SCHEDULE_RLE_H_ */
@@ -0,0 +1,294 @@
+#include "schedule_values.h"
+
+#include <libiec61850/hal_thread.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SCHEDULE_VALUE_POOL_INITIAL_BUCKETS 64
+
+struct sScheduleValueArray {
+    ScheduleValuePool pool;
+    ScheduleValueArray next; /* next array in the same bucket */
+    uint64_t hash;
+    int refCount; /* protected by the pool lock */
+    int numberOfValues;
+    double values[];
+};
+
+struct sScheduleValuePool {
+    Semaphore lock;
+    ScheduleValueArray* buckets;
+    int numberOfBuckets; /* power of two */
+    int numberOfArrays;
+    int memoryUsage;
+};
+
+/* FNV-1a over the bytes of the values */
+static uint64_t
+scheduleValues_hash(const double* values, int numberOfValues)
+{
+    const uint8_t* data = (const uint8_t*)values;
+    size_t size = (size_t)numberOfValues * sizeof(double);
+
+    uint64_t hash = 0xcbf29ce484222325ULL;
+
+    size_t i;
+
+    for (i = 0; i < size; i++) {
+        hash ^= data[i];
+        hash *= 0x100000001b3ULL;
+    }
+
+    return hash;
+}
+
+static void
+scheduleValuePool_grow(ScheduleValuePool self)
+{
+    int newNumberOfBuckets = self->numberOfBuckets * 2;
+
+    ScheduleValueArray* newBuckets = (ScheduleValueArray*)calloc(newNumberOfBuckets, sizeof(ScheduleValueArray));
+
+    /* keep the current table - only the lookup is slower */
+    if (newBuckets == NULL)
+        return;
+
+    int i;
+
+    for (i = 0; i < self->numberOfBuckets; i++) {
+        ScheduleValueArray array = self->buckets[i];
+
+        while (array) {
+            ScheduleValueArray next = array->next;
+
+            int idx = (int)(array->hash & (uint64_t)(newNumberOfBuckets - 1));
+
+            array->next = newBuckets[idx];
+            newBuckets[idx] = array;
+
+            array = next;
+        }
+    }
+
+    free(self->buckets);
+
+    self->buckets = newBuckets;
+    self->numberOfBuckets = newNumberOfBuckets;
+}
+
+ScheduleValuePool
+ScheduleValuePool_create(void)
+{
+    ScheduleValuePool self = (ScheduleValuePool)calloc(1, sizeof(struct sScheduleValuePool));
+
+    if (self) {
+        self->buckets = (ScheduleValueArray*)calloc(SCHEDULE_VALUE_POOL_INITIAL_BUCKETS, sizeof(ScheduleValueArray));
+
+        if (self->buckets == NULL) {
+            free(self);
+            return NULL;
+        }
+
+        self->numberOfBuckets = SCHEDULE_VALUE_POOL_INITIAL_BUCKETS;
+        self->lock = Semaphore_create(1);
+    }
+
+    return self;
+}
+
+void
+ScheduleValuePool_destroy(ScheduleValuePool self)
+{
+    if (self) {
+        if (self->numberOfArrays > 0)
+            printf("WARN: Value pool destroyed with %i arrays in use\n", self->numberOfArrays);
+
+        int i;
+
+        for (i = 0; i < self->numberOfBuckets; i++) {
+            ScheduleValueArray array = self->buckets[i];
+
+            while (array) {
+                ScheduleValueArray next = array->next;
+
+                free(array);
+
+                array = next;
+            }
+        }
+
+        free(self->buckets);
+
+        Semaphore_destroy(self->lock);
+
+        free(self);
+    }
+}
+
+ScheduleValueArray
+ScheduleValuePool_getArray(ScheduleValuePool self, const double* values, int numberOfValues)
+{
+    if ((numberOfValues < 0) || ((values == NULL) && (numberOfValues > 0)))
+        return NULL;
+
+    uint64_t hash = scheduleValues_hash(values, numberOfValues);
+
+    size_t valuesSize = (size_t)numberOfValues * sizeof(double);
+
+    Semaphore_wait(self->lock);
+
+    int idx = (int)(hash & (uint64_t)(self->numberOfBuckets - 1));
+
+    ScheduleValueArray array = self->buckets[idx];
+
+    while (array) {
+        if ((array->hash == hash) && (array->numberOfValues == numberOfValues) &&
+            ((valuesSize == 0) || (memcmp(array->values, values, valuesSize) == 0)))
+        {
+            array->refCount++;
+            break;
+        }
+
+        array = array->next;
+    }
+
+    if (array == NULL) {
+        array = (ScheduleValueArray)malloc(sizeof(struct sScheduleValueArray) + valuesSize);
+
+        if (array) {
+            array->pool = self;
+            array->hash = hash;
+            array->refCount = 1;
+            array->numberOfValues = numberOfValues;
+
+            if (valuesSize > 0)
+                memcpy(array->values, values, valuesSize);
+
+            array->next = self->buckets[idx];
+            self->buckets[idx] = array;
+
+            self->numberOfArrays++;
+            self->memoryUsage += (int)(sizeof(struct sScheduleValueArray) + valuesSize);
+
+            if (self->numberOfArrays > self->numberOfBuckets)
+                scheduleValuePool_grow(self);
+        }
+    }
+
+    Semaphore_post(self->lock);
+
+    return array;
+}
+
+int
+ScheduleValuePool_getNumberOfArrays(ScheduleValuePool self)
+{
+    Semaphore_wait(self->lock);
+
+    int numberOfArrays = self->numberOfArrays;
+
+    Semaphore_post(self->lock);
+
+    return numberOfArrays;
+}
+
+int
+ScheduleValuePool_getMemoryUsage(ScheduleValuePool self)
+{
+    Semaphore_wait(self->lock);
+
+    int memoryUsage = self->memoryUsage + self->numberOfBuckets * (int)sizeof(ScheduleValueArray);
+
+    Semaphore_post(self->lock);
+
+    return memoryUsage;
+}
+
+ScheduleValueArray
+ScheduleValueArray_retain(ScheduleValueArray self)
+{
+    ScheduleValuePool pool = self->pool;
+
+    Semaphore_wait(pool->lock);
+
+    self->refCount++;
+
+    Semaphore_post(pool->lock);
+
+    return self;
+}
+
+void
+ScheduleValueArray_release(ScheduleValueArray self)
+{
+    if (self == NULL)
+        return;
+
+    ScheduleValuePool pool = self->pool;
+
+    /* with the pool lock, so that a concurrent lookup can't find an array that is being freed */
+    Semaphore_wait(pool->lock);
+
+    self->refCount--;
+
+    if (self->refCount == 0) {
+        ScheduleValueArray* link = &(pool->buckets[self->hash & (uint64_t)(pool->numberOfBuckets - 1)]);
+
+        while (*link && (*link != self))
+            link = &((*link)->next);
+
+        if (*link)
+            *link = self->next;
+
+        pool->numberOfArrays--;
+        pool->memoryUsage -= (int)(sizeof(struct sScheduleValueArray) + (size_t)self->numberOfValues * sizeof(double));
+
+        free(self);
+    }
+
+    Semaphore_post(pool->lock);
+}
+
+const double*
+ScheduleValueArray_getValues(ScheduleValueArray self)
+{
+    return self->values;
+}
+
+int
+ScheduleValueArray_getNumberOfValues(ScheduleValueArray self)
+{
+    return self->numberOfValues;
+}
+
+ScheduleValueArray
+ScheduleValueArray_setValue(ScheduleValueArray self, int idx, double value)
+{
+    if ((idx < 0) || (idx >= self->numberOfValues))
+        return NULL;
+
+    if (memcmp(&(self->values[idx]), &value, sizeof(double)) == 0)
+        return self;
+
+    size_t valuesSize = (size_t)self->numberOfValues * sizeof(double);
+
+    double* values = (double*)malloc(valuesSize);
+
+    if (values == NULL)
+        return NULL;
+
+    memcpy(values, self->values, valuesSize);
+
+    values[idx] = value;
+
+    ScheduleValueArray newArray = ScheduleValuePool_getArray(self->pool, values, self->numberOfValues);
+
+    free(values);
+
+    if (newArray)
+        ScheduleValueArray_release(self);
+
+    return newArray;
+}
@@ -0,0 +1,98 @@
+#ifndef SCHEDULE_VALUES_H_
+#define SCHEDULE_VALUES_H_
+
+/*
+ * Shared immutable arrays of schedule values
+ *
+ * A pool keeps one reference counted buffer for each distinct content (content addressed by a hash
+ * of the values). Schedules with the same profile (e.g. the reserve schedules of many devices)
+ * share one buffer, and two arrays from the same pool are equal exactly when they are the same
+ * object. The arrays are never modified: ScheduleValueArray_setValue creates (or finds) the array
+ * with the changed content (copy-on-write).
+ *
+ * The values can be used as ScheduleCore values (see schedule_core.h).
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef struct sScheduleValuePool* ScheduleValuePool;
+
+typedef struct sScheduleValueArray* ScheduleValueArray;
+
+/**
+ * @brief Create a new pool
+ *
+ * @return the new pool or NULL on error
+ */
+ScheduleValuePool
+ScheduleValuePool_create(void);
+
+/**
+ * @brief Release the pool (all arrays of the pool have to be released before)
+ */
+void
+ScheduleValuePool_destroy(ScheduleValuePool self);
+
+/**
+ * @brief Get the shared array with the given content
+ *
+ * Returns an existing array of the pool when the content is equal, otherwise a new array
+ * with a copy of the values. The caller owns a reference and has to release it.
+ *
+ * @return the array or NULL on error
+ */
+ScheduleValueArray
+ScheduleValuePool_getArray(ScheduleValuePool self, const double* values, int numberOfValues);
+
+/**
+ * @brief Get the number of distinct arrays in the pool
+ */
+int
+ScheduleValuePool_getNumberOfArrays(ScheduleValuePool self);
+
+/**
+ * @brief Get the memory used by the arrays of the pool in bytes
+ */
+int
+ScheduleValuePool_getMemoryUsage(ScheduleValuePool self);
+
+/**
+ * @brief Add a reference to the array
+ */
+ScheduleValueArray
+ScheduleValueArray_retain(ScheduleValueArray self);
+
+/**
+ * @brief Release a reference (the array is freed with the last reference)
+ */
+void
+ScheduleValueArray_release(ScheduleValueArray self);
+
+const double*
+ScheduleValueArray_getValues(ScheduleValueArray self);
+
+int
+ScheduleValueArray_getNumberOfValues(ScheduleValueArray self);
+
+/**
+ * @brief Change a value (copy-on-write)
+ *
+ * Releases the reference to self and returns a reference to the array with the changed content.
+ *
+ * @return the array with the changed value (self when the value doesn't change), NULL on error
+ *         (self is not released in this case)
+ */
+ScheduleValueArray
+ScheduleValueArray_setValue(ScheduleValueArray self, int idx, double value);
+
+/**
+ * @brief Check if two arrays of the same pool have the same content (O(1))
+ */
+static inline bool
+ScheduleValueArray_equals(ScheduleValueArray self, ScheduleValueArray other)
+{
+    return (self == other);
+}
+
+#endif /* SCHEDULE_VALUES_H_ */
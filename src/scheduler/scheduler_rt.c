@@ -0,0 +1,213 @@
+#define _GNU_SOURCE /* CPU_SET and pthread_setaffinity_np */
+
+#include "scheduler_rt.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+/* upper limit for the pre-faulted stack (the default thread stack is 8 MB) */
+#define SCHEDULER_RT_MAX_PREFAULT_STACK_SIZE (1024 * 1024)
+
+static void __attribute__((noinline))
+schedulerRt_prefaultStack(int size)
+{
+    volatile char buffer[size];
+
+    memset((char*)buffer, 0, size);
+}
+
+bool
+SchedulerRt_applyToCurrentThread(const SchedulerRtConfig* config)
+{
+    bool success = true;
+
+    if (config->policy != SCHEDULER_RT_POLICY_DEFAULT) {
+        struct sched_param param;
+
+        memset(&param, 0, sizeof(param));
+
+        param.sched_priority = config->priority;
+
+        int policy = (config->policy == SCHEDULER_RT_POLICY_RR) ? SCHED_RR : SCHED_FIFO;
+
+        int result = pthread_setschedparam(pthread_self(), policy, &param);
+
+        if (result != 0) {
+            printf("WARN: Failed to set real-time priority %i (%s)\n", config->priority, strerror(result));
+            success = false;
+        }
+    }
+    else {
+        struct sched_param param;
+
+        memset(&param, 0, sizeof(param));
+
+        pthread_setschedparam(pthread_self(), SCHED_OTHER, &param);
+    }
+
+    cpu_set_t cpuSet;
+
+    CPU_ZERO(&cpuSet);
+
+    int cpu;
+
+    for (cpu = 0; cpu < 64; cpu++) {
+        if ((config->cpuMask == 0) || (config->cpuMask & ((uint64_t)1 << cpu)))
+            CPU_SET(cpu, &cpuSet);
+    }
+
+    /* without mask: allow all CPUs again (a previous configuration can have pinned the thread) */
+    if (config->cpuMask == 0) {
+        for (cpu = 64; cpu < CPU_SETSIZE; cpu++)
+            CPU_SET(cpu, &cpuSet);
+    }
+
+    int result = pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet);
+
+    if ((result != 0) && (config->cpuMask != 0)) {
+        printf("WARN: Failed to set CPU affinity 0x%llx (%s)\n", (unsigned long long)config->cpuMask, strerror(result));
+        success = false;
+    }
+
+    if (config->prefaultStackSize > 0) {
+        int size = config->prefaultStackSize;
+
+        if (size > SCHEDULER_RT_MAX_PREFAULT_STACK_SIZE)
+            size = SCHEDULER_RT_MAX_PREFAULT_STACK_SIZE;
+
+        schedulerRt_prefaultStack(size);
+    }
+
+    return success;
+}
+
+bool
+SchedulerRt_lockMemory(const SchedulerRtConfig* config)
+{
+    if (config->lockMemory == false)
+        return true;
+
+    if (mlockall(MCL_CURRENT | MCL_FUTURE) == -1) {
+        printf("WARN: Failed to lock memory (%s)\n", strerror(errno));
+        return false;
+    }
+
+    if (config->prefaultHeapSize > 0) {
+#ifdef __GLIBC__
+        /* keep freed memory in the heap instead of returning it to the system */
+        mallopt(M_TRIM_THRESHOLD, -1);
+        mallopt(M_MMAP_MAX, 0);
+#endif
+
+        char* buffer = (char*)malloc(config->prefaultHeapSize);
+
+        if (buffer) {
+            memset(buffer, 0, config->prefaultHeapSize);
+            free(buffer);
+        }
+    }
+
+    return true;
+}
+
+uint64_t
+SchedulerRt_getMonotonicTimeInUs(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ((uint64_t)ts.tv_sec * 1000000) + (ts.tv_nsec / 1000);
+}
+
+static int
+schedulerRtLatency_getBucket(uint32_t latencyInUs)
+{
+    int bucket = (latencyInUs == 0) ? 0 : (32 - __builtin_clz(latencyInUs));
+
+    return (bucket < SCHEDULER_RT_LATENCY_BUCKETS) ? bucket : (SCHEDULER_RT_LATENCY_BUCKETS - 1);
+}
+
+void
+SchedulerRtLatency_addWakeup(SchedulerRtLatency* self, uint64_t sleepStartInUs, int sleepTimeInMs)
+{
+    uint64_t wakeupTime = sleepStartInUs + ((uint64_t)sleepTimeInMs * 1000);
+    uint64_t currentTime = SchedulerRt_getMonotonicTimeInUs();
+
+    uint64_t latency = (currentTime > wakeupTime) ? (currentTime - wakeupTime) : 0;
+
+    uint32_t latencyInUs = (latency > UINT32_MAX) ? UINT32_MAX : (uint32_t)latency;
+
+    /* single writer - the atomic stores only prevent torn reads of other threads */
+    __atomic_store_n(&(self->totalLatencyInUs), self->totalLatencyInUs + latencyInUs, __ATOMIC_RELAXED);
+
+    if (latencyInUs > self->maxLatencyInUs)
+        __atomic_store_n(&(self->maxLatencyInUs), latencyInUs, __ATOMIC_RELAXED);
+
+    int bucket = schedulerRtLatency_getBucket(latencyInUs);
+
+    __atomic_store_n(&(self->histogram[bucket]), self->histogram[bucket] + 1, __ATOMIC_RELAXED);
+
+    __atomic_store_n(&(self->numberOfWakeups), self->numberOfWakeups + 1, __ATOMIC_RELAXED);
+}
+
+void
+SchedulerRtLatency_merge(SchedulerRtLatency* self, const SchedulerRtLatency* other)
+{
+    self->numberOfWakeups += __atomic_load_n(&(other->numberOfWakeups), __ATOMIC_RELAXED);
+    self->totalLatencyInUs += __atomic_load_n(&(other->totalLatencyInUs), __ATOMIC_RELAXED);
+
+    uint32_t maxLatencyInUs = __atomic_load_n(&(other->maxLatencyInUs), __ATOMIC_RELAXED);
+
+    if (maxLatencyInUs > self->maxLatencyInUs)
+        self->maxLatencyInUs = maxLatencyInUs;
+
+    int i;
+
+    for (i = 0; i < SCHEDULER_RT_LATENCY_BUCKETS; i++)
+        self->histogram[i] += __atomic_load_n(&(other->histogram[i]), __ATOMIC_RELAXED);
+}
+
+uint32_t
+SchedulerRtLatency_getPercentile(const SchedulerRtLatency* self, double percentile)
+{
+    uint64_t total = 0;
+
+    int i;
+
+    for (i = 0; i < SCHEDULER_RT_LATENCY_BUCKETS; i++)
+        total += self->histogram[i];
+
+    if (total == 0)
+        return 0;
+
+    /* number of wakeups that have to be covered (rounded up) */
+    uint64_t threshold = (uint64_t)(((percentile * total) + 99.0) / 100.0);
+
+    if (threshold < 1)
+        threshold = 1;
+
+    uint64_t count = 0;
+
+    for (i = 0; i < SCHEDULER_RT_LATENCY_BUCKETS - 1; i++) {
+        count += self->histogram[i];
+
+        if (count >= threshold) {
+            uint32_t upperBound = (i == 0) ? 0 : (((uint32_t)1 << i) - 1);
+
+            return (upperBound < self->maxLatencyInUs) ? upperBound : self->maxLatencyInUs;
+        }
+    }
+
+    return self->maxLatencyInUs;
+}
@@ -0,0 +1,93 @@
+#ifndef SCHEDULER_RT_H_
+#define SCHEDULER_RT_H_
+
+/*
+ * Real-time configuration of the engine threads (Linux)
+ *
+ * Scheduling policy and priority, CPU affinity and memory locking for the threads that
+ * process the schedules, and the measurement of their wakeup latency (the time a thread
+ * wakes up later than requested). On a shared gateway the latency of threads with default
+ * scheduling depends on the load of the other processes; with SCHED_FIFO or SCHED_RR and
+ * locked memory it stays in the range of the kernel scheduling latency.
+ *
+ * Has no dependencies on the scheduler or libiec61850.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef enum {
+    /** default time sharing scheduling (SCHED_OTHER) */
+    SCHEDULER_RT_POLICY_DEFAULT = 0,
+    /** SCHED_FIFO */
+    SCHEDULER_RT_POLICY_FIFO = 1,
+    /** SCHED_RR */
+    SCHEDULER_RT_POLICY_RR = 2
+} SchedulerRtPolicy;
+
+typedef struct {
+    SchedulerRtPolicy policy;
+    int priority; /* 1 - 99 for SCHEDULER_RT_POLICY_FIFO and SCHEDULER_RT_POLICY_RR */
+    uint64_t cpuMask; /* CPUs the threads may run on (bit n -> CPU n), 0 for all CPUs */
+    bool lockMemory; /* lock all current and future pages of the process in memory (mlockall) */
+    int prefaultStackSize; /* bytes of the thread stack that are touched to have them mapped (0 - none) */
+    int prefaultHeapSize; /* bytes of heap that are touched and kept by malloc when lockMemory is set (0 - none) */
+} SchedulerRtConfig;
+
+#define SCHEDULER_RT_LATENCY_BUCKETS 16
+
+typedef struct {
+    uint64_t numberOfWakeups;
+    uint64_t totalLatencyInUs;
+    uint32_t maxLatencyInUs;
+    uint32_t histogram[SCHEDULER_RT_LATENCY_BUCKETS]; /* bucket n: latency < 2^n us (last bucket: all larger values) */
+} SchedulerRtLatency;
+
+/**
+ * @brief Apply policy, priority, CPU affinity and stack pre-faulting to the calling thread
+ *
+ * @return true on success, false when a setting was rejected (e.g. missing CAP_SYS_NICE)
+ */
+bool
+SchedulerRt_applyToCurrentThread(const SchedulerRtConfig* config);
+
+/**
+ * @brief Lock the memory of the process and pre-fault the heap (when config->lockMemory is set)
+ *
+ * @return true on success, false when the memory cannot be locked (e.g. RLIMIT_MEMLOCK)
+ */
+bool
+SchedulerRt_lockMemory(const SchedulerRtConfig* config);
+
+/**
+ * @brief Get a monotonic time stamp in microseconds
+ */
+uint64_t
+SchedulerRt_getMonotonicTimeInUs(void);
+
+/**
+ * @brief Record the wakeup of a thread that started sleeping at sleepStartInUs for sleepTimeInMs
+ *
+ * Only the thread that owns the latency record calls this function. Other threads can read the
+ * record with SchedulerRtLatency_merge.
+ */
+void
+SchedulerRtLatency_addWakeup(SchedulerRtLatency* self, uint64_t sleepStartInUs, int sleepTimeInMs);
+
+/**
+ * @brief Add the values of another latency record (e.g. to combine the records of all threads)
+ */
+void
+SchedulerRtLatency_merge(SchedulerRtLatency* self, const SchedulerRtLatency* other);
+
+/**
+ * @brief Get an upper bound of a latency percentile (resolution of the histogram buckets)
+ *
+ * @param percentile the percentile (e.g. 99.9)
+ *
+ * @return the latency in us (0 when no wakeup was recorded)
+ */
+uint32_t
+SchedulerRtLatency_getPercentile(const SchedulerRtLatency* self, double percentile);
+
+#endif /* SCHEDULER_RT_H_ */
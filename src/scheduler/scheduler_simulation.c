@@ -0,0 +1,338 @@
+#include "scheduler_simulation.h"
+
+#include <libiec61850/hal_thread.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/* number of twins a worker thread takes at once */
+#define SIMULATION_TWIN_CHUNK_SIZE 64
+
+struct sSimulationTwin {
+    ScheduleCore** schedules;
+    int numberOfSchedules;
+    int maxSchedules;
+
+    ScheduleControllerCore** controllers;
+    int numberOfControllers;
+    int maxControllers;
+
+    uint64_t time; /* virtual time up to which the twin is processed */
+
+    void* userData;
+};
+
+struct sSchedulerSimulation {
+    uint64_t currentTime;
+    uint64_t targetTime; /* time of the running advance */
+
+    SimulationTwin* twins;
+    int numberOfTwins;
+    int maxTwins;
+
+    int nextTwinIdx; /* next twin to be taken by a worker thread (atomic) */
+
+    SimulationOutputHandler outputHandler;
+    void* outputHandlerParameter;
+
+    int numberOfThreads;
+    Thread* threads;
+    Semaphore startWork;
+    Semaphore workDone;
+    bool running;
+};
+
+static bool
+simulation_grow(void** array, int* maxElements, int elementSize)
+{
+    int newMax = (*maxElements == 0) ? 4 : (*maxElements * 2);
+
+    void* newArray = realloc(*array, (size_t)newMax * elementSize);
+
+    if (newArray == NULL)
+        return false;
+
+    *array = newArray;
+    *maxElements = newMax;
+
+    return true;
+}
+
+static void
+simulation_processTwinAt(SchedulerSimulation self, SimulationTwin twin, uint64_t time)
+{
+    int i;
+
+    for (i = 0; i < twin->numberOfSchedules; i++) {
+        while (ScheduleCore_process(twin->schedules[i], time) != SCHEDULE_CORE_EVENT_NONE);
+    }
+
+    for (i = 0; i < twin->numberOfControllers; i++) {
+        ScheduleControllerCore* controller = twin->controllers[i];
+
+        if (ScheduleControllerCore_update(controller)) {
+            if (self->outputHandler)
+                self->outputHandler(self->outputHandlerParameter, twin, controller, time);
+        }
+    }
+}
+
+static uint64_t
+simulation_getTwinDeadline(SimulationTwin twin, uint64_t time)
+{
+    uint64_t nextDeadline = 0;
+
+    int i;
+
+    for (i = 0; i < twin->numberOfSchedules; i++) {
+        uint64_t deadline = ScheduleCore_getNextDeadline(twin->schedules[i], time);
+
+        if (deadline && ((nextDeadline == 0) || (deadline < nextDeadline)))
+            nextDeadline = deadline;
+    }
+
+    return nextDeadline;
+}
+
+static void
+simulation_processTwin(SchedulerSimulation self, SimulationTwin twin, uint64_t endTime)
+{
+    uint64_t time = twin->time;
+
+    while (true) {
+        simulation_processTwinAt(self, twin, time);
+
+        uint64_t deadline = simulation_getTwinDeadline(twin, time);
+
+        if ((deadline == 0) || (deadline > endTime))
+            break;
+
+        /* always move forward */
+        if (deadline <= time)
+            deadline = time + 1;
+
+        time = deadline;
+    }
+
+    twin->time = endTime;
+}
+
+static void
+simulation_processTwins(SchedulerSimulation self)
+{
+    while (true) {
+        int firstIdx = __atomic_fetch_add(&(self->nextTwinIdx), SIMULATION_TWIN_CHUNK_SIZE, __ATOMIC_RELAXED);
+
+        if (firstIdx >= self->numberOfTwins)
+            break;
+
+        int lastIdx = firstIdx + SIMULATION_TWIN_CHUNK_SIZE;
+
+        if (lastIdx > self->numberOfTwins)
+            lastIdx = self->numberOfTwins;
+
+        int i;
+
+        for (i = firstIdx; i < lastIdx; i++)
+            simulation_processTwin(self, self->twins[i], self->targetTime);
+    }
+}
+
+static void*
+simulation_workerThread(void* parameter)
+{
+    SchedulerSimulation self = (SchedulerSimulation)parameter;
+
+    while (true) {
+        Semaphore_wait(self->startWork);
+
+        if (self->running == false)
+            break;
+
+        simulation_processTwins(self);
+
+        Semaphore_post(self->workDone);
+    }
+
+    return NULL;
+}
+
+SchedulerSimulation
+SchedulerSimulation_create(int numberOfThreads, uint64_t startTime)
+{
+    SchedulerSimulation self = (SchedulerSimulation)calloc(1, sizeof(struct sSchedulerSimulation));
+
+    if (self) {
+        self->currentTime = startTime;
+        self->targetTime = startTime;
+
+        if (numberOfThreads > 0) {
+            self->threads = (Thread*)calloc(numberOfThreads, sizeof(Thread));
+
+            if (self->threads == NULL) {
+                printf("ERROR: Failed to allocate worker threads for simulation\n");
+                free(self);
+                return NULL;
+            }
+
+            self->startWork = Semaphore_create(0);
+            self->workDone = Semaphore_create(0);
+            self->running = true;
+
+            int i;
+
+            for (i = 0; i < numberOfThreads; i++) {
+                self->threads[i] = Thread_create(simulation_workerThread, self, false);
+
+                if (self->threads[i] == NULL)
+                    break;
+
+                Thread_start(self->threads[i]);
+            }
+
+            self->numberOfThreads = i;
+
+            if (self->numberOfThreads < numberOfThreads)
+                printf("WARN: Simulation started with %i of %i worker threads\n", self->numberOfThreads, numberOfThreads);
+        }
+    }
+
+    return self;
+}
+
+void
+SchedulerSimulation_destroy(SchedulerSimulation self)
+{
+    if (self) {
+        int i;
+
+        if (self->threads) {
+            self->running = false;
+
+            for (i = 0; i < self->numberOfThreads; i++)
+                Semaphore_post(self->startWork);
+
+            for (i = 0; i < self->numberOfThreads; i++)
+                Thread_destroy(self->threads[i]);
+
+            free(self->threads);
+
+            Semaphore_destroy(self->startWork);
+            Semaphore_destroy(self->workDone);
+        }
+
+        for (i = 0; i < self->numberOfTwins; i++) {
+            SimulationTwin twin = self->twins[i];
+
+            free(twin->schedules);
+            free(twin->controllers);
+            free(twin);
+        }
+
+        free(self->twins);
+
+        free(self);
+    }
+}
+
+void
+SchedulerSimulation_setOutputHandler(SchedulerSimulation self, SimulationOutputHandler handler, void* parameter)
+{
+    self->outputHandler = handler;
+    self->outputHandlerParameter = parameter;
+}
+
+SimulationTwin
+SchedulerSimulation_addTwin(SchedulerSimulation self, void* userData)
+{
+    if (self->numberOfTwins == self->maxTwins) {
+        if (simulation_grow((void**)&(self->twins), &(self->maxTwins), sizeof(SimulationTwin)) == false)
+            return NULL;
+    }
+
+    SimulationTwin twin = (SimulationTwin)calloc(1, sizeof(struct sSimulationTwin));
+
+    if (twin) {
+        twin->time = self->currentTime;
+        twin->userData = userData;
+
+        self->twins[self->numberOfTwins++] = twin;
+    }
+
+    return twin;
+}
+
+int
+SchedulerSimulation_getNumberOfTwins(SchedulerSimulation self)
+{
+    return self->numberOfTwins;
+}
+
+uint64_t
+SchedulerSimulation_getTime(SchedulerSimulation self)
+{
+    return self->currentTime;
+}
+
+void
+SchedulerSimulation_advanceTo(SchedulerSimulation self, uint64_t time)
+{
+    if (time < self->currentTime)
+        return;
+
+    self->targetTime = time;
+    self->nextTwinIdx = 0;
+
+    if (self->numberOfThreads > 0) {
+        int i;
+
+        for (i = 0; i < self->numberOfThreads; i++)
+            Semaphore_post(self->startWork);
+
+        for (i = 0; i < self->numberOfThreads; i++)
+            Semaphore_wait(self->workDone);
+    }
+    else {
+        simulation_processTwins(self);
+    }
+
+    self->currentTime = time;
+}
+
+void
+SchedulerSimulation_advanceBy(SchedulerSimulation self, uint64_t durationInMs)
+{
+    SchedulerSimulation_advanceTo(self, self->currentTime + durationInMs);
+}
+
+bool
+SimulationTwin_addSchedule(SimulationTwin self, ScheduleCore* schedule)
+{
+    if (self->numberOfSchedules == self->maxSchedules) {
+        if (simulation_grow((void**)&(self->schedules), &(self->maxSchedules), sizeof(ScheduleCore*)) == false)
+            return false;
+    }
+
+    self->schedules[self->numberOfSchedules++] = schedule;
+
+    return true;
+}
+
+bool
+SimulationTwin_addController(SimulationTwin self, ScheduleControllerCore* controller)
+{
+    if (self->numberOfControllers == self->maxControllers) {
+        if (simulation_grow((void**)&(self->controllers), &(self->maxControllers), sizeof(ScheduleControllerCore*)) == false)
+            return false;
+    }
+
+    self->controllers[self->numberOfControllers++] = controller;
+
+    return true;
+}
+
+void*
+SimulationTwin_getUserData(SimulationTwin self)
+{
+    return self->userData;
+}
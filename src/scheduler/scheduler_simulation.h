@@ -0,0 +1,117 @@
+#ifndef SCHEDULER_SIMULATION_H_
+#define SCHEDULER_SIMULATION_H_
+
+/*
+ * Headless simulation of many independent schedulers (device twins)
+ *
+ * A simulation runs the protocol independent schedule core (schedule_core.h) for a large number
+ * of twins without IedServer and MMS. All twins share a virtual clock and a fixed pool of worker
+ * threads. The virtual clock is only moved by SchedulerSimulation_advanceTo/advanceBy, so a day
+ * of schedule execution can be simulated in a fraction of a second.
+ *
+ * Each twin has its own schedules and schedule controllers (owned by the application). The twins
+ * are independent from each other: during an advance each twin is processed by one worker thread
+ * from its last time to the new time, jumping directly from one schedule deadline to the next.
+ */
+
+#include "schedule_core.h"
+
+typedef struct sSchedulerSimulation* SchedulerSimulation;
+
+typedef struct sSimulationTwin* SimulationTwin;
+
+/**
+ * @brief Handler that is called when the active schedule or the output of a controller changed
+ *
+ * The handler is called by the worker threads. Calls for the same twin are serialized and in time
+ * order, calls for different twins can happen in parallel.
+ *
+ * @param parameter user provided parameter
+ * @param twin the twin of the controller
+ * @param controller the controller (activeSchedule, hasOutput and output contain the new state)
+ * @param time virtual time of the change (ms since epoch)
+ */
+typedef void (*SimulationOutputHandler)(void* parameter, SimulationTwin twin, ScheduleControllerCore* controller, uint64_t time);
+
+/**
+ * @brief Create a new simulation
+ *
+ * @param numberOfThreads number of worker threads (0 to process the twins in the thread calling advance)
+ * @param startTime initial value of the virtual clock (ms since epoch)
+ *
+ * @return new simulation instance or NULL on error
+ */
+SchedulerSimulation
+SchedulerSimulation_create(int numberOfThreads, uint64_t startTime);
+
+/**
+ * @brief Stop the worker threads and release all resources (schedules and controllers are not released)
+ */
+void
+SchedulerSimulation_destroy(SchedulerSimulation self);
+
+/**
+ * @brief Install the handler for output changes
+ */
+void
+SchedulerSimulation_setOutputHandler(SchedulerSimulation self, SimulationOutputHandler handler, void* parameter);
+
+/**
+ * @brief Add a new twin
+ *
+ * Twins, schedules and controllers must not be added while an advance is running.
+ *
+ * @param userData application specific data of the twin
+ *
+ * @return the new twin or NULL on error
+ */
+SimulationTwin
+SchedulerSimulation_addTwin(SchedulerSimulation self, void* userData);
+
+/**
+ * @brief Get the number of twins
+ */
+int
+SchedulerSimulation_getNumberOfTwins(SchedulerSimulation self);
+
+/**
+ * @brief Get the current value of the virtual clock (ms since epoch)
+ */
+uint64_t
+SchedulerSimulation_getTime(SchedulerSimulation self);
+
+/**
+ * @brief Move the virtual clock forward and process all twins up to the new time
+ *
+ * Returns when all twins are processed. Calls with a time before the current time are ignored.
+ */
+void
+SchedulerSimulation_advanceTo(SchedulerSimulation self, uint64_t time);
+
+/**
+ * @brief Move the virtual clock forward by durationInMs (see SchedulerSimulation_advanceTo)
+ */
+void
+SchedulerSimulation_advanceBy(SchedulerSimulation self, uint64_t durationInMs);
+
+/**
+ * @brief Add a schedule to the twin
+ *
+ * The schedule has to be enabled by the application (ScheduleCore_enable with the virtual time).
+ */
+bool
+SimulationTwin_addSchedule(SimulationTwin self, ScheduleCore* schedule);
+
+/**
+ * @brief Add a schedule controller to the twin (updated after the schedules of the twin are processed)
+ */
+bool
+SimulationTwin_addController(SimulationTwin self, ScheduleControllerCore* controller);
+
+/**
+ * @brief Get the application specific data of the twin
+ */
+void*
+SimulationTwin_getUserData(SimulationTwin self);
+
+#endif /* SCHEDULER_SIMULATION_H_ */
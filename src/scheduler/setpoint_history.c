@@ -0,0 +1,275 @@
+#include "der_scheduler_internal.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define SETPOINT_HISTORY_MAGIC 0x48524544 /* "DERH" */
+#define SETPOINT_HISTORY_VERSION 1
+
+/*
+ * Layout of the history (in memory or in the mapped file):
+ *
+ *   header | capacity records (ring - record n is stored at index n % capacity)
+ *
+ * The records are only appended by the thread that writes the target value (with locked data
+ * model), so they are in write order and the timestamps are ascending. Readers don't lock: they
+ * check after copying a record that it was not overwritten in the meantime. The record after the
+ * newest one can be in the process of being overwritten and is never read.
+ */
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t capacity;
+    uint32_t recordSize;
+    uint64_t numberOfRecords; /* total number of appended records (the newest is numberOfRecords - 1) */
+    uint64_t lastTimestamp;
+} SetpointHistoryHeader;
+
+struct sSetpointHistory {
+    SetpointHistoryHeader* header;
+    Scheduler_SetpointRecord* records;
+    size_t size;
+    bool mapped; /* header is a file mapping (otherwise heap) */
+};
+
+SetpointHistory
+SetpointHistory_create(int capacity, const char* fileName)
+{
+    if (capacity < 2)
+        return NULL;
+
+    SetpointHistory self = (SetpointHistory)calloc(1, sizeof(struct sSetpointHistory));
+
+    if (self == NULL)
+        return NULL;
+
+    self->size = sizeof(SetpointHistoryHeader) + ((size_t)capacity * sizeof(Scheduler_SetpointRecord));
+
+    if (fileName) {
+        int fd = open(fileName, O_CREAT | O_RDWR, 0644);
+
+        if (fd == -1) {
+            printf("ERROR: Failed to open setpoint history file %s\n", fileName);
+            free(self);
+            return NULL;
+        }
+
+        struct stat st;
+
+        bool keepContent = (fstat(fd, &st) == 0) && ((size_t)st.st_size == self->size);
+
+        if ((keepContent == false) && (ftruncate(fd, self->size) == -1)) {
+            printf("ERROR: Failed to set size of setpoint history file %s\n", fileName);
+            close(fd);
+            free(self);
+            return NULL;
+        }
+
+        void* region = mmap(NULL, self->size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+        close(fd);
+
+        if (region == MAP_FAILED) {
+            printf("ERROR: Failed to map setpoint history file %s\n", fileName);
+            free(self);
+            return NULL;
+        }
+
+        self->header = (SetpointHistoryHeader*)region;
+        self->mapped = true;
+
+        /* continue the history of a previous run */
+        if (keepContent && (self->header->magic == SETPOINT_HISTORY_MAGIC) && (self->header->version == SETPOINT_HISTORY_VERSION) &&
+            (self->header->capacity == (uint32_t)capacity) && (self->header->recordSize == sizeof(Scheduler_SetpointRecord)))
+        {
+            printf("INFO: Continue setpoint history %s with %llu records\n", fileName, (unsigned long long)self->header->numberOfRecords);
+        }
+        else {
+            memset(self->header, 0, self->size);
+        }
+    }
+    else {
+        self->header = (SetpointHistoryHeader*)calloc(1, self->size);
+
+        if (self->header == NULL) {
+            free(self);
+            return NULL;
+        }
+    }
+
+    self->header->magic = SETPOINT_HISTORY_MAGIC;
+    self->header->version = SETPOINT_HISTORY_VERSION;
+    self->header->capacity = (uint32_t)capacity;
+    self->header->recordSize = sizeof(Scheduler_SetpointRecord);
+
+    self->records = (Scheduler_SetpointRecord*)(self->header + 1);
+
+    return self;
+}
+
+void
+SetpointHistory_destroy(SetpointHistory self)
+{
+    if (self) {
+        if (self->mapped) {
+            msync(self->header, self->size, MS_SYNC);
+            munmap(self->header, self->size);
+        }
+        else {
+            free(self->header);
+        }
+
+        free(self);
+    }
+}
+
+/**
+ * @brief Append a record (only one writer at a time - called with locked data model)
+ *
+ * The timestamp is raised to the timestamp of the previous record when the clock went backwards,
+ * so the records stay sorted.
+ */
+void
+SetpointHistory_append(SetpointHistory self, uint64_t timestamp, double value, Quality quality, int source)
+{
+    SetpointHistoryHeader* header = self->header;
+
+    uint64_t n = header->numberOfRecords;
+
+    if (timestamp < header->lastTimestamp)
+        timestamp = header->lastTimestamp;
+
+    Scheduler_SetpointRecord* record = &(self->records[n % header->capacity]);
+
+    record->timestamp = timestamp;
+    record->value = value;
+    record->quality = (uint16_t)quality;
+    record->source = (int16_t)source;
+    record->reserved = 0;
+
+    header->lastTimestamp = timestamp;
+
+    /* publish the record */
+    __atomic_store_n(&(header->numberOfRecords), n + 1, __ATOMIC_RELEASE);
+}
+
+/* number of the oldest record that can be read */
+static uint64_t
+setpointHistory_getOldest(SetpointHistory self, uint64_t numberOfRecords)
+{
+    uint64_t capacity = self->header->capacity;
+
+    return (numberOfRecords >= capacity) ? (numberOfRecords - capacity + 1) : 0;
+}
+
+/**
+ * @brief Copy record n
+ *
+ * @return false when the record was overwritten
+ */
+static bool
+setpointHistory_read(SetpointHistory self, uint64_t n, Scheduler_SetpointRecord* record)
+{
+    memcpy(record, &(self->records[n % self->header->capacity]), sizeof(Scheduler_SetpointRecord));
+
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+    return (n >= setpointHistory_getOldest(self, __atomic_load_n(&(self->header->numberOfRecords), __ATOMIC_ACQUIRE)));
+}
+
+/**
+ * @brief Find the first record of the range (binary search)
+ *
+ * @return the number of the record that was active at startTime (or the oldest record when all records are newer)
+ */
+static uint64_t
+setpointHistory_findStart(SetpointHistory self, uint64_t oldest, uint64_t end, uint64_t startTime)
+{
+    uint64_t low = oldest;
+    uint64_t high = end;
+
+    /* first record with timestamp > startTime */
+    while (low < high) {
+        uint64_t mid = low + ((high - low) / 2);
+
+        Scheduler_SetpointRecord record;
+
+        if (setpointHistory_read(self, mid, &record) == false) {
+            /* overwritten while searching -> the range starts at the oldest record */
+            low = mid + 1;
+        }
+        else if (record.timestamp <= startTime) {
+            low = mid + 1;
+        }
+        else {
+            high = mid;
+        }
+    }
+
+    return (low > oldest) ? (low - 1) : oldest;
+}
+
+int
+SetpointHistory_export(SetpointHistory self, uint64_t startTime, uint64_t endTime, Scheduler_SetpointRecordHandler handler, void* parameter)
+{
+    uint64_t end = __atomic_load_n(&(self->header->numberOfRecords), __ATOMIC_ACQUIRE);
+
+    uint64_t n = setpointHistory_findStart(self, setpointHistory_getOldest(self, end), end, startTime);
+
+    int count = 0;
+
+    for (; n < end; n++) {
+        Scheduler_SetpointRecord record;
+
+        /* skip records that were overwritten while exporting */
+        if (setpointHistory_read(self, n, &record) == false)
+            continue;
+
+        if (record.timestamp >= endTime)
+            break;
+
+        count++;
+
+        if (handler(parameter, &record) == false)
+            break;
+    }
+
+    return count;
+}
+
+typedef struct {
+    Scheduler_SetpointRecord* records;
+    int maxRecords;
+    int numberOfRecords;
+} SetpointHistoryQuery;
+
+static bool
+setpointHistory_copyRecord(void* parameter, const Scheduler_SetpointRecord* record)
+{
+    SetpointHistoryQuery* query = (SetpointHistoryQuery*)parameter;
+
+    query->records[query->numberOfRecords++] = *record;
+
+    return (query->numberOfRecords < query->maxRecords);
+}
+
+int
+SetpointHistory_query(SetpointHistory self, uint64_t startTime, uint64_t endTime, Scheduler_SetpointRecord* records, int maxRecords)
+{
+    if (maxRecords < 1)
+        return 0;
+
+    SetpointHistoryQuery query;
+
+    query.records = records;
+    query.maxRecords = maxRecords;
+    query.numberOfRecords = 0;
+
+    SetpointHistory_export(self, startTime, endTime, setpointHistory_copyRecord, &query);
+
+    return query.numberOfRecords;
+}
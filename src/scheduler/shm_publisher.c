@@ -0,0 +1,281 @@
+#include "der_scheduler_internal.h"
+#include "der_scheduler_shm.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <limits.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+struct sShmPublisher {
+    char* name;
+    DerSchedulerShmRegion* region;
+    size_t regionSize;
+    bool notify;
+
+    /* slots of the region replaced by ShmPublisher_recreate (taken over by ShmPublisher_initializeSlot) */
+    DerSchedulerShmSlot* previousSlots;
+    int numberOfPreviousSlots;
+};
+
+ShmPublisher
+ShmPublisher_create(const char* name, int numberOfSlots, bool notify)
+{
+    ShmPublisher self = (ShmPublisher)calloc(1, sizeof(struct sShmPublisher));
+
+    if (self) {
+        self->name = strdup(name);
+        self->notify = notify;
+        self->regionSize = sizeof(DerSchedulerShmRegion) + (numberOfSlots * sizeof(DerSchedulerShmSlot));
+
+        int fd = shm_open(name, O_CREAT | O_RDWR, 0644);
+
+        if (fd == -1) {
+            printf("ERROR: Failed to create shared memory %s\n", name);
+            ShmPublisher_destroy(self);
+            return NULL;
+        }
+
+        if (ftruncate(fd, self->regionSize) == -1) {
+            printf("ERROR: Failed to set size of shared memory %s\n", name);
+            close(fd);
+            ShmPublisher_destroy(self);
+            return NULL;
+        }
+
+        void* region = mmap(NULL, self->regionSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+        close(fd);
+
+        if (region == MAP_FAILED) {
+            printf("ERROR: Failed to map shared memory %s\n", name);
+            ShmPublisher_destroy(self);
+            return NULL;
+        }
+
+        self->region = (DerSchedulerShmRegion*)region;
+
+        memset(self->region, 0, self->regionSize);
+
+        self->region->version = DER_SCHEDULER_SHM_VERSION;
+        self->region->numberOfSlots = numberOfSlots;
+        self->region->slotSize = sizeof(DerSchedulerShmSlot);
+
+        /* readers check the magic number last */
+        __atomic_store_n(&(self->region->magic), DER_SCHEDULER_SHM_MAGIC, __ATOMIC_RELEASE);
+    }
+
+    return self;
+}
+
+void
+ShmPublisher_destroy(ShmPublisher self)
+{
+    if (self) {
+        if (self->region) {
+            munmap(self->region, self->regionSize);
+            shm_unlink(self->name);
+        }
+
+        free(self->previousSlots);
+        free(self->name);
+        free(self);
+    }
+}
+
+/**
+ * @brief Replace the region by a new region with the same name and a different number of slots
+ *
+ * The old region is marked invalid (magic number cleared, waiting readers are woken up), so that
+ * readers map the region again. The content of the old slots is kept until
+ * ShmPublisher_releasePreviousSlots - ShmPublisher_initializeSlot takes over the last values of
+ * a slot with the same controller reference.
+ *
+ * @return the new publisher (the old one is destroyed) or NULL when the new region cannot be created
+ */
+ShmPublisher
+ShmPublisher_recreate(ShmPublisher self, int numberOfSlots)
+{
+    int numberOfPreviousSlots = (int)self->region->numberOfSlots;
+
+    DerSchedulerShmSlot* previousSlots = NULL;
+
+    if (numberOfPreviousSlots > 0) {
+        previousSlots = (DerSchedulerShmSlot*)malloc(numberOfPreviousSlots * sizeof(DerSchedulerShmSlot));
+
+        if (previousSlots) {
+            int i;
+
+            for (i = 0; i < numberOfPreviousSlots; i++)
+                DerSchedulerShm_readSlot(self->region, i, &(previousSlots[i]));
+        }
+        else {
+            numberOfPreviousSlots = 0;
+        }
+    }
+
+    __atomic_store_n(&(self->region->magic), 0, __ATOMIC_RELEASE);
+    __atomic_add_fetch(&(self->region->updateCounter), 1, __ATOMIC_RELEASE);
+
+    if (self->notify) {
+        syscall(SYS_futex, &(self->region->updateCounter), FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+    }
+
+    char* name = strdup(self->name);
+    bool notify = self->notify;
+
+    /* unlinks the old region - readers that still have it mapped see the cleared magic number */
+    ShmPublisher_destroy(self);
+
+    ShmPublisher newPublisher = NULL;
+
+    if (name)
+        newPublisher = ShmPublisher_create(name, numberOfSlots, notify);
+
+    free(name);
+
+    if (newPublisher) {
+        newPublisher->previousSlots = previousSlots;
+        newPublisher->numberOfPreviousSlots = numberOfPreviousSlots;
+    }
+    else {
+        free(previousSlots);
+    }
+
+    return newPublisher;
+}
+
+void
+ShmPublisher_releasePreviousSlots(ShmPublisher self)
+{
+    free(self->previousSlots);
+
+    self->previousSlots = NULL;
+    self->numberOfPreviousSlots = 0;
+}
+
+static DerSchedulerShmSlot*
+shmPublisher_beginUpdate(ShmPublisher self, int slotIdx)
+{
+    DerSchedulerShmSlot* slot = &(self->region->slots[slotIdx]);
+
+    /* multiple schedule threads can update the same slot -> writers acquire the odd sequence number */
+    uint32_t seq = __atomic_load_n(&(slot->sequence), __ATOMIC_RELAXED);
+
+    while ((seq & 1) || (__atomic_compare_exchange_n(&(slot->sequence), &seq, seq + 1, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED) == false)) {
+        seq = __atomic_load_n(&(slot->sequence), __ATOMIC_RELAXED) & ~1U;
+    }
+
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    return slot;
+}
+
+static void
+shmPublisher_endUpdate(ShmPublisher self, DerSchedulerShmSlot* slot)
+{
+    slot->updateCount++;
+
+    __atomic_add_fetch(&(slot->sequence), 1, __ATOMIC_RELEASE);
+
+    __atomic_add_fetch(&(self->region->updateCounter), 1, __ATOMIC_RELEASE);
+
+    if (self->notify) {
+        syscall(SYS_futex, &(self->region->updateCounter), FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+    }
+}
+
+void
+ShmPublisher_initializeSlot(ShmPublisher self, int slotIdx, const char* controllerRef)
+{
+    if ((slotIdx < 0) || (slotIdx >= (int)self->region->numberOfSlots))
+        return;
+
+    DerSchedulerShmSlot* previousSlot = NULL;
+
+    int i;
+
+    for (i = 0; i < self->numberOfPreviousSlots; i++) {
+        if (strncmp(self->previousSlots[i].controllerRef, controllerRef, DER_SCHEDULER_SHM_REF_SIZE - 1) == 0) {
+            previousSlot = &(self->previousSlots[i]);
+            break;
+        }
+    }
+
+    DerSchedulerShmSlot* slot = shmPublisher_beginUpdate(self, slotIdx);
+
+    strncpy(slot->controllerRef, controllerRef, DER_SCHEDULER_SHM_REF_SIZE - 1);
+
+    if (previousSlot) {
+        /* same controller in the previous region -> keep the last published output */
+        slot->valueType = previousSlot->valueType;
+        slot->value = previousSlot->value;
+        slot->quality = previousSlot->quality;
+        slot->updateCount = previousSlot->updateCount;
+        slot->timestampMs = previousSlot->timestampMs;
+
+        memcpy(slot->targetRef, previousSlot->targetRef, DER_SCHEDULER_SHM_REF_SIZE);
+        memcpy(slot->activeScheduleRef, previousSlot->activeScheduleRef, DER_SCHEDULER_SHM_REF_SIZE);
+    }
+    else {
+        slot->quality = QUALITY_VALIDITY_INVALID;
+    }
+
+    shmPublisher_endUpdate(self, slot);
+}
+
+void
+ShmPublisher_publish(ShmPublisher self, int slotIdx, const char* targetRef, MmsValue* value, Quality quality,
+    uint64_t timestampMs, const char* activeScheduleRef)
+{
+    if ((slotIdx < 0) || (slotIdx >= (int)self->region->numberOfSlots))
+        return;
+
+    DerSchedulerShmValueType valueType = DER_SCHEDULER_SHM_VALUE_NONE;
+    double doubleValue = 0.0;
+
+    if (value) {
+        switch (MmsValue_getType(value)) {
+        case MMS_FLOAT:
+            valueType = DER_SCHEDULER_SHM_VALUE_FLOAT;
+            doubleValue = MmsValue_toDouble(value);
+            break;
+
+        case MMS_INTEGER:
+        case MMS_UNSIGNED:
+            valueType = DER_SCHEDULER_SHM_VALUE_INT;
+            doubleValue = (double)MmsValue_toInt64(value);
+            break;
+
+        case MMS_BOOLEAN:
+            valueType = DER_SCHEDULER_SHM_VALUE_BOOLEAN;
+            doubleValue = MmsValue_getBoolean(value) ? 1.0 : 0.0;
+            break;
+
+        default:
+            break;
+        }
+    }
+
+    DerSchedulerShmSlot* slot = shmPublisher_beginUpdate(self, slotIdx);
+
+    slot->valueType = valueType;
+    slot->value = doubleValue;
+    slot->quality = quality;
+    slot->timestampMs = timestampMs;
+
+    if (targetRef)
+        strncpy(slot->targetRef, targetRef, DER_SCHEDULER_SHM_REF_SIZE - 1);
+    else
+        slot->targetRef[0] = 0;
+
+    if (activeScheduleRef)
+        strncpy(slot->activeScheduleRef, activeScheduleRef, DER_SCHEDULER_SHM_REF_SIZE - 1);
+    else
+        slot->activeScheduleRef[0] = 0;
+
+    shmPublisher_endUpdate(self, slot);
+}
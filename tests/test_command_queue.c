@@ -0,0 +1,282 @@
+/*
+ * Test of the command queue of the schedules (multiple producers, single consumer)
+ *
+ * Several producer threads push numbered commands while the consumer thread pops them. Every
+ * command has to arrive exactly once and the commands of each producer have to arrive in the
+ * order they were pushed. A full queue rejects commands until the consumer takes one. Reserved
+ * cells are not available for other producers.
+ *
+ * Usage: test_command_queue
+ */
+
+#include "der_scheduler_internal.h"
+
+#include <libiec61850/hal_thread.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define NUMBER_OF_PRODUCERS 4
+#define COMMANDS_PER_PRODUCER 20000
+
+static CommandQueue queue;
+
+static int rejectedPushes = 0;
+
+static void*
+producerThread(void* parameter)
+{
+    int producer = (int)(intptr_t)parameter;
+
+    int i;
+
+    for (i = 0; i < COMMANDS_PER_PRODUCER; i++) {
+        SchedulerCommand command;
+
+        memset(&command, 0, sizeof(command));
+
+        command.type = SCHD_CMD_SET_PRIO;
+        command.intValue = producer;
+        command.timeValue = (uint64_t)i;
+
+        /* retry when the queue is full - odd producers reserve the cell first */
+        if (producer % 2) {
+            while (CommandQueue_reserve(&queue, 1) == false) {
+                __atomic_add_fetch(&rejectedPushes, 1, __ATOMIC_RELAXED);
+                Thread_sleep(0);
+            }
+
+            CommandQueue_pushReserved(&queue, &command);
+        }
+        else {
+            while (CommandQueue_push(&queue, &command) == false) {
+                __atomic_add_fetch(&rejectedPushes, 1, __ATOMIC_RELAXED);
+                Thread_sleep(0);
+            }
+        }
+    }
+
+    return NULL;
+}
+
+static bool
+testFullQueue(void)
+{
+    CommandQueue_initialize(&queue);
+
+    SchedulerCommand command;
+
+    memset(&command, 0, sizeof(command));
+
+    command.type = SCHD_CMD_SET_PRIO;
+
+    int i;
+
+    for (i = 0; i < CONFIG_SCHEDULE_COMMAND_QUEUE_SIZE; i++) {
+        command.intValue = i;
+
+        if (CommandQueue_push(&queue, &command) == false) {
+            printf("ERROR: Queue full after %i commands\n", i);
+            return false;
+        }
+    }
+
+    if (CommandQueue_push(&queue, &command)) {
+        printf("ERROR: Full queue accepted a command\n");
+        return false;
+    }
+
+    /* one free cell after a pop */
+    if ((CommandQueue_pop(&queue, &command) == false) || (command.intValue != 0)) {
+        printf("ERROR: Unexpected first command\n");
+        return false;
+    }
+
+    command.intValue = CONFIG_SCHEDULE_COMMAND_QUEUE_SIZE;
+
+    if (CommandQueue_push(&queue, &command) == false) {
+        printf("ERROR: Command rejected after pop\n");
+        return false;
+    }
+
+    for (i = 1; i <= CONFIG_SCHEDULE_COMMAND_QUEUE_SIZE; i++) {
+        if ((CommandQueue_pop(&queue, &command) == false) || (command.intValue != i)) {
+            printf("ERROR: Command %i missing or out of order\n", i);
+            return false;
+        }
+    }
+
+    if (CommandQueue_pop(&queue, &command)) {
+        printf("ERROR: Empty queue returned a command\n");
+        return false;
+    }
+
+    return true;
+}
+
+static bool
+testReservation(void)
+{
+    CommandQueue_initialize(&queue);
+
+    SchedulerCommand command;
+
+    memset(&command, 0, sizeof(command));
+
+    command.type = SCHD_CMD_SET_PRIO;
+
+    if (CommandQueue_reserve(&queue, CONFIG_SCHEDULE_COMMAND_QUEUE_SIZE + 1)) {
+        printf("ERROR: Reserved more cells than the queue has\n");
+        return false;
+    }
+
+    if (CommandQueue_reserve(&queue, CONFIG_SCHEDULE_COMMAND_QUEUE_SIZE - 1) == false) {
+        printf("ERROR: Failed to reserve cells\n");
+        return false;
+    }
+
+    /* one cell left for the other producers */
+    if (CommandQueue_push(&queue, &command) == false) {
+        printf("ERROR: Free cell not available\n");
+        return false;
+    }
+
+    if (CommandQueue_push(&queue, &command) || CommandQueue_reserve(&queue, 1)) {
+        printf("ERROR: Reserved cell used by another producer\n");
+        return false;
+    }
+
+    /* the reserved cells can be used, unused ones are returned */
+    command.intValue = 1;
+
+    CommandQueue_pushReserved(&queue, &command);
+
+    CommandQueue_releaseReservation(&queue, CONFIG_SCHEDULE_COMMAND_QUEUE_SIZE - 2);
+
+    if (CommandQueue_reserve(&queue, CONFIG_SCHEDULE_COMMAND_QUEUE_SIZE - 2) == false) {
+        printf("ERROR: Released cells not available\n");
+        return false;
+    }
+
+    CommandQueue_releaseReservation(&queue, CONFIG_SCHEDULE_COMMAND_QUEUE_SIZE - 2);
+
+    int i;
+
+    for (i = 0; i < 2; i++) {
+        if ((CommandQueue_pop(&queue, &command) == false) || (command.intValue != i)) {
+            printf("ERROR: Reserved command %i missing or out of order\n", i);
+            return false;
+        }
+    }
+
+    if (CommandQueue_pop(&queue, &command)) {
+        printf("ERROR: Empty queue returned a command\n");
+        return false;
+    }
+
+    /* the popped cells are free again */
+    if (CommandQueue_reserve(&queue, CONFIG_SCHEDULE_COMMAND_QUEUE_SIZE) == false) {
+        printf("ERROR: Cells not free after pop\n");
+        return false;
+    }
+
+    return true;
+}
+
+static bool
+testConcurrentProducers(void)
+{
+    CommandQueue_initialize(&queue);
+
+    Thread producers[NUMBER_OF_PRODUCERS];
+
+    int i;
+
+    for (i = 0; i < NUMBER_OF_PRODUCERS; i++) {
+        producers[i] = Thread_create(producerThread, (void*)(intptr_t)i, false);
+        Thread_start(producers[i]);
+    }
+
+    /* consumer */
+    uint64_t expected[NUMBER_OF_PRODUCERS];
+
+    memset(expected, 0, sizeof(expected));
+
+    int received = 0;
+    bool success = true;
+
+    while (received < (NUMBER_OF_PRODUCERS * COMMANDS_PER_PRODUCER)) {
+        SchedulerCommand command;
+
+        if (CommandQueue_pop(&queue, &command) == false) {
+            Thread_sleep(0);
+            continue;
+        }
+
+        received++;
+
+        int producer = command.intValue;
+
+        if ((producer < 0) || (producer >= NUMBER_OF_PRODUCERS) || (command.type != SCHD_CMD_SET_PRIO)) {
+            printf("ERROR: Corrupted command (type %i, producer %i)\n", command.type, producer);
+            success = false;
+            break;
+        }
+
+        if (command.timeValue != expected[producer]) {
+            printf("ERROR: Producer %i: command %llu instead of %llu\n", producer,
+                (unsigned long long)command.timeValue, (unsigned long long)expected[producer]);
+            success = false;
+            break;
+        }
+
+        expected[producer]++;
+    }
+
+    /* don't leave the producers blocked on a full queue */
+    if (success == false) {
+        SchedulerCommand command;
+
+        while (received < (NUMBER_OF_PRODUCERS * COMMANDS_PER_PRODUCER)) {
+            if (CommandQueue_pop(&queue, &command))
+                received++;
+            else
+                Thread_sleep(0);
+        }
+    }
+
+    for (i = 0; i < NUMBER_OF_PRODUCERS; i++)
+        Thread_destroy(producers[i]);
+
+    SchedulerCommand command;
+
+    if (CommandQueue_pop(&queue, &command)) {
+        printf("ERROR: Unexpected command after all commands were received\n");
+        success = false;
+    }
+
+    printf("INFO: %i commands received (%i pushes rejected by the full queue)\n", received,
+        __atomic_load_n(&rejectedPushes, __ATOMIC_RELAXED));
+
+    return success;
+}
+
+int
+main(int argc, char** argv)
+{
+    bool success = true;
+
+    if (testFullQueue() == false)
+        success = false;
+
+    if (testReservation() == false)
+        success = false;
+
+    if (testConcurrentProducers() == false)
+        success = false;
+
+    printf("%s\n", success ? "PASSED" : "FAILED");
+
+    return success ? 0 : 1;
+}
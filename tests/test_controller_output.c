@@ -0,0 +1,421 @@
+/*
+ * Test of the output processing of a schedule controller
+ *
+ * Runs a schedule of ActPow_FSCC1 in external mode (Scheduler_process is called by the test) and
+ * checks the target values passed to the target value handler with the different output settings
+ * of the schedule controller.
+ *
+ * Usage: test_controller_output [model.cfg]
+ */
+
+#include "der_scheduler.h"
+
+#include <libiec61850/hal_thread.h>
+#include <libiec61850/hal_time.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_TARGET_VALUES 1000
+
+static const char* controllerRef = "@Control/ActPow_FSCC1";
+static const char* scheduleRef = "@Control/ActPow_FSCH01";
+static const char* scheduleLn = "ActPow_FSCH01";
+
+typedef struct {
+    double value;
+    uint64_t timestamp;
+} TargetValue;
+
+typedef struct {
+    IedModel* model;
+    IedServer server;
+    Scheduler sched;
+
+    /* valid target values in the order of the handler calls */
+    TargetValue values[MAX_TARGET_VALUES];
+    int numberOfValues;
+} TestContext;
+
+static int numberOfFailedChecks = 0;
+
+static void
+check(bool condition, const char* description)
+{
+    if (condition == false) {
+        printf("ERROR: %s\n", description);
+        numberOfFailedChecks++;
+    }
+}
+
+static void
+targetValueChanged(void* parameter, const char* targetValueObjRef, MmsValue* value, Quality quality, uint64_t timestampMs)
+{
+    TestContext* self = (TestContext*)parameter;
+
+    if ((value == NULL) || (quality != QUALITY_VALIDITY_GOOD) || (self->numberOfValues == MAX_TARGET_VALUES))
+        return;
+
+    TargetValue* targetValue = &(self->values[self->numberOfValues++]);
+
+    if (MmsValue_getType(value) == MMS_FLOAT)
+        targetValue->value = MmsValue_toDouble(value);
+    else
+        targetValue->value = (double)MmsValue_toInt64(value);
+
+    targetValue->timestamp = timestampMs;
+}
+
+static bool
+createContext(TestContext* self, const char* modelFile)
+{
+    memset(self, 0, sizeof(TestContext));
+
+    self->model = ConfigFileParser_createModelFromConfigFileEx(modelFile);
+
+    if (self->model == NULL) {
+        printf("ERROR: Failed to load data model %s\n", modelFile);
+        return false;
+    }
+
+    self->server = IedServer_create(self->model);
+
+    self->sched = Scheduler_createEx(self->model, self->server, SCHEDULER_MODE_EXTERNAL, NULL);
+
+    Scheduler_setTargetValueHandler(self->sched, targetValueChanged, self);
+
+    return true;
+}
+
+static void
+destroyContext(TestContext* self)
+{
+    Scheduler_destroy(self->sched);
+    IedServer_destroy(self->server);
+    IedModel_destroy(self->model);
+}
+
+static DataAttribute*
+getAttribute(TestContext* self, const char* attributeRef)
+{
+    char objRef[130];
+
+    snprintf(objRef, sizeof(objRef), "Control/%s.%s", scheduleLn, attributeRef);
+
+    DataAttribute* attr = (DataAttribute*)IedModel_getModelNodeByShortObjectReference(self->model, objRef);
+
+    if (attr == NULL)
+        printf("ERROR: %s not found in the data model\n", objRef);
+
+    return attr;
+}
+
+/* one entry per second */
+static bool
+configureSchedule(TestContext* self, const float* values, int numberOfValues, uint64_t startTime)
+{
+    DataAttribute* numEntr = getAttribute(self, "NumEntr.setVal");
+    DataAttribute* schdIntv = getAttribute(self, "SchdIntv.setVal");
+    DataAttribute* schdPrio = getAttribute(self, "SchdPrio.setVal");
+    DataAttribute* strTm = getAttribute(self, "StrTm01.setTm");
+
+    if ((numEntr == NULL) || (schdIntv == NULL) || (schdPrio == NULL) || (strTm == NULL))
+        return false;
+
+    IedServer_lockDataModel(self->server);
+
+    IedServer_updateInt32AttributeValue(self->server, numEntr, numberOfValues);
+    IedServer_updateInt32AttributeValue(self->server, schdIntv, 1);
+    IedServer_updateInt32AttributeValue(self->server, schdPrio, 10);
+
+    int i;
+
+    for (i = 0; i < numberOfValues; i++) {
+        char valueRef[40];
+
+        snprintf(valueRef, sizeof(valueRef), "ValASG%03i.setMag.f", i + 1);
+
+        DataAttribute* valueAttr = getAttribute(self, valueRef);
+
+        if (valueAttr)
+            IedServer_updateFloatAttributeValue(self->server, valueAttr, values[i]);
+    }
+
+    IedServer_updateUTCTimeAttributeValue(self->server, strTm, startTime);
+
+    IedServer_unlockDataModel(self->server);
+
+    return true;
+}
+
+/* event loop of the application */
+static void
+processUntil(TestContext* self, uint64_t endTime)
+{
+    uint64_t currentTime;
+
+    while ((currentTime = Hal_getTimeInMs()) < endTime) {
+        Scheduler_process(self->sched, currentTime);
+
+        Thread_sleep(5);
+    }
+}
+
+/**
+ * @brief Run the schedule from start to end
+ *
+ * @return the start time of the schedule
+ */
+static uint64_t
+runSchedule(TestContext* self, const float* values, int numberOfValues)
+{
+    uint64_t startTime = Hal_getTimeInMs() + 300;
+
+    if (configureSchedule(self, values, numberOfValues, startTime) == false) {
+        numberOfFailedChecks++;
+        return 0;
+    }
+
+    check(Scheduler_enableSchedule(self->sched, scheduleRef, true), "enable schedule");
+
+    processUntil(self, startTime + ((uint64_t)numberOfValues * 1000) + 300);
+
+    return startTime;
+}
+
+static void
+testDeadband(const char* modelFile)
+{
+    TestContext* self = (TestContext*)malloc(sizeof(TestContext));
+
+    if (createContext(self, modelFile) == false) {
+        numberOfFailedChecks++;
+        free(self);
+        return;
+    }
+
+    Scheduler_TargetValueFilter filter;
+
+    memset(&filter, 0, sizeof(filter));
+
+    filter.absoluteDeadband = 10;
+
+    check(Scheduler_setTargetValueFilter(self->sched, controllerRef, &filter), "set target value filter");
+
+    const float values[] = { 100, 105, 150, 152 };
+
+    runSchedule(self, values, 4);
+
+    /* changes below the deadband are suppressed */
+    check((self->numberOfValues == 2) && (self->values[0].value == 100) && (self->values[1].value == 150),
+        "target values with deadband");
+
+    destroyContext(self);
+    free(self);
+}
+
+static void
+testRamp(const char* modelFile)
+{
+    TestContext* self = (TestContext*)malloc(sizeof(TestContext));
+
+    if (createContext(self, modelFile) == false) {
+        numberOfFailedChecks++;
+        free(self);
+        return;
+    }
+
+    Scheduler_RampConfig ramp;
+
+    memset(&ramp, 0, sizeof(ramp));
+
+    ramp.rampRate = 100; /* per second */
+    ramp.updateIntervalInMs = 100;
+
+    check(Scheduler_setTargetValueRamp(self->sched, controllerRef, &ramp), "set target value ramp");
+
+    /* soft start from 0 to 100 in 1 s, then from 100 to 300 in 2 s */
+    const float values[] = { 100, 300, 300, 300 };
+
+    runSchedule(self, values, 4);
+
+    check(self->numberOfValues >= 20, "intermediate values of the ramp");
+
+    if (self->numberOfValues > 0) {
+        check(self->values[0].value <= 20, "soft start from 0");
+        check(self->values[self->numberOfValues - 1].value == 300, "ramp reaches the schedule value");
+    }
+
+    int i;
+
+    for (i = 1; i < self->numberOfValues; i++) {
+        TargetValue* last = &(self->values[i - 1]);
+        TargetValue* current = &(self->values[i]);
+
+        double maxStep = (ramp.rampRate * (double)(current->timestamp - last->timestamp) / 1000.0) + 1.0;
+
+        if ((current->value < last->value) || (current->value - last->value > maxStep)) {
+            printf("ERROR: Ramp step from %f to %f in %llu ms\n", last->value, current->value,
+                (unsigned long long)(current->timestamp - last->timestamp));
+            numberOfFailedChecks++;
+            break;
+        }
+    }
+
+    destroyContext(self);
+    free(self);
+}
+
+static void
+testInterpolation(const char* modelFile)
+{
+    TestContext* self = (TestContext*)malloc(sizeof(TestContext));
+
+    if (createContext(self, modelFile) == false) {
+        numberOfFailedChecks++;
+        free(self);
+        return;
+    }
+
+    check(Scheduler_setScheduleInterpolation(self->sched, scheduleRef, true, 100), "enable interpolation");
+
+    /* linear from 0 to 1000 in the first second */
+    const float values[] = { 0, 1000, 1000 };
+
+    uint64_t startTime = runSchedule(self, values, 3);
+
+    int intermediateValues = 0;
+
+    int i;
+
+    for (i = 0; i < self->numberOfValues; i++) {
+        TargetValue* current = &(self->values[i]);
+
+        double expectedValue = (current->timestamp > startTime) ? (double)(current->timestamp - startTime) : 0;
+
+        if (expectedValue > 1000)
+            expectedValue = 1000;
+
+        if ((current->value > 0) && (current->value < 1000))
+            intermediateValues++;
+
+        if ((current->value < expectedValue - 100) || (current->value > expectedValue + 100)) {
+            printf("ERROR: Interpolated value %f at %llu ms after the start (expected %f)\n", current->value,
+                (unsigned long long)(current->timestamp - startTime), expectedValue);
+            numberOfFailedChecks++;
+            break;
+        }
+
+        if ((i > 0) && (current->value < self->values[i - 1].value)) {
+            printf("ERROR: Interpolated value decreased from %f to %f\n", self->values[i - 1].value, current->value);
+            numberOfFailedChecks++;
+            break;
+        }
+    }
+
+    /* an output every 100 ms */
+    check(intermediateValues >= 5, "intermediate values of the interpolation");
+
+    if (self->numberOfValues > 0)
+        check(self->values[self->numberOfValues - 1].value == 1000, "last entry keeps its value");
+
+    destroyContext(self);
+    free(self);
+}
+
+static bool
+isOverrideActive(TestContext* self)
+{
+    Scheduler_ScheduleControllerState states[8];
+
+    int numberOfStates = Scheduler_getScheduleControllerStates(self->sched, states, 8);
+
+    int i;
+
+    for (i = 0; i < numberOfStates; i++) {
+        if (strcmp(states[i].controllerRef, controllerRef + 1) == 0)
+            return states[i].overrideActive;
+    }
+
+    return false;
+}
+
+static void
+testEmergencyOverride(const char* modelFile)
+{
+    TestContext* self = (TestContext*)malloc(sizeof(TestContext));
+
+    if (createContext(self, modelFile) == false) {
+        numberOfFailedChecks++;
+        free(self);
+        return;
+    }
+
+    const float values[] = { 200, 200, 200 };
+
+    uint64_t startTime = Hal_getTimeInMs() + 300;
+
+    if (configureSchedule(self, values, 3, startTime) == false) {
+        numberOfFailedChecks++;
+    }
+    else {
+        check(Scheduler_enableSchedule(self->sched, scheduleRef, true), "enable schedule");
+
+        processUntil(self, startTime + 500);
+
+        int numberOfValues = self->numberOfValues;
+
+        /* the target value handler is called before the function returns */
+        check(Scheduler_setEmergencyOverride(self->sched, controllerRef, 777, 500), "set emergency override");
+        check((self->numberOfValues == numberOfValues + 1) && (self->values[numberOfValues].value == 777),
+            "override applied immediately");
+        check(isOverrideActive(self), "override in the controller state");
+
+        Scheduler_OverrideStatus status;
+
+        check(Scheduler_getEmergencyOverrideStatus(self->sched, controllerRef, &status), "get override status");
+
+        printf("INFO: Apply latency of the override: %u us\n", status.lastApplyLatencyInUs);
+
+        check(status.active && (status.value == 777) && (status.expiryTime != 0), "active override in the status");
+        check((status.numberOfOverrides == 1) && (status.latencyViolations == 0), "override statistics");
+        check((status.lastApplyLatencyInUs <= status.maxApplyLatencyInUs) && (status.lastApplyLatencyInUs < 100000),
+            "apply latency of the override");
+
+        /* the schedule keeps running but doesn't change the target value */
+        processUntil(self, startTime + 900);
+
+        check(self->values[self->numberOfValues - 1].value == 777, "target value during the override");
+
+        /* expiry is checked every cycle of the output processing */
+        processUntil(self, startTime + 1300);
+
+        check(Scheduler_getEmergencyOverrideStatus(self->sched, controllerRef, &status) && (status.active == false),
+            "override expired");
+        check(isOverrideActive(self) == false, "no override in the controller state");
+        check(self->values[self->numberOfValues - 1].value == 200, "target value of the schedule after the override");
+
+        processUntil(self, startTime + 3300);
+    }
+
+    destroyContext(self);
+    free(self);
+}
+
+int
+main(int argc, char** argv)
+{
+    const char* modelFile = (argc > 1) ? argv[1] : "model.cfg";
+
+    testDeadband(modelFile);
+    testRamp(modelFile);
+    testInterpolation(modelFile);
+    testEmergencyOverride(modelFile);
+
+    bool success = (numberOfFailedChecks == 0);
+
+    printf("%s\n", success ? "PASSED" : "FAILED");
+
+    return success ? 0 : 1;
+}
@@ -0,0 +1,360 @@
+/*
+ * Stress test: several schedules drive one schedule controller
+ *
+ * The schedules of ActPow_FSCC1 run with overlapping start times in their own threads (default
+ * mode) while another thread changes the priorities, applies emergency overrides and reads the
+ * controller state. The target value handler checks that every target value belongs to one of the
+ * schedules (or the override), and at the end the active schedule of the controller has to be the
+ * running schedule with the highest priority.
+ *
+ * Usage: test_controller_stress [model.cfg]
+ */
+
+#include "der_scheduler.h"
+
+#include <libiec61850/hal_thread.h>
+#include <libiec61850/hal_time.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#define NUMBER_OF_SCHEDULES 10
+#define NUMBER_OF_ENTRIES 4
+#define OVERRIDE_VALUE 5000.0
+
+static const char* controllerRef = "@Control/ActPow_FSCC1";
+
+static int numberOfTargetValues = 0;
+static int numberOfInvalidTargetValues = 0;
+static bool mutatorRunning = false;
+
+static void
+getScheduleRef(int idx, char* buffer, int size)
+{
+    snprintf(buffer, size, "@Control/ActPow_FSCH%02i", idx + 1);
+}
+
+/* schedule n (1..NUMBER_OF_SCHEDULES) has the values n * 100 + 0, 10, 20 ... (also when interpolated) */
+static bool
+isValidTargetValue(double value)
+{
+    if (value == OVERRIDE_VALUE)
+        return true;
+
+    int scheduleNumber = (int)floor(value / 100.0);
+
+    if ((scheduleNumber < 1) || (scheduleNumber > NUMBER_OF_SCHEDULES))
+        return false;
+
+    double offset = value - (scheduleNumber * 100.0);
+
+    return (offset >= 0) && (offset <= ((NUMBER_OF_ENTRIES - 1) * 10.0) + 0.01);
+}
+
+static void
+targetValueChanged(void* parameter, const char* targetValueObjRef, MmsValue* value, Quality quality, uint64_t timestampMs)
+{
+    __atomic_add_fetch(&numberOfTargetValues, 1, __ATOMIC_RELAXED);
+
+    if ((value == NULL) || (quality != QUALITY_VALIDITY_GOOD))
+        return;
+
+    double numericValue;
+
+    if (MmsValue_getType(value) == MMS_FLOAT)
+        numericValue = MmsValue_toDouble(value);
+    else
+        numericValue = (double)MmsValue_toInt64(value);
+
+    if (isValidTargetValue(numericValue) == false) {
+        __atomic_add_fetch(&numberOfInvalidTargetValues, 1, __ATOMIC_RELAXED);
+        printf("ERROR: Unexpected target value %f\n", numericValue);
+    }
+}
+
+static DataAttribute*
+getAttribute(IedModel* model, const char* scheduleLn, const char* attributeRef)
+{
+    char objRef[130];
+
+    snprintf(objRef, sizeof(objRef), "Control/%s.%s", scheduleLn, attributeRef);
+
+    DataAttribute* attr = (DataAttribute*)IedModel_getModelNodeByShortObjectReference(model, objRef);
+
+    if (attr == NULL)
+        printf("ERROR: %s not found in the data model\n", objRef);
+
+    return attr;
+}
+
+static bool
+configureSchedule(IedModel* model, IedServer server, int idx, uint64_t startTime)
+{
+    char scheduleLn[20];
+
+    snprintf(scheduleLn, sizeof(scheduleLn), "ActPow_FSCH%02i", idx + 1);
+
+    DataAttribute* numEntr = getAttribute(model, scheduleLn, "NumEntr.setVal");
+    DataAttribute* schdIntv = getAttribute(model, scheduleLn, "SchdIntv.setVal");
+    DataAttribute* schdPrio = getAttribute(model, scheduleLn, "SchdPrio.setVal");
+    DataAttribute* strTm = getAttribute(model, scheduleLn, "StrTm01.setTm");
+
+    if ((numEntr == NULL) || (schdIntv == NULL) || (schdPrio == NULL) || (strTm == NULL))
+        return false;
+
+    IedServer_lockDataModel(server);
+
+    IedServer_updateInt32AttributeValue(server, numEntr, NUMBER_OF_ENTRIES);
+    IedServer_updateInt32AttributeValue(server, schdIntv, 1);
+    IedServer_updateInt32AttributeValue(server, schdPrio, 10 + idx);
+
+    int i;
+
+    for (i = 0; i < NUMBER_OF_ENTRIES; i++) {
+        char valueRef[40];
+
+        snprintf(valueRef, sizeof(valueRef), "ValASG%03i.setMag.f", i + 1);
+
+        DataAttribute* valueAttr = getAttribute(model, scheduleLn, valueRef);
+
+        if (valueAttr)
+            IedServer_updateFloatAttributeValue(server, valueAttr, (float)(((idx + 1) * 100) + (i * 10)));
+    }
+
+    IedServer_updateUTCTimeAttributeValue(server, strTm, startTime);
+
+    IedServer_unlockDataModel(server);
+
+    return true;
+}
+
+static void*
+mutatorThread(void* parameter)
+{
+    Scheduler sched = (Scheduler)parameter;
+
+    int iteration = 0;
+
+    while (__atomic_load_n(&mutatorRunning, __ATOMIC_ACQUIRE)) {
+        Scheduler_ScheduleChange changes[3];
+        char scheduleRefs[3][130];
+
+        int i;
+
+        for (i = 0; i < 3; i++) {
+            getScheduleRef(rand() % NUMBER_OF_SCHEDULES, scheduleRefs[i], sizeof(scheduleRefs[i]));
+
+            changes[i].scheduleRef = scheduleRefs[i];
+            changes[i].type = SCHED_CHANGE_SET_PRIO;
+            changes[i].prio = 1 + (rand() % 50);
+        }
+
+        Scheduler_applyScheduleChanges(sched, changes, 3);
+
+        if ((iteration % 20) == 5)
+            Scheduler_setEmergencyOverride(sched, controllerRef, OVERRIDE_VALUE, 0);
+        else if ((iteration % 20) == 10)
+            Scheduler_clearEmergencyOverride(sched, controllerRef);
+
+        Scheduler_ScheduleControllerState states[8];
+
+        Scheduler_getScheduleControllerStates(sched, states, 8);
+
+        iteration++;
+
+        Thread_sleep(1 + (rand() % 5));
+    }
+
+    return NULL;
+}
+
+/* the active schedule of the controller has to be a running schedule with the highest priority */
+static bool
+checkActiveSchedule(Scheduler sched, bool expectRunning)
+{
+    Scheduler_ScheduleState states[NUMBER_OF_SCHEDULES + 32];
+    Scheduler_ScheduleControllerState controllerStates[8];
+
+    int numberOfStates = Scheduler_getScheduleStates(sched, states, NUMBER_OF_SCHEDULES + 32);
+    int numberOfControllers = Scheduler_getScheduleControllerStates(sched, controllerStates, 8);
+
+    Scheduler_ScheduleControllerState* controller = NULL;
+
+    int i;
+
+    for (i = 0; i < numberOfControllers; i++) {
+        if (strcmp(controllerStates[i].controllerRef, controllerRef + 1) == 0)
+            controller = &(controllerStates[i]);
+    }
+
+    if (controller == NULL) {
+        printf("ERROR: Schedule controller %s not found\n", controllerRef);
+        return false;
+    }
+
+    /* ActSchdRef contains the IED name */
+    const char* activeScheduleLn = strrchr(controller->activeScheduleRef, '/');
+
+    int highestPrio = -1;
+    int activePrio = -1;
+
+    for (i = 0; i < numberOfStates; i++) {
+        if (strstr(states[i].scheduleRef, "/ActPow_FSCH") == NULL)
+            continue;
+
+        if (states[i].state != 4)
+            continue;
+
+        if (states[i].prio > highestPrio)
+            highestPrio = states[i].prio;
+
+        if (activeScheduleLn && (strcmp(strrchr(states[i].scheduleRef, '/'), activeScheduleLn) == 0))
+            activePrio = states[i].prio;
+    }
+
+    if (expectRunning == false) {
+        if ((highestPrio != -1) || controller->activeScheduleRef[0]) {
+            printf("ERROR: Active schedule \"%s\" after the end of all schedules\n", controller->activeScheduleRef);
+            return false;
+        }
+
+        return true;
+    }
+
+    if ((highestPrio == -1) || (activePrio != highestPrio)) {
+        printf("ERROR: Active schedule \"%s\" (prio %i) - highest priority of running schedules: %i\n",
+            controller->activeScheduleRef, activePrio, highestPrio);
+        return false;
+    }
+
+    if ((controller->hasValue == false) || (isValidTargetValue(controller->value) == false) || (controller->value == OVERRIDE_VALUE)) {
+        printf("ERROR: Unexpected output of the schedule controller (%f)\n", controller->value);
+        return false;
+    }
+
+    return true;
+}
+
+static bool
+waitForState(Scheduler sched, int minState)
+{
+    int retries;
+
+    for (retries = 0; retries < 100; retries++) {
+        Scheduler_ScheduleState states[NUMBER_OF_SCHEDULES + 32];
+
+        int numberOfStates = Scheduler_getScheduleStates(sched, states, NUMBER_OF_SCHEDULES + 32);
+
+        int count = 0;
+
+        int i;
+
+        for (i = 0; i < numberOfStates; i++) {
+            if (strstr(states[i].scheduleRef, "/ActPow_FSCH") && (states[i].state >= minState))
+                count++;
+        }
+
+        if (count == NUMBER_OF_SCHEDULES)
+            return true;
+
+        Thread_sleep(10);
+    }
+
+    return false;
+}
+
+int
+main(int argc, char** argv)
+{
+    const char* modelFile = (argc > 1) ? argv[1] : "model.cfg";
+
+    IedModel* model = ConfigFileParser_createModelFromConfigFileEx(modelFile);
+
+    if (model == NULL) {
+        printf("ERROR: Failed to load data model %s\n", modelFile);
+        return 1;
+    }
+
+    IedServer server = IedServer_create(model);
+
+    Scheduler sched = Scheduler_create(model, server);
+
+    Scheduler_setTargetValueHandler(sched, targetValueChanged, NULL);
+
+    bool success = true;
+
+    uint64_t startTime = Hal_getTimeInMs() + 1000;
+
+    int i;
+
+    for (i = 0; i < NUMBER_OF_SCHEDULES; i++) {
+        char scheduleRef[130];
+
+        getScheduleRef(i, scheduleRef, sizeof(scheduleRef));
+
+        if (configureSchedule(model, server, i, startTime + (i * 97)) == false) {
+            success = false;
+            break;
+        }
+
+        /* every second schedule generates many value updates */
+        if (i % 2)
+            Scheduler_setScheduleInterpolation(sched, scheduleRef, true, 10);
+
+        if (Scheduler_enableSchedule(sched, scheduleRef, true) == false) {
+            printf("ERROR: Failed to enable %s\n", scheduleRef);
+            success = false;
+        }
+    }
+
+    if (success && (waitForState(sched, 3) == false)) {
+        printf("ERROR: Schedules not ready\n");
+        success = false;
+    }
+
+    if (success) {
+        Thread mutator = Thread_create(mutatorThread, sched, false);
+
+        __atomic_store_n(&mutatorRunning, true, __ATOMIC_RELEASE);
+
+        Thread_start(mutator);
+
+        /* all schedules are running after startTime + 9 * 97 ms and end after 4 s */
+        Thread_sleep(3500);
+
+        __atomic_store_n(&mutatorRunning, false, __ATOMIC_RELEASE);
+
+        Thread_destroy(mutator);
+
+        Scheduler_clearEmergencyOverride(sched, controllerRef);
+
+        /* let the arbitration settle (interpolated values are updated every 10 ms) */
+        Thread_sleep(200);
+
+        if (checkActiveSchedule(sched, true) == false)
+            success = false;
+
+        Thread_sleep(3000);
+
+        if (checkActiveSchedule(sched, false) == false)
+            success = false;
+    }
+
+    int targetValues = __atomic_load_n(&numberOfTargetValues, __ATOMIC_RELAXED);
+    int invalidTargetValues = __atomic_load_n(&numberOfInvalidTargetValues, __ATOMIC_RELAXED);
+
+    printf("INFO: %i target values, %i unexpected\n", targetValues, invalidTargetValues);
+
+    if ((targetValues == 0) || (invalidTargetValues > 0))
+        success = false;
+
+    Scheduler_destroy(sched);
+    IedServer_destroy(server);
+    IedModel_destroy(model);
+
+    printf("%s\n", success ? "PASSED" : "FAILED");
+
+    return success ? 0 : 1;
+}
@@ -0,0 +1,492 @@
+/*
+ * Test of the hot reconfiguration of the scheduler
+ *
+ * Runs a schedule of ActPow_FSCC1 in external mode and applies a revised model while the schedule
+ * is running. The revised model is created from model.cfg: ActPow_FSCH10 and OnOff_FSCC1 are
+ * removed, ActPow_FSCH11 and MaxPow_FSCC2 are added. The running schedule has to continue without
+ * an invalid or wrong target value, ActSchdRef has to be taken over and the shared memory region
+ * has to contain a slot for each controller of the revised model.
+ *
+ * Usage: test_reconfigure [model.cfg]
+ */
+
+#include "der_scheduler.h"
+#include "der_scheduler_shm.h"
+
+#include <libiec61850/hal_thread.h>
+#include <libiec61850/hal_time.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define NUMBER_OF_ENTRIES 6
+
+static const char* scheduleRef = "@Control/ActPow_FSCH01";
+static const char* revisedModelFile = "test_reconfigure.cfg";
+static const char* shmName = "/der_scheduler_test_reconfigure";
+
+typedef struct {
+    int numberOfValues; /* valid target values */
+    int numberOfInvalidValues;
+    double lastValue;
+    uint64_t lastTimestamp;
+} TargetValues;
+
+static int numberOfFailedChecks = 0;
+
+static void
+check(bool condition, const char* description)
+{
+    if (condition == false) {
+        printf("ERROR: %s\n", description);
+        numberOfFailedChecks++;
+    }
+}
+
+static void
+targetValueChanged(void* parameter, const char* targetValueObjRef, MmsValue* value, Quality quality, uint64_t timestampMs)
+{
+    TargetValues* self = (TargetValues*)parameter;
+
+    if ((value == NULL) || (quality != QUALITY_VALIDITY_GOOD)) {
+        self->numberOfInvalidValues++;
+        return;
+    }
+
+    self->numberOfValues++;
+    self->lastValue = MmsValue_toDouble(value);
+    self->lastTimestamp = timestampMs;
+}
+
+static char*
+readFile(const char* fileName)
+{
+    FILE* file = fopen(fileName, "rb");
+
+    if (file == NULL)
+        return NULL;
+
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    char* text = (char*)malloc(size + 1);
+
+    if (text) {
+        if (fread(text, 1, size, file) != (size_t)size) {
+            free(text);
+            text = NULL;
+        }
+        else {
+            text[size] = 0;
+        }
+    }
+
+    fclose(file);
+
+    return text;
+}
+
+/**
+ * @brief Find the LN(name){...} block of a logical node in the model configuration
+ *
+ * @return the start of the block or NULL, length is the size of the block (incl. the line end)
+ */
+static char*
+findLnBlock(char* text, const char* lnName, int* length)
+{
+    char header[80];
+
+    snprintf(header, sizeof(header), "LN(%s){", lnName);
+
+    char* start = strstr(text, header);
+
+    if (start == NULL)
+        return NULL;
+
+    int depth = 0;
+    char* pos = start;
+
+    while (*pos) {
+        if (*pos == '{') {
+            depth++;
+        }
+        else if (*pos == '}') {
+            depth--;
+
+            if (depth == 0)
+                break;
+        }
+
+        pos++;
+    }
+
+    if (*pos == 0)
+        return NULL;
+
+    pos++;
+
+    if (*pos == '\n')
+        pos++;
+
+    *length = (int)(pos - start);
+
+    return start;
+}
+
+/* copy of a LN block with a new LN name */
+static char*
+copyLnBlock(char* text, const char* lnName, const char* newLnName)
+{
+    int length;
+
+    char* block = findLnBlock(text, lnName, &length);
+
+    if (block == NULL)
+        return NULL;
+
+    char* copy = (char*)malloc(length + strlen(newLnName) + 8);
+
+    if (copy) {
+        int headerLength = (int)strlen(lnName) + 3; /* LN( + name */
+
+        sprintf(copy, "LN(%s", newLnName);
+        strncat(copy, block + headerLength, length - headerLength);
+    }
+
+    return copy;
+}
+
+static void
+removeLnBlock(char* text, const char* lnName)
+{
+    int length;
+
+    char* block = findLnBlock(text, lnName, &length);
+
+    if (block)
+        memmove(block, block + length, strlen(block + length) + 1);
+}
+
+/**
+ * @brief Write the revised model: remove ActPow_FSCH10 and OnOff_FSCC1, add ActPow_FSCH11 and MaxPow_FSCC2
+ */
+static bool
+createRevisedModel(const char* modelFile)
+{
+    char* text = readFile(modelFile);
+
+    if (text == NULL) {
+        printf("ERROR: Failed to read %s\n", modelFile);
+        return false;
+    }
+
+    char* addedSchedule = copyLnBlock(text, "ActPow_FSCH10", "ActPow_FSCH11");
+    char* addedController = copyLnBlock(text, "MaxPow_FSCC1", "MaxPow_FSCC2");
+
+    bool success = false;
+
+    if (addedSchedule && addedController) {
+        removeLnBlock(text, "ActPow_FSCH10");
+        removeLnBlock(text, "OnOff_FSCC1");
+
+        /* insert the new LNs in front of the first LN of the LD */
+        char* firstLn = strstr(text, "LN(");
+
+        FILE* file = fopen(revisedModelFile, "wb");
+
+        if (firstLn && file) {
+            fwrite(text, 1, firstLn - text, file);
+            fputs(addedController, file);
+            fputs(addedSchedule, file);
+            fputs(firstLn, file);
+
+            success = true;
+        }
+
+        if (file)
+            fclose(file);
+    }
+
+    free(addedSchedule);
+    free(addedController);
+    free(text);
+
+    return success;
+}
+
+static DataAttribute*
+getAttribute(IedModel* model, const char* lnName, const char* attributeRef)
+{
+    char objRef[130];
+
+    snprintf(objRef, sizeof(objRef), "Control/%s.%s", lnName, attributeRef);
+
+    DataAttribute* attr = (DataAttribute*)IedModel_getModelNodeByShortObjectReference(model, objRef);
+
+    if (attr == NULL)
+        printf("ERROR: %s not found in the data model\n", objRef);
+
+    return attr;
+}
+
+/* entry n has the value (n + 1) * 100, one entry per second */
+static bool
+configureSchedule(IedModel* model, IedServer server, uint64_t startTime)
+{
+    DataAttribute* numEntr = getAttribute(model, "ActPow_FSCH01", "NumEntr.setVal");
+    DataAttribute* schdIntv = getAttribute(model, "ActPow_FSCH01", "SchdIntv.setVal");
+    DataAttribute* schdPrio = getAttribute(model, "ActPow_FSCH01", "SchdPrio.setVal");
+    DataAttribute* strTm = getAttribute(model, "ActPow_FSCH01", "StrTm01.setTm");
+
+    if ((numEntr == NULL) || (schdIntv == NULL) || (schdPrio == NULL) || (strTm == NULL))
+        return false;
+
+    IedServer_lockDataModel(server);
+
+    IedServer_updateInt32AttributeValue(server, numEntr, NUMBER_OF_ENTRIES);
+    IedServer_updateInt32AttributeValue(server, schdIntv, 1);
+    IedServer_updateInt32AttributeValue(server, schdPrio, 10);
+
+    int i;
+
+    for (i = 0; i < NUMBER_OF_ENTRIES; i++) {
+        char valueRef[40];
+
+        snprintf(valueRef, sizeof(valueRef), "ValASG%03i.setMag.f", i + 1);
+
+        DataAttribute* valueAttr = getAttribute(model, "ActPow_FSCH01", valueRef);
+
+        if (valueAttr)
+            IedServer_updateFloatAttributeValue(server, valueAttr, (float)((i + 1) * 100));
+    }
+
+    IedServer_updateUTCTimeAttributeValue(server, strTm, startTime);
+
+    IedServer_unlockDataModel(server);
+
+    return true;
+}
+
+/* event loop of the application */
+static void
+processUntil(Scheduler sched, uint64_t endTime)
+{
+    uint64_t currentTime;
+
+    while ((currentTime = Hal_getTimeInMs()) < endTime) {
+        Scheduler_process(sched, currentTime);
+
+        Thread_sleep(5);
+    }
+}
+
+static double
+getExpectedValue(uint64_t startTime, uint64_t currentTime)
+{
+    return (double)((((currentTime - startTime) / 1000) + 1) * 100);
+}
+
+static bool
+isActiveSchedule(Scheduler sched, const char* controllerLn, const char* scheduleLn)
+{
+    Scheduler_ScheduleControllerState states[8];
+
+    int numberOfStates = Scheduler_getScheduleControllerStates(sched, states, 8);
+
+    int i;
+
+    for (i = 0; i < numberOfStates; i++) {
+        const char* ln = strrchr(states[i].controllerRef, '/');
+
+        if (ln && (strcmp(ln + 1, controllerLn) == 0)) {
+            ln = strrchr(states[i].activeScheduleRef, '/');
+
+            return (ln && (strcmp(ln + 1, scheduleLn) == 0));
+        }
+    }
+
+    return false;
+}
+
+static DerSchedulerShmRegion*
+mapRegion(size_t* regionSize)
+{
+    int fd = shm_open(shmName, O_RDONLY, 0);
+
+    if (fd == -1)
+        return NULL;
+
+    struct stat st;
+
+    void* region = MAP_FAILED;
+
+    if (fstat(fd, &st) == 0)
+        region = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+
+    close(fd);
+
+    if (region == MAP_FAILED)
+        return NULL;
+
+    *regionSize = st.st_size;
+
+    return (DerSchedulerShmRegion*)region;
+}
+
+/* index of the slot of the controller or -1 */
+static int
+findSlot(DerSchedulerShmRegion* region, const char* controllerLn, DerSchedulerShmSlot* slot)
+{
+    uint32_t i;
+
+    for (i = 0; i < region->numberOfSlots; i++) {
+        DerSchedulerShm_readSlot(region, i, slot);
+
+        const char* ln = strrchr(slot->controllerRef, '/');
+
+        if (ln && (strcmp(ln + 1, controllerLn) == 0))
+            return (int)i;
+    }
+
+    return -1;
+}
+
+static void
+checkRegion(double expectedValue)
+{
+    size_t regionSize;
+
+    DerSchedulerShmRegion* region = mapRegion(&regionSize);
+
+    if (region == NULL) {
+        check(false, "map the shared memory region of the revised model");
+        return;
+    }
+
+    check(DerSchedulerShm_isValid(region), "valid shared memory region");
+    check(region->numberOfSlots == 3, "a slot for each controller of the revised model");
+
+    DerSchedulerShmSlot slot;
+
+    check(findSlot(region, "OnOff_FSCC1", &slot) == -1, "no slot of the removed controller");
+    check(findSlot(region, "MaxPow_FSCC2", &slot) != -1, "slot of the added controller");
+
+    if (findSlot(region, "ActPow_FSCC1", &slot) != -1) {
+        check((slot.quality == QUALITY_VALIDITY_GOOD) && (slot.value == expectedValue), "output of the kept controller");
+        check(strstr(slot.activeScheduleRef, "ActPow_FSCH01") != NULL, "active schedule of the kept controller");
+    }
+    else {
+        check(false, "slot of the kept controller");
+    }
+
+    munmap(region, regionSize);
+}
+
+int
+main(int argc, char** argv)
+{
+    const char* modelFile = (argc > 1) ? argv[1] : "model.cfg";
+
+    if (createRevisedModel(modelFile) == false) {
+        printf("FAILED\n");
+        return 1;
+    }
+
+    IedModel* model = ConfigFileParser_createModelFromConfigFileEx(modelFile);
+    IedModel* revisedModel = ConfigFileParser_createModelFromConfigFileEx(revisedModelFile);
+
+    if ((model == NULL) || (revisedModel == NULL)) {
+        printf("ERROR: Failed to load the data models\n");
+        printf("FAILED\n");
+        return 1;
+    }
+
+    IedServer server = IedServer_create(model);
+    IedServer revisedServer = IedServer_create(revisedModel);
+
+    Scheduler sched = Scheduler_createEx(model, server, SCHEDULER_MODE_EXTERNAL, NULL);
+
+    TargetValues targetValues;
+
+    memset(&targetValues, 0, sizeof(targetValues));
+
+    Scheduler_setTargetValueHandler(sched, targetValueChanged, &targetValues);
+
+    check(Scheduler_enableSharedMemoryPublication(sched, shmName, false), "enable shared memory publication");
+
+    size_t oldRegionSize = 0;
+
+    DerSchedulerShmRegion* oldRegion = mapRegion(&oldRegionSize);
+
+    check(oldRegion && (oldRegion->numberOfSlots == 3), "shared memory region of the old model");
+
+    Scheduler_MemoryReport report;
+
+    Scheduler_getMemoryReport(sched, &report);
+
+    int numberOfSchedules = report.numberOfSchedules;
+
+    uint64_t startTime = Hal_getTimeInMs() + 300;
+
+    check(configureSchedule(model, server, startTime), "configure schedule");
+    check(Scheduler_enableSchedule(sched, scheduleRef, true), "enable schedule");
+
+    /* reconfigure in the middle of the second entry */
+    processUntil(sched, startTime + 1500);
+
+    check(isActiveSchedule(sched, "ActPow_FSCC1", "ActPow_FSCH01"), "active schedule before the reconfiguration");
+
+    int numberOfValues = targetValues.numberOfValues;
+
+    check(Scheduler_reconfigure(sched, revisedModel, revisedServer), "reconfigure");
+
+    /* the old model can be released after the reconfiguration */
+    IedServer_destroy(server);
+    IedModel_destroy(model);
+
+    Scheduler_getMemoryReport(sched, &report);
+
+    check(report.numberOfSchedules == numberOfSchedules, "schedules of the revised model (one removed, one added)");
+    check(report.numberOfScheduleControllers == 3, "controllers of the revised model (one removed, one added)");
+
+    check(isActiveSchedule(sched, "ActPow_FSCC1", "ActPow_FSCH01"), "active schedule after the reconfiguration");
+
+    DataAttribute* actSchdRef = getAttribute(revisedModel, "ActPow_FSCC1", "ActSchdRef.stVal");
+
+    check(actSchdRef && actSchdRef->mmsValue && strstr(MmsValue_toString(actSchdRef->mmsValue), "ActPow_FSCH01"),
+        "ActSchdRef in the revised model");
+
+    if (oldRegion) {
+        check(DerSchedulerShm_isValid(oldRegion) == false, "old shared memory region invalidated");
+        munmap(oldRegion, oldRegionSize);
+    }
+
+    checkRegion(getExpectedValue(startTime, Hal_getTimeInMs()));
+
+    /* the schedule continues with the next entries */
+    processUntil(sched, startTime + 3500);
+
+    check(targetValues.numberOfValues >= numberOfValues + 2, "target values after the reconfiguration");
+    check(targetValues.lastValue == getExpectedValue(startTime, targetValues.lastTimestamp), "target value continues");
+    check(targetValues.numberOfInvalidValues == 0, "no invalid target value while the schedule is running");
+
+    check(isActiveSchedule(sched, "ActPow_FSCC1", "ActPow_FSCH01"), "active schedule keeps running");
+
+    Scheduler_destroy(sched);
+    IedServer_destroy(revisedServer);
+    IedModel_destroy(revisedModel);
+
+    unlink(revisedModelFile);
+
+    bool success = (numberOfFailedChecks == 0);
+
+    printf("%s\n", success ? "PASSED" : "FAILED");
+
+    return success ? 0 : 1;
+}
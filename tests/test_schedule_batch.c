@@ -0,0 +1,288 @@
+/*
+ * Test of the group operations of Scheduler_applyScheduleChanges
+ *
+ * Runs three schedules of ActPow_FSCC1 in external mode. A batch that disables the active schedule
+ * and raises the priority of another one has to result in one selection of the active schedule
+ * (no intermediate target value of the schedule that would be active after the first change). A
+ * batch with a change that cannot be applied (invalid enable, full command queue) must not change
+ * anything.
+ *
+ * Usage: test_schedule_batch [model.cfg]
+ */
+
+#include "der_scheduler.h"
+
+#include <libiec61850/hal_thread.h>
+#include <libiec61850/hal_time.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define NUMBER_OF_ENTRIES 10
+#define MAX_CHANGES 64
+
+static const char* controllerRef = "@Control/ActPow_FSCC1";
+
+typedef struct {
+    IedModel* model;
+    IedServer server;
+    Scheduler sched;
+
+    /* all target value handler calls (also with invalid quality) */
+    int numberOfCalls;
+    bool lastValid;
+    double lastValue;
+} TestContext;
+
+static int numberOfFailedChecks = 0;
+
+static void
+check(bool condition, const char* description)
+{
+    if (condition == false) {
+        printf("ERROR: %s\n", description);
+        numberOfFailedChecks++;
+    }
+}
+
+static void
+targetValueChanged(void* parameter, const char* targetValueObjRef, MmsValue* value, Quality quality, uint64_t timestampMs)
+{
+    TestContext* self = (TestContext*)parameter;
+
+    self->numberOfCalls++;
+    self->lastValid = (value != NULL) && (quality == QUALITY_VALIDITY_GOOD);
+
+    if (self->lastValid) {
+        if (MmsValue_getType(value) == MMS_FLOAT)
+            self->lastValue = MmsValue_toDouble(value);
+        else
+            self->lastValue = (double)MmsValue_toInt64(value);
+    }
+}
+
+static DataAttribute*
+getAttribute(TestContext* self, const char* scheduleLn, const char* attributeRef)
+{
+    char objRef[130];
+
+    snprintf(objRef, sizeof(objRef), "Control/%s.%s", scheduleLn, attributeRef);
+
+    DataAttribute* attr = (DataAttribute*)IedModel_getModelNodeByShortObjectReference(self->model, objRef);
+
+    if (attr == NULL)
+        printf("ERROR: %s not found in the data model\n", objRef);
+
+    return attr;
+}
+
+/* NUMBER_OF_ENTRIES entries of one second with the same value */
+static void
+configureSchedule(TestContext* self, const char* scheduleLn, int prio, float value, uint64_t startTime)
+{
+    DataAttribute* numEntr = getAttribute(self, scheduleLn, "NumEntr.setVal");
+    DataAttribute* schdIntv = getAttribute(self, scheduleLn, "SchdIntv.setVal");
+    DataAttribute* schdPrio = getAttribute(self, scheduleLn, "SchdPrio.setVal");
+    DataAttribute* strTm = getAttribute(self, scheduleLn, "StrTm01.setTm");
+
+    if ((numEntr == NULL) || (schdIntv == NULL) || (schdPrio == NULL) || (strTm == NULL)) {
+        numberOfFailedChecks++;
+        return;
+    }
+
+    IedServer_lockDataModel(self->server);
+
+    IedServer_updateInt32AttributeValue(self->server, numEntr, NUMBER_OF_ENTRIES);
+    IedServer_updateInt32AttributeValue(self->server, schdIntv, 1);
+    IedServer_updateInt32AttributeValue(self->server, schdPrio, prio);
+
+    int i;
+
+    for (i = 0; i < NUMBER_OF_ENTRIES; i++) {
+        char valueRef[40];
+
+        snprintf(valueRef, sizeof(valueRef), "ValASG%03i.setMag.f", i + 1);
+
+        DataAttribute* valueAttr = getAttribute(self, scheduleLn, valueRef);
+
+        if (valueAttr)
+            IedServer_updateFloatAttributeValue(self->server, valueAttr, value);
+    }
+
+    IedServer_updateUTCTimeAttributeValue(self->server, strTm, startTime);
+
+    IedServer_unlockDataModel(self->server);
+}
+
+/* event loop of the application */
+static void
+processUntil(TestContext* self, uint64_t endTime)
+{
+    uint64_t currentTime;
+
+    while ((currentTime = Hal_getTimeInMs()) < endTime) {
+        Scheduler_process(self->sched, currentTime);
+
+        Thread_sleep(5);
+    }
+}
+
+static const char*
+getActiveScheduleRef(TestContext* self)
+{
+    static Scheduler_ScheduleControllerState states[8];
+
+    int numberOfStates = Scheduler_getScheduleControllerStates(self->sched, states, 8);
+
+    int i;
+
+    for (i = 0; i < numberOfStates; i++) {
+        if (strcmp(states[i].controllerRef, controllerRef + 1) == 0)
+            return states[i].activeScheduleRef;
+    }
+
+    return "";
+}
+
+static int
+getSchedulePrio(TestContext* self, const char* scheduleLn)
+{
+    Scheduler_ScheduleState states[64];
+
+    int numberOfStates = Scheduler_getScheduleStates(self->sched, states, 64);
+
+    int i;
+
+    for (i = 0; i < numberOfStates; i++) {
+        const char* ln = strrchr(states[i].scheduleRef, '/');
+
+        if (ln && (strcmp(ln + 1, scheduleLn) == 0))
+            return states[i].prio;
+    }
+
+    return -1;
+}
+
+static bool
+isActiveSchedule(TestContext* self, const char* scheduleLn)
+{
+    const char* ln = strrchr(getActiveScheduleRef(self), '/');
+
+    return (ln && (strcmp(ln + 1, scheduleLn) == 0));
+}
+
+int
+main(int argc, char** argv)
+{
+    const char* modelFile = (argc > 1) ? argv[1] : "model.cfg";
+
+    TestContext* self = (TestContext*)calloc(1, sizeof(TestContext));
+
+    self->model = ConfigFileParser_createModelFromConfigFileEx(modelFile);
+
+    if (self->model == NULL) {
+        printf("ERROR: Failed to load data model %s\n", modelFile);
+        free(self);
+        return 1;
+    }
+
+    self->server = IedServer_create(self->model);
+
+    self->sched = Scheduler_createEx(self->model, self->server, SCHEDULER_MODE_EXTERNAL, NULL);
+
+    Scheduler_setTargetValueHandler(self->sched, targetValueChanged, self);
+
+    /* the entries of a schedule have the same value -> only a change of the active schedule changes the target */
+    Scheduler_TargetValueFilter filter;
+
+    memset(&filter, 0, sizeof(filter));
+
+    filter.suppressEqualValues = true;
+
+    check(Scheduler_setTargetValueFilter(self->sched, controllerRef, &filter), "set target value filter");
+
+    uint64_t startTime = Hal_getTimeInMs() + 300;
+
+    configureSchedule(self, "ActPow_FSCH01", 30, 100, startTime);
+    configureSchedule(self, "ActPow_FSCH02", 20, 200, startTime);
+    configureSchedule(self, "ActPow_FSCH03", 10, 300, startTime);
+
+    check(Scheduler_enableSchedule(self->sched, "@Control/ActPow_FSCH01", true), "enable FSCH01");
+    check(Scheduler_enableSchedule(self->sched, "@Control/ActPow_FSCH02", true), "enable FSCH02");
+    check(Scheduler_enableSchedule(self->sched, "@Control/ActPow_FSCH03", true), "enable FSCH03");
+
+    processUntil(self, startTime + 500);
+
+    check(isActiveSchedule(self, "ActPow_FSCH01") && self->lastValid && (self->lastValue == 100),
+        "highest priority active before the batch");
+
+    /* one-by-one: FSCH02 (200) would be active after the disable, then FSCH03 (300) after the priority change */
+    Scheduler_ScheduleChange changes[MAX_CHANGES];
+
+    memset(changes, 0, sizeof(changes));
+
+    changes[0].scheduleRef = "@Control/ActPow_FSCH01";
+    changes[0].type = SCHED_CHANGE_DISABLE;
+    changes[1].scheduleRef = "@Control/ActPow_FSCH03";
+    changes[1].type = SCHED_CHANGE_SET_PRIO;
+    changes[1].prio = 40;
+
+    self->numberOfCalls = 0;
+
+    check(Scheduler_applyScheduleChanges(self->sched, changes, 2), "apply batch");
+
+    processUntil(self, startTime + 1000);
+
+    check(self->numberOfCalls == 1, "one target value change for the batch");
+    check(self->lastValid && (self->lastValue == 300), "target value after the batch");
+    check(isActiveSchedule(self, "ActPow_FSCH03"), "ActSchdRef after the batch");
+    check(getSchedulePrio(self, "ActPow_FSCH03") == 40, "priority changed by the batch");
+
+    /* FSCH04 is not configured (SchdIntv = 0) -> the disable of FSCH03 is not applied either */
+    changes[0].scheduleRef = "@Control/ActPow_FSCH03";
+    changes[0].type = SCHED_CHANGE_DISABLE;
+    changes[1].scheduleRef = "@Control/ActPow_FSCH04";
+    changes[1].type = SCHED_CHANGE_ENABLE;
+
+    self->numberOfCalls = 0;
+
+    check(Scheduler_applyScheduleChanges(self->sched, changes, 2) == false, "batch with invalid enable rejected");
+
+    processUntil(self, startTime + 1500);
+
+    check(self->numberOfCalls == 0, "no target value change for a rejected batch");
+    check(isActiveSchedule(self, "ActPow_FSCH03"), "ActSchdRef unchanged by a rejected batch");
+
+    /* more changes of one schedule than its command queue can hold */
+    int i;
+
+    changes[0].scheduleRef = "@Control/ActPow_FSCH03";
+    changes[0].type = SCHED_CHANGE_DISABLE;
+
+    for (i = 1; i < MAX_CHANGES; i++) {
+        changes[i].scheduleRef = "@Control/ActPow_FSCH02";
+        changes[i].type = SCHED_CHANGE_SET_PRIO;
+        changes[i].prio = 50;
+    }
+
+    check(Scheduler_applyScheduleChanges(self->sched, changes, MAX_CHANGES) == false, "batch larger than the command queue rejected");
+
+    processUntil(self, startTime + 2000);
+
+    check(self->numberOfCalls == 0, "no target value change for a batch without queue space");
+    check(isActiveSchedule(self, "ActPow_FSCH03"), "ActSchdRef unchanged without queue space");
+    check(getSchedulePrio(self, "ActPow_FSCH02") == 20, "priority unchanged without queue space");
+
+    Scheduler_destroy(self->sched);
+    IedServer_destroy(self->server);
+    IedModel_destroy(self->model);
+
+    free(self);
+
+    bool success = (numberOfFailedChecks == 0);
+
+    printf("%s\n", success ? "PASSED" : "FAILED");
+
+    return success ? 0 : 1;
+}
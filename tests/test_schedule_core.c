@@ -0,0 +1,267 @@
+/*
+ * Test of the protocol independent schedule core
+ *
+ * Runs schedules with a virtual clock: start time lookup with the cursor, entry changes (also with
+ * variable entry durations), the end of a schedule with and without another start time, the
+ * deadlines and the selection of the active schedule by priority.
+ *
+ * Usage: test_schedule_core
+ */
+
+#include "schedule_core.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static int numberOfFailedChecks = 0;
+
+static void
+check(bool condition, const char* description)
+{
+    if (condition == false) {
+        printf("ERROR: %s\n", description);
+        numberOfFailedChecks++;
+    }
+}
+
+static void
+testFindNextStartTime(void)
+{
+    const uint64_t startTimes[] = { 100, 200, 300 };
+
+    int cursor = 0;
+
+    check(ScheduleCore_findNextStartTime(startTimes, 3, &cursor, 50) == 100, "first start time in the future");
+    check(cursor == 0, "cursor stays at the first start time in the future");
+
+    /* a start time equal to the current time is in the past */
+    check(ScheduleCore_findNextStartTime(startTimes, 3, &cursor, 100) == 200, "start time at the current time skipped");
+    check(cursor == 1, "cursor moved behind the past start time");
+
+    check(ScheduleCore_findNextStartTime(startTimes, 3, &cursor, 150) == 200, "repeated lookup");
+    check(cursor == 1, "cursor unchanged by a repeated lookup");
+
+    check(ScheduleCore_findNextStartTime(startTimes, 3, &cursor, 300) == 0, "no start time in the future");
+    check(cursor == 3, "cursor behind all start times");
+
+    /* the cursor only moves forward */
+    check(ScheduleCore_findNextStartTime(startTimes, 3, &cursor, 0) == 0, "past start times are not checked again");
+
+    cursor = 0;
+
+    check(ScheduleCore_findNextStartTime(startTimes, 0, &cursor, 0) == 0, "empty start time list");
+}
+
+static void
+testGetEntryIndex(void)
+{
+    check(ScheduleCore_getEntryIndex(1000, 10, 3, 999) == -1, "entry index before the start");
+    check(ScheduleCore_getEntryIndex(1000, 10, 3, 1000) == 0, "entry index at the start");
+    check(ScheduleCore_getEntryIndex(1000, 10, 3, 1019) == 1, "entry index of the second entry");
+    check(ScheduleCore_getEntryIndex(1000, 10, 3, 1030) == -1, "entry index after the end");
+    check(ScheduleCore_getEntryIndex(1000, 0, 3, 1000) == -1, "entry index without interval");
+}
+
+static void
+testScheduleRun(void)
+{
+    const double values[] = { 1.0, 2.0, 3.0 };
+    const uint64_t startTimes[] = { 1000, 2000 };
+
+    ScheduleCore schedule;
+
+    memset(&schedule, 0, sizeof(schedule));
+
+    schedule.values = values;
+    schedule.numberOfValues = 3;
+    schedule.intervalInMs = 10;
+    schedule.startTimes = startTimes;
+    schedule.numberOfStartTimes = 2;
+
+    ScheduleCore_initialize(&schedule);
+
+    check(ScheduleCore_enable(&schedule, 0), "enable schedule");
+    check(schedule.state == SCHEDULE_CORE_STATE_READY, "state READY after enable");
+    check(ScheduleCore_getNextDeadline(&schedule, 0) == 1001, "deadline after the start time");
+
+    check(ScheduleCore_process(&schedule, 1000) == SCHEDULE_CORE_EVENT_NONE, "no start at the start time");
+    check(ScheduleCore_process(&schedule, 1001) == SCHEDULE_CORE_EVENT_STARTED, "start after the start time");
+    check(schedule.nextStartTime == 2000, "next start time while running");
+
+    check(ScheduleCore_process(&schedule, 1001) == SCHEDULE_CORE_EVENT_ENTRY_CHANGED, "first entry");
+    check((schedule.currentEntryIdx == 0) && (schedule.value == 1.0), "value of the first entry");
+    check(ScheduleCore_process(&schedule, 1001) == SCHEDULE_CORE_EVENT_NONE, "one event per entry");
+    check(ScheduleCore_getNextDeadline(&schedule, 1001) == 1010, "deadline at the end of the first entry");
+
+    check(ScheduleCore_process(&schedule, 1025) == SCHEDULE_CORE_EVENT_ENTRY_CHANGED, "entry skipped by a late call");
+    check((schedule.currentEntryIdx == 2) && (schedule.value == 3.0), "value of the last entry");
+
+    check(ScheduleCore_process(&schedule, 1030) == SCHEDULE_CORE_EVENT_ENDED, "end of the first run");
+    check((schedule.state == SCHEDULE_CORE_STATE_READY) && (schedule.nextStartTime == 2000), "READY for the next start time");
+
+    check(ScheduleCore_process(&schedule, 2001) == SCHEDULE_CORE_EVENT_STARTED, "second run");
+    check(schedule.nextStartTime == 0, "no start time after the second run");
+
+    check(ScheduleCore_process(&schedule, 2040) == SCHEDULE_CORE_EVENT_ENDED, "end of the second run");
+    check(schedule.state == SCHEDULE_CORE_STATE_NOT_READY, "NOT_READY without start time");
+    check(ScheduleCore_getNextDeadline(&schedule, 2040) == 0, "no deadline after the end");
+
+    /* all start times in the past */
+    check(ScheduleCore_enable(&schedule, 3000) == false, "enable without start time in the future");
+    check(schedule.state == SCHEDULE_CORE_STATE_START_TIME_REQUIRED, "state START_TIME_REQUIRED");
+
+    /* invalid parameters */
+    schedule.intervalInMs = 0;
+
+    check(ScheduleCore_enable(&schedule, 0) == false, "enable without interval");
+    check(schedule.state == SCHEDULE_CORE_STATE_NOT_READY, "state NOT_READY for invalid parameters");
+}
+
+static void
+processSchedule(ScheduleCore* schedule, uint64_t currentTime)
+{
+    while (ScheduleCore_process(schedule, currentTime) != SCHEDULE_CORE_EVENT_NONE);
+}
+
+static void
+testVariableEntryDurations(void)
+{
+    /* entries of 10, 5, 20 and 1 ms */
+    const uint64_t entryEndOffsets[] = { 10, 15, 35, 36 };
+
+    int cursor = -1;
+
+    check(ScheduleCore_findEntryIndex(entryEndOffsets, 4, 0, &cursor) == 0, "first entry without cursor");
+    check(ScheduleCore_findEntryIndex(entryEndOffsets, 4, 9, &cursor) == 0, "end of the first entry");
+    check(ScheduleCore_findEntryIndex(entryEndOffsets, 4, 10, &cursor) == 1, "next entry at the end offset");
+    check(cursor == 1, "cursor at the found entry");
+    check(ScheduleCore_findEntryIndex(entryEndOffsets, 4, 34, &cursor) == 2, "entry after the cursor");
+    check(ScheduleCore_findEntryIndex(entryEndOffsets, 4, 35, &cursor) == 3, "short last entry");
+    check(ScheduleCore_findEntryIndex(entryEndOffsets, 4, 36, &cursor) == -1, "end of the schedule");
+
+    /* offsets that are not covered by the cursor and the next entry (binary search) */
+    cursor = 0;
+
+    check(ScheduleCore_findEntryIndex(entryEndOffsets, 4, 20, &cursor) == 2, "search forward");
+    check(ScheduleCore_findEntryIndex(entryEndOffsets, 4, 3, &cursor) == 0, "search backward");
+    check(ScheduleCore_findEntryIndex(entryEndOffsets, 4, 12, NULL) == 1, "search without cursor");
+
+    /* schedule run with variable durations */
+    const double values[] = { 1.0, 2.0, 3.0, 4.0 };
+    const uint64_t startTime = 1000;
+
+    ScheduleCore schedule;
+
+    memset(&schedule, 0, sizeof(schedule));
+
+    schedule.values = values;
+    schedule.numberOfValues = 4;
+    schedule.entryEndOffsets = entryEndOffsets;
+    schedule.startTimes = &startTime;
+    schedule.numberOfStartTimes = 1;
+
+    ScheduleCore_initialize(&schedule);
+
+    check(ScheduleCore_enable(&schedule, 0), "enable schedule with variable durations");
+
+    processSchedule(&schedule, 1001);
+
+    check((schedule.currentEntryIdx == 0) && (schedule.value == 1.0), "first entry with variable durations");
+    check(ScheduleCore_getNextDeadline(&schedule, 1001) == 1010, "deadline at the end of the first entry");
+
+    processSchedule(&schedule, 1015);
+
+    check((schedule.currentEntryIdx == 2) && (schedule.value == 3.0), "third entry with variable durations");
+    check(ScheduleCore_getNextDeadline(&schedule, 1015) == 1035, "deadline at the end of the third entry");
+
+    processSchedule(&schedule, 1036);
+
+    check(schedule.state == SCHEDULE_CORE_STATE_NOT_READY, "end of the schedule with variable durations");
+}
+
+static void
+initializeSchedule(ScheduleCore* schedule, const double* values, const uint64_t* startTime, int prio)
+{
+    memset(schedule, 0, sizeof(ScheduleCore));
+
+    schedule->values = values;
+    schedule->numberOfValues = 1;
+    schedule->intervalInMs = 1000;
+    schedule->startTimes = startTime;
+    schedule->numberOfStartTimes = 1;
+    schedule->prio = prio;
+
+    ScheduleCore_initialize(schedule);
+    ScheduleCore_enable(schedule, 0);
+}
+
+static void
+testController(void)
+{
+    const double lowValues[] = { 10.0 };
+    const double highValues[] = { 20.0 };
+    const double equalValues[] = { 30.0 };
+
+    const uint64_t lowStart = 100;
+    const uint64_t highStart = 200;
+    const uint64_t equalStart = 300;
+
+    ScheduleCore low;
+    ScheduleCore high;
+    ScheduleCore equal;
+
+    initializeSchedule(&low, lowValues, &lowStart, 10);
+    initializeSchedule(&high, highValues, &highStart, 20);
+    initializeSchedule(&equal, equalValues, &equalStart, 20);
+
+    ScheduleCore* schedules[] = { &low, &high, &equal };
+
+    ScheduleControllerCore controller;
+
+    memset(&controller, 0, sizeof(controller));
+
+    controller.schedules = schedules;
+    controller.numberOfSchedules = 3;
+
+    check(ScheduleControllerCore_update(&controller) == false, "no change without running schedule");
+    check(controller.hasOutput == false, "no output without running schedule");
+
+    uint64_t currentTime;
+
+    for (currentTime = 0; currentTime <= 1400; currentTime += 50) {
+        processSchedule(&low, currentTime);
+        processSchedule(&high, currentTime);
+        processSchedule(&equal, currentTime);
+
+        ScheduleControllerCore_update(&controller);
+
+        if ((currentTime > 100) && (currentTime <= 200))
+            check((controller.activeSchedule == &low) && (controller.output == 10.0), "only running schedule is active");
+        else if ((currentTime > 200) && (currentTime < 1200))
+            check((controller.activeSchedule == &high) && (controller.output == 20.0), "higher priority is active");
+        else if ((currentTime >= 1200) && (currentTime < 1300))
+            check((controller.activeSchedule == &equal) && (controller.output == 30.0), "remaining schedule is active");
+        else if (currentTime >= 1300)
+            check((controller.activeSchedule == NULL) && (controller.hasOutput == false), "no active schedule after the end");
+    }
+
+    check(ScheduleCore_hasPrecedence(21, 20), "higher priority has precedence");
+    check(ScheduleCore_hasPrecedence(20, 20) == false, "equal priority keeps the active schedule");
+}
+
+int
+main(int argc, char** argv)
+{
+    testFindNextStartTime();
+    testGetEntryIndex();
+    testScheduleRun();
+    testVariableEntryDurations();
+    testController();
+
+    bool success = (numberOfFailedChecks == 0);
+
+    printf("%s\n", success ? "PASSED" : "FAILED");
+
+    return success ? 0 : 1;
+}
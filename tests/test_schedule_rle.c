@@ -0,0 +1,197 @@
+/*
+ * Test of the run-length compressed schedule values
+ *
+ * Encodes schedules with integer, float and double values, decodes them in ascending and random
+ * order and runs a schedule core with the compressed values. Checks the size of a typical day-ahead
+ * schedule, too small buffers and invalid data.
+ *
+ * Usage: test_schedule_rle
+ */
+
+#include "schedule_core.h"
+#include "schedule_rle.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define DAY_AHEAD_ENTRIES 1440
+
+static int numberOfFailedChecks = 0;
+
+static void
+check(bool condition, const char* description)
+{
+    if (condition == false) {
+        printf("ERROR: %s\n", description);
+        numberOfFailedChecks++;
+    }
+}
+
+static bool
+decodesTo(const uint8_t* data, int size, const double* values, int numberOfValues)
+{
+    ScheduleRleReader reader;
+
+    if (ScheduleRleReader_initialize(&reader, data, size) == false)
+        return false;
+
+    if (ScheduleRleReader_getNumberOfValues(&reader) != numberOfValues)
+        return false;
+
+    int i;
+
+    for (i = 0; i < numberOfValues; i++) {
+        double value;
+
+        if ((ScheduleRleReader_getValue(&reader, i, &value) == false) || (value != values[i]))
+            return false;
+    }
+
+    return true;
+}
+
+static void
+testRoundTrip(void)
+{
+    /* runs of integers (positive and negative deltas), floats and doubles */
+    const double values[] = { 0, 0, 0, 1000, 1000, -250, 12.5, 12.5, 0.1, 0.1, 4e15, 7, 7, 7 };
+    const int numberOfValues = sizeof(values) / sizeof(values[0]);
+
+    uint8_t buffer[SCHEDULE_RLE_MAX_ENCODED_SIZE(14)];
+
+    int size = ScheduleRle_encode(values, numberOfValues, buffer, sizeof(buffer));
+
+    check(size > SCHEDULE_RLE_HEADER_SIZE, "encode mixed values");
+    check(decodesTo(buffer, size, values, numberOfValues), "decode mixed values");
+
+    /* random access - a smaller index restarts the decoding */
+    ScheduleRleReader reader;
+
+    ScheduleRleReader_initialize(&reader, buffer, size);
+
+    double value;
+
+    check(ScheduleRleReader_getValue(&reader, 12, &value) && (value == 7), "access to the last run");
+    check(ScheduleRleReader_getValue(&reader, 8, &value) && (value == 0.1), "backward access");
+    check(ScheduleRleReader_getValue(&reader, 0, &value) && (value == 0), "access to the first value");
+    check(ScheduleRleReader_getValue(&reader, numberOfValues, &value) == false, "index out of range");
+    check(ScheduleRleReader_getValue(&reader, -1, &value) == false, "negative index");
+
+    /* empty schedule */
+    size = ScheduleRle_encode(NULL, 0, buffer, sizeof(buffer));
+
+    check(size == SCHEDULE_RLE_HEADER_SIZE, "encode empty schedule");
+    check(decodesTo(buffer, size, NULL, 0), "decode empty schedule");
+}
+
+static void
+testDayAheadSchedule(void)
+{
+    double values[DAY_AHEAD_ENTRIES];
+
+    int i;
+
+    /* setpoint changes every hour (24 runs) */
+    for (i = 0; i < DAY_AHEAD_ENTRIES; i++)
+        values[i] = 1000 + ((i / 60) * 50);
+
+    uint8_t* buffer = (uint8_t*)malloc(SCHEDULE_RLE_MAX_ENCODED_SIZE(DAY_AHEAD_ENTRIES));
+
+    int size = ScheduleRle_encode(values, DAY_AHEAD_ENTRIES, buffer, SCHEDULE_RLE_MAX_ENCODED_SIZE(DAY_AHEAD_ENTRIES));
+
+    printf("INFO: %i values encoded in %i bytes\n", DAY_AHEAD_ENTRIES, size);
+
+    check((size > 0) && (size < 128), "size of a day-ahead schedule");
+    check(decodesTo(buffer, size, values, DAY_AHEAD_ENTRIES), "decode day-ahead schedule");
+
+    /* too small buffer */
+    check(ScheduleRle_encode(values, DAY_AHEAD_ENTRIES, buffer, size - 1) == -1, "buffer too small");
+
+    free(buffer);
+}
+
+static void
+testInvalidData(void)
+{
+    const double values[] = { 1.5, 1.5, 2.5 };
+
+    uint8_t buffer[SCHEDULE_RLE_MAX_ENCODED_SIZE(3)];
+
+    int size = ScheduleRle_encode(values, 3, buffer, sizeof(buffer));
+
+    ScheduleRleReader reader;
+
+    check(ScheduleRleReader_initialize(&reader, buffer, SCHEDULE_RLE_HEADER_SIZE - 1) == false, "truncated header");
+
+    buffer[0] = SCHEDULE_RLE_VERSION + 1;
+
+    check(ScheduleRleReader_initialize(&reader, buffer, size) == false, "unknown version");
+
+    buffer[0] = SCHEDULE_RLE_VERSION;
+
+    /* last run is cut off */
+    double value;
+
+    check(ScheduleRleReader_initialize(&reader, buffer, size - 2), "header of truncated data");
+    check(ScheduleRleReader_getValue(&reader, 0, &value) && (value == 1.5), "value before the truncated run");
+    check(ScheduleRleReader_getValue(&reader, 2, &value) == false, "value of the truncated run");
+}
+
+static void
+testCompressedSchedule(void)
+{
+    const double values[] = { 10, 10, 20, 20, 20, 30 };
+    const uint64_t startTime = 1000;
+
+    uint8_t buffer[SCHEDULE_RLE_MAX_ENCODED_SIZE(6)];
+
+    int size = ScheduleRle_encode(values, 6, buffer, sizeof(buffer));
+
+    ScheduleRleReader reader;
+
+    ScheduleRleReader_initialize(&reader, buffer, size);
+
+    ScheduleCore schedule;
+
+    memset(&schedule, 0, sizeof(schedule));
+
+    schedule.compressedValues = &reader;
+    schedule.intervalInMs = 10;
+    schedule.startTimes = &startTime;
+    schedule.numberOfStartTimes = 1;
+
+    ScheduleCore_initialize(&schedule);
+
+    check(ScheduleCore_enable(&schedule, 0), "enable schedule with compressed values");
+    check(schedule.numberOfValues == 6, "number of compressed values");
+
+    uint64_t currentTime;
+
+    for (currentTime = 1001; currentTime < 1060; currentTime += 10) {
+        while (ScheduleCore_process(&schedule, currentTime) != SCHEDULE_CORE_EVENT_NONE);
+
+        int idx = (int)((currentTime - 1000) / 10);
+
+        check((schedule.currentEntryIdx == idx) && (schedule.value == values[idx]), "value of compressed schedule");
+    }
+
+    while (ScheduleCore_process(&schedule, 1061) != SCHEDULE_CORE_EVENT_NONE);
+
+    check(schedule.state == SCHEDULE_CORE_STATE_NOT_READY, "end of compressed schedule");
+}
+
+int
+main(int argc, char** argv)
+{
+    testRoundTrip();
+    testDayAheadSchedule();
+    testInvalidData();
+    testCompressedSchedule();
+
+    bool success = (numberOfFailedChecks == 0);
+
+    printf("%s\n", success ? "PASSED" : "FAILED");
+
+    return success ? 0 : 1;
+}
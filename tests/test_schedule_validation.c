@@ -0,0 +1,166 @@
+/*
+ * Test of the validation of the schedule parameters
+ *
+ * The validation results are cached until NumEntr, SchdIntv or the entry durations change. The test
+ * changes the parameters locally in the data model (like the application) and with
+ * Scheduler_setScheduleEntryDurations between the enable requests and checks that every change is
+ * taken into account.
+ *
+ * Usage: test_schedule_validation [model.cfg]
+ */
+
+#include "der_scheduler.h"
+
+#include <libiec61850/hal_time.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const char* scheduleRef = "@Control/ActPow_FSCH01";
+static const char* scheduleLn = "ActPow_FSCH01";
+
+static int numberOfFailedChecks = 0;
+
+static void
+check(bool condition, const char* description)
+{
+    if (condition == false) {
+        printf("ERROR: %s\n", description);
+        numberOfFailedChecks++;
+    }
+}
+
+static DataAttribute*
+getAttribute(IedModel* model, const char* attributeRef)
+{
+    char objRef[130];
+
+    snprintf(objRef, sizeof(objRef), "Control/%s.%s", scheduleLn, attributeRef);
+
+    DataAttribute* attr = (DataAttribute*)IedModel_getModelNodeByShortObjectReference(model, objRef);
+
+    if (attr == NULL)
+        printf("ERROR: %s not found in the data model\n", objRef);
+
+    return attr;
+}
+
+static void
+setIntParameter(IedModel* model, IedServer server, const char* attributeRef, int value)
+{
+    DataAttribute* attr = getAttribute(model, attributeRef);
+
+    if (attr) {
+        IedServer_lockDataModel(server);
+        IedServer_updateInt32AttributeValue(server, attr, value);
+        IedServer_unlockDataModel(server);
+    }
+}
+
+static void
+setStartTime(IedModel* model, IedServer server, uint64_t startTime)
+{
+    DataAttribute* attr = getAttribute(model, "StrTm01.setTm");
+
+    if (attr) {
+        IedServer_lockDataModel(server);
+        IedServer_updateUTCTimeAttributeValue(server, attr, startTime);
+        IedServer_unlockDataModel(server);
+    }
+}
+
+static int
+getScheduleState(Scheduler sched)
+{
+    Scheduler_ScheduleState states[64];
+
+    int numberOfStates = Scheduler_getScheduleStates(sched, states, 64);
+
+    int i;
+
+    for (i = 0; i < numberOfStates; i++) {
+        /* the reference contains the IED name */
+        const char* ln = strrchr(states[i].scheduleRef, '/');
+
+        if (ln && (strcmp(ln + 1, scheduleLn) == 0))
+            return states[i].state;
+    }
+
+    return -1;
+}
+
+int
+main(int argc, char** argv)
+{
+    const char* modelFile = (argc > 1) ? argv[1] : "model.cfg";
+
+    IedModel* model = ConfigFileParser_createModelFromConfigFileEx(modelFile);
+
+    if (model == NULL) {
+        printf("ERROR: Failed to load data model %s\n", modelFile);
+        return 1;
+    }
+
+    IedServer server = IedServer_create(model);
+
+    /* external mode - the enable requests are executed by the calling thread */
+    Scheduler sched = Scheduler_createEx(model, server, SCHEDULER_MODE_EXTERNAL, NULL);
+
+    uint64_t currentTime = Hal_getTimeInMs();
+
+    setIntParameter(model, server, "SchdPrio.setVal", 10);
+    setIntParameter(model, server, "SchdIntv.setVal", 1);
+    setIntParameter(model, server, "NumEntr.setVal", 0);
+    setStartTime(model, server, currentTime + 60000);
+
+    check(Scheduler_enableSchedule(sched, scheduleRef, true) == false, "enable without entries");
+    check(getScheduleState(sched) == 1, "NOT_READY without entries");
+
+    /* NumEntr changed in the data model */
+    setIntParameter(model, server, "NumEntr.setVal", 2);
+
+    check(Scheduler_enableSchedule(sched, scheduleRef, true), "enable after NumEntr changed");
+    check(getScheduleState(sched) == 3, "READY after NumEntr changed");
+
+    /* more entries than schedule values */
+    Scheduler_enableSchedule(sched, scheduleRef, false);
+
+    setIntParameter(model, server, "NumEntr.setVal", 100000);
+
+    check(Scheduler_enableSchedule(sched, scheduleRef, true) == false, "enable with too many entries");
+
+    setIntParameter(model, server, "NumEntr.setVal", 2);
+
+    /* SchdIntv changed in the data model */
+    setIntParameter(model, server, "SchdIntv.setVal", 0);
+
+    check(Scheduler_enableSchedule(sched, scheduleRef, true) == false, "enable without interval");
+
+    setIntParameter(model, server, "SchdIntv.setVal", 1);
+
+    check(Scheduler_enableSchedule(sched, scheduleRef, true), "enable after SchdIntv changed");
+
+    /* the schedule (2 x 1 s) would have ended before the current time */
+    Scheduler_enableSchedule(sched, scheduleRef, false);
+
+    setStartTime(model, server, currentTime - 3000);
+
+    check(Scheduler_enableSchedule(sched, scheduleRef, true) == false, "enable with consumed start time");
+
+    /* longer entries -> the schedule is still running at the current time */
+    int durations[] = { 5000, 5000 };
+
+    check(Scheduler_setScheduleEntryDurations(sched, scheduleRef, durations, 2), "set entry durations");
+    check(Scheduler_enableSchedule(sched, scheduleRef, true), "enable after the entry durations changed");
+
+    Scheduler_destroy(sched);
+    IedServer_destroy(server);
+    IedModel_destroy(model);
+
+    bool success = (numberOfFailedChecks == 0);
+
+    printf("%s\n", success ? "PASSED" : "FAILED");
+
+    return success ? 0 : 1;
+}
@@ -0,0 +1,329 @@
+/*
+ * Test of the applied setpoint history
+ *
+ * Checks the range queries (record active at the start of the range, end of the range, ring
+ * overflow, timestamps of a clock that went backwards), the continuation of a file backed history
+ * and concurrent readers while the writer appends records and overwrites the oldest ones.
+ *
+ * Usage: test_setpoint_history
+ */
+
+#include "der_scheduler_internal.h"
+
+#include <libiec61850/hal_thread.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define NUMBER_OF_READERS 2
+#define CONCURRENT_CAPACITY 256
+#define CONCURRENT_RECORDS 200000
+#define QUERY_RANGE 10000 /* longer than the ring */
+
+static const char* historyFile = "test_setpoint_history.bin";
+
+static SetpointHistory history;
+static bool writerRunning = false;
+static int appendedRecords = 0;
+
+typedef struct {
+    int queries;
+    int errors;
+} ReaderResult;
+
+/* record n has the timestamp 1000 + n * 10 and the value n */
+static void
+appendRecords(SetpointHistory self, int first, int count)
+{
+    int n;
+
+    for (n = first; n < first + count; n++)
+        SetpointHistory_append(self, 1000 + ((uint64_t)n * 10), (double)n, QUALITY_VALIDITY_GOOD, n % 3);
+}
+
+static bool
+checkQuery(SetpointHistory self, uint64_t startTime, uint64_t endTime, int maxRecords, int expectedFirst, int expectedCount)
+{
+    Scheduler_SetpointRecord records[64];
+
+    int count = SetpointHistory_query(self, startTime, endTime, records, maxRecords);
+
+    if (count != expectedCount) {
+        printf("ERROR: Query [%llu, %llu): %i records instead of %i\n", (unsigned long long)startTime,
+            (unsigned long long)endTime, count, expectedCount);
+        return false;
+    }
+
+    int i;
+
+    for (i = 0; i < count; i++) {
+        int n = expectedFirst + i;
+
+        if ((records[i].value != (double)n) || (records[i].timestamp != 1000 + ((uint64_t)n * 10)) ||
+            (records[i].quality != QUALITY_VALIDITY_GOOD) || (records[i].source != (n % 3)))
+        {
+            printf("ERROR: Query [%llu, %llu): record %i has value %f instead of %i\n", (unsigned long long)startTime,
+                (unsigned long long)endTime, i, records[i].value, n);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static bool
+testRangeQueries(void)
+{
+    SetpointHistory self = SetpointHistory_create(16, NULL);
+
+    if (self == NULL) {
+        printf("ERROR: Failed to create setpoint history\n");
+        return false;
+    }
+
+    bool success = true;
+
+    success &= checkQuery(self, 0, UINT64_MAX, 64, 0, 0);
+
+    /* records 0 - 9: timestamps 1000 - 1090 */
+    appendRecords(self, 0, 10);
+
+    /* starts with the record that was active at the start time */
+    success &= checkQuery(self, 1025, 1065, 64, 2, 5);
+    success &= checkQuery(self, 1020, 1060, 64, 2, 4);
+
+    /* range before the first record starts with the oldest record */
+    success &= checkQuery(self, 0, 1015, 64, 0, 2);
+    success &= checkQuery(self, 0, 1000, 64, 0, 0);
+
+    /* the newest record stays active after its timestamp */
+    success &= checkQuery(self, 5000, 6000, 64, 9, 1);
+
+    /* limited number of records */
+    success &= checkQuery(self, 0, UINT64_MAX, 3, 0, 3);
+
+    /* ring overflow: records 0 - 99 -> the oldest readable record is 100 - 16 + 1 */
+    appendRecords(self, 10, 90);
+
+    success &= checkQuery(self, 0, UINT64_MAX, 64, 85, 15);
+    success &= checkQuery(self, 1905, 1935, 64, 90, 4);
+
+    /* a timestamp of a clock that went backwards is raised to the previous timestamp */
+    SetpointHistory_append(self, 500, 100.0, QUALITY_VALIDITY_GOOD, 0);
+
+    Scheduler_SetpointRecord records[64];
+
+    int count = SetpointHistory_query(self, 1985, UINT64_MAX, records, 64);
+
+    if ((count != 3) || (records[2].timestamp != 1990) || (records[2].value != 100.0)) {
+        printf("ERROR: Record with older timestamp not sorted in (%i records)\n", count);
+        success = false;
+    }
+
+    SetpointHistory_destroy(self);
+
+    return success;
+}
+
+static bool
+testFileContinuation(void)
+{
+    unlink(historyFile);
+
+    SetpointHistory self = SetpointHistory_create(32, historyFile);
+
+    if (self == NULL) {
+        printf("ERROR: Failed to create setpoint history file\n");
+        return false;
+    }
+
+    appendRecords(self, 0, 20);
+
+    SetpointHistory_destroy(self);
+
+    bool success = true;
+
+    /* same capacity -> continue the history */
+    self = SetpointHistory_create(32, historyFile);
+
+    if (self) {
+        appendRecords(self, 20, 5);
+
+        success &= checkQuery(self, 0, UINT64_MAX, 64, 0, 25);
+
+        SetpointHistory_destroy(self);
+    }
+    else {
+        success = false;
+    }
+
+    /* different capacity -> start with an empty history */
+    self = SetpointHistory_create(64, historyFile);
+
+    if (self) {
+        success &= checkQuery(self, 0, UINT64_MAX, 64, 0, 0);
+
+        SetpointHistory_destroy(self);
+    }
+    else {
+        success = false;
+    }
+
+    unlink(historyFile);
+
+    return success;
+}
+
+static void*
+writerThread(void* parameter)
+{
+    int n;
+
+    for (n = 0; n < CONCURRENT_RECORDS; n++) {
+        appendRecords(history, n, 1);
+
+        __atomic_store_n(&appendedRecords, n + 1, __ATOMIC_RELEASE);
+
+        /* let the readers run while the ring is overwritten (also on a single CPU) */
+        if ((n % 256) == 0)
+            Thread_sleep(0);
+    }
+
+    return NULL;
+}
+
+typedef struct {
+    uint64_t endTime;
+    uint64_t lastTimestamp;
+    int numberOfRecords;
+    bool valid;
+} ReaderExport;
+
+static bool
+exportRecord(void* parameter, const Scheduler_SetpointRecord* record)
+{
+    ReaderExport* export = (ReaderExport*)parameter;
+
+    /* torn, overwritten or misplaced record */
+    if ((record->timestamp != 1000 + ((uint64_t)record->value * 10)) || (record->timestamp >= export->endTime) ||
+        ((export->numberOfRecords > 0) && (record->timestamp <= export->lastTimestamp)))
+    {
+        export->valid = false;
+        return false;
+    }
+
+    export->lastTimestamp = record->timestamp;
+    export->numberOfRecords++;
+
+    /* a slow handler: the writer overwrites records of the range in the meantime */
+    if ((export->numberOfRecords % 64) == 0)
+        Thread_sleep(0);
+
+    return true;
+}
+
+static void*
+readerThread(void* parameter)
+{
+    ReaderResult* result = (ReaderResult*)parameter;
+
+    while (__atomic_load_n(&writerRunning, __ATOMIC_ACQUIRE)) {
+        ReaderExport export;
+
+        export.lastTimestamp = 0;
+        export.numberOfRecords = 0;
+        export.valid = true;
+
+        /* start at one of the oldest records - they are overwritten while exporting */
+        int oldest = __atomic_load_n(&appendedRecords, __ATOMIC_ACQUIRE) - CONCURRENT_CAPACITY + (rand() % 32);
+
+        uint64_t startTime = 1000 + ((uint64_t)(oldest > 0 ? oldest : 0) * 10);
+
+        export.endTime = startTime + QUERY_RANGE;
+
+        SetpointHistory_export(history, startTime, export.endTime, exportRecord, &export);
+
+        result->queries++;
+
+        if (export.valid == false)
+            result->errors++;
+    }
+
+    return NULL;
+}
+
+static bool
+testConcurrentReaders(void)
+{
+    history = SetpointHistory_create(CONCURRENT_CAPACITY, NULL);
+
+    if (history == NULL) {
+        printf("ERROR: Failed to create setpoint history\n");
+        return false;
+    }
+
+    __atomic_store_n(&writerRunning, true, __ATOMIC_RELEASE);
+
+    ReaderResult results[NUMBER_OF_READERS];
+    Thread readers[NUMBER_OF_READERS];
+
+    memset(results, 0, sizeof(results));
+
+    int i;
+
+    for (i = 0; i < NUMBER_OF_READERS; i++) {
+        readers[i] = Thread_create(readerThread, &(results[i]), false);
+        Thread_start(readers[i]);
+    }
+
+    Thread writer = Thread_create(writerThread, NULL, false);
+
+    Thread_start(writer);
+    Thread_destroy(writer);
+
+    __atomic_store_n(&writerRunning, false, __ATOMIC_RELEASE);
+
+    int queries = 0;
+    int errors = 0;
+
+    for (i = 0; i < NUMBER_OF_READERS; i++) {
+        Thread_destroy(readers[i]);
+
+        queries += results[i].queries;
+        errors += results[i].errors;
+    }
+
+    printf("INFO: %i concurrent queries, %i with invalid records\n", queries, errors);
+
+    bool success = (errors == 0);
+
+    /* after the writer finished the newest records are complete */
+    int n = CONCURRENT_RECORDS - CONCURRENT_CAPACITY + 1;
+
+    success &= checkQuery(history, 1000 + ((uint64_t)n * 10), UINT64_MAX, 64, n, 64);
+
+    SetpointHistory_destroy(history);
+
+    return success;
+}
+
+int
+main(int argc, char** argv)
+{
+    bool success = true;
+
+    if (testRangeQueries() == false)
+        success = false;
+
+    if (testFileContinuation() == false)
+        success = false;
+
+    if (testConcurrentReaders() == false)
+        success = false;
+
+    printf("%s\n", success ? "PASSED" : "FAILED");
+
+    return success ? 0 : 1;
+}
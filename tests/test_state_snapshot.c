@@ -0,0 +1,166 @@
+/*
+ * Test of the sequence lock that protects the hot state of the schedules
+ *
+ * Two writer threads (like a schedule thread and an MMS server thread) update the hot state of a
+ * schedule while reader threads take snapshots the same way as Scheduler_getScheduleStates. Every
+ * snapshot has to be consistent: all fields have to belong to the same update.
+ *
+ * Usage: test_state_snapshot
+ */
+
+#include "der_scheduler_internal.h"
+
+#include <libiec61850/hal_thread.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define NUMBER_OF_WRITERS 2
+#define NUMBER_OF_READERS 2
+#define UPDATES_PER_WRITER 200000
+
+static ScheduleHotState hotState;
+
+static int updateCounter = 0;
+static bool writersRunning = false;
+
+typedef struct {
+    int snapshots;
+    int inconsistentSnapshots;
+} ReaderResult;
+
+static void*
+writerThread(void* parameter)
+{
+    int i;
+
+    for (i = 0; i < UPDATES_PER_WRITER; i++) {
+        int n = __atomic_add_fetch(&updateCounter, 1, __ATOMIC_RELAXED);
+
+        scheduler_beginSequenceWrite(&(hotState.sequence));
+
+        /* all fields are derived from n */
+        hotState.state = (ScheduleState)(1 + (n % 4));
+        hotState.prio = n;
+        hotState.currentEntryIdx = n % 100;
+        hotState.nextStartTime = (uint64_t)n * 1000;
+
+        /* let the readers run in the middle of an update (also on a single CPU) */
+        if ((n % 64) == 0)
+            Thread_sleep(0);
+
+        hotState.startTime = ((uint64_t)n * 1000) - 1;
+        hotState.entryStartOffset = (uint64_t)n * 2;
+        hotState.entryEndOffset = ((uint64_t)n * 2) + 1;
+        hotState.value = n * 0.5;
+        hotState.hasValue = (n % 2);
+
+        scheduler_endSequenceWrite(&(hotState.sequence));
+    }
+
+    return NULL;
+}
+
+static bool
+isConsistent(const ScheduleHotState* state)
+{
+    int n = state->prio;
+
+    if (n == 0)
+        return (state->nextStartTime == 0) && (state->value == 0.0);
+
+    return (state->state == (ScheduleState)(1 + (n % 4))) && (state->currentEntryIdx == (n % 100)) &&
+        (state->nextStartTime == (uint64_t)n * 1000) && (state->startTime == ((uint64_t)n * 1000) - 1) &&
+        (state->entryStartOffset == (uint64_t)n * 2) && (state->entryEndOffset == ((uint64_t)n * 2) + 1) &&
+        (state->value == n * 0.5) && (state->hasValue == (bool)(n % 2));
+}
+
+static void*
+readerThread(void* parameter)
+{
+    ReaderResult* result = (ReaderResult*)parameter;
+
+    do {
+        ScheduleHotState copy;
+        uint32_t seq;
+
+        do {
+            seq = scheduler_beginSequenceRead(&(hotState.sequence));
+
+            memcpy(&copy, &hotState, sizeof(ScheduleHotState));
+
+        } while (scheduler_retrySequenceRead(&(hotState.sequence), seq));
+
+        result->snapshots++;
+
+        if (isConsistent(&copy) == false) {
+            if (result->inconsistentSnapshots == 0)
+                printf("ERROR: Inconsistent snapshot (prio %i, nextStartTime %llu, value %f)\n", copy.prio,
+                    (unsigned long long)copy.nextStartTime, copy.value);
+
+            result->inconsistentSnapshots++;
+        }
+
+    } while (__atomic_load_n(&writersRunning, __ATOMIC_ACQUIRE));
+
+    return NULL;
+}
+
+int
+main(int argc, char** argv)
+{
+    memset(&hotState, 0, sizeof(hotState));
+
+    __atomic_store_n(&writersRunning, true, __ATOMIC_RELEASE);
+
+    ReaderResult results[NUMBER_OF_READERS];
+    Thread readers[NUMBER_OF_READERS];
+    Thread writers[NUMBER_OF_WRITERS];
+
+    memset(results, 0, sizeof(results));
+
+    int i;
+
+    for (i = 0; i < NUMBER_OF_READERS; i++) {
+        readers[i] = Thread_create(readerThread, &(results[i]), false);
+        Thread_start(readers[i]);
+    }
+
+    for (i = 0; i < NUMBER_OF_WRITERS; i++) {
+        writers[i] = Thread_create(writerThread, NULL, false);
+        Thread_start(writers[i]);
+    }
+
+    for (i = 0; i < NUMBER_OF_WRITERS; i++)
+        Thread_destroy(writers[i]);
+
+    __atomic_store_n(&writersRunning, false, __ATOMIC_RELEASE);
+
+    bool success = true;
+
+    int snapshots = 0;
+    int inconsistentSnapshots = 0;
+
+    for (i = 0; i < NUMBER_OF_READERS; i++) {
+        Thread_destroy(readers[i]);
+
+        snapshots += results[i].snapshots;
+        inconsistentSnapshots += results[i].inconsistentSnapshots;
+    }
+
+    /* every update increments the sequence by two */
+    if (hotState.sequence != (uint32_t)(NUMBER_OF_WRITERS * UPDATES_PER_WRITER * 2)) {
+        printf("ERROR: Sequence %u after %i updates\n", hotState.sequence, NUMBER_OF_WRITERS * UPDATES_PER_WRITER);
+        success = false;
+    }
+
+    printf("INFO: %i snapshots, %i inconsistent\n", snapshots, inconsistentSnapshots);
+
+    if ((snapshots == 0) || (inconsistentSnapshots > 0))
+        success = false;
+
+    printf("%s\n", success ? "PASSED" : "FAILED");
+
+    return success ? 0 : 1;
+}
@@ -0,0 +1,143 @@
+/*
+ * Startup timing of the scheduler with and without binding cache
+ *
+ * Creates the scheduler for the given model several times by parsing the model and then
+ * several times from the binding cache (see Scheduler_createWithBindingCache) and reports
+ * the time of Scheduler_createEx for both cases. The data model and the server are created
+ * for each run and are not included in the measured time.
+ */
+
+#include "der_scheduler.h"
+#include "scheduler_rt.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+    uint64_t minTimeInUs;
+    uint64_t maxTimeInUs;
+    uint64_t sumTimeInUs;
+    int numberOfRuns;
+} BindTiming;
+
+static void
+printUsage(const char* progName)
+{
+    printf("Usage: %s [options] <model.cfg>\n", progName);
+    printf("  -n <n>        number of runs per case (default: 10)\n");
+    printf("  -c <file>     binding cache file (default: bind_timing.cache, overwritten)\n");
+}
+
+static bool
+runScheduler(const char* modelFile, const char* cacheFile, BindTiming* timing)
+{
+    IedModel* model = ConfigFileParser_createModelFromConfigFileEx(modelFile);
+
+    if (model == NULL) {
+        printf("ERROR: Failed to load data model %s\n", modelFile);
+        return false;
+    }
+
+    IedServer server = IedServer_create(model);
+
+    uint64_t startTime = SchedulerRt_getMonotonicTimeInUs();
+
+    Scheduler sched = Scheduler_createEx(model, server, SCHEDULER_MODE_EXTERNAL, cacheFile);
+
+    uint64_t bindTime = SchedulerRt_getMonotonicTimeInUs() - startTime;
+
+    if (timing) {
+        if ((timing->numberOfRuns == 0) || (bindTime < timing->minTimeInUs))
+            timing->minTimeInUs = bindTime;
+
+        if (bindTime > timing->maxTimeInUs)
+            timing->maxTimeInUs = bindTime;
+
+        timing->sumTimeInUs += bindTime;
+        timing->numberOfRuns++;
+    }
+
+    Scheduler_destroy(sched);
+    IedServer_destroy(server);
+    IedModel_destroy(model);
+
+    return true;
+}
+
+static void
+printTiming(const char* name, BindTiming* timing)
+{
+    if (timing->numberOfRuns == 0)
+        return;
+
+    printf("%-20s min %8llu us  avg %8llu us  max %8llu us\n", name,
+        (unsigned long long)timing->minTimeInUs,
+        (unsigned long long)(timing->sumTimeInUs / timing->numberOfRuns),
+        (unsigned long long)timing->maxTimeInUs);
+}
+
+int
+main(int argc, char** argv)
+{
+    const char* cacheFile = "bind_timing.cache";
+    const char* modelFile = NULL;
+    int numberOfRuns = 10;
+
+    int i;
+
+    for (i = 1; i < argc; i++) {
+        if (argv[i][0] != '-') {
+            modelFile = argv[i];
+            continue;
+        }
+
+        if (i + 1 >= argc) {
+            printUsage(argv[0]);
+            return 1;
+        }
+
+        const char* arg = argv[++i];
+
+        switch (argv[i - 1][1]) {
+        case 'n': numberOfRuns = atoi(arg); break;
+        case 'c': cacheFile = arg; break;
+        default:
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    if ((modelFile == NULL) || (numberOfRuns < 1)) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    BindTiming withoutCache;
+    BindTiming withCache;
+
+    memset(&withoutCache, 0, sizeof(withoutCache));
+    memset(&withCache, 0, sizeof(withCache));
+
+    for (i = 0; i < numberOfRuns; i++) {
+        if (runScheduler(modelFile, NULL, &withoutCache) == false)
+            return 1;
+    }
+
+    /* the first run with a new cache file parses the model and writes the cache */
+    remove(cacheFile);
+
+    if (runScheduler(modelFile, cacheFile, NULL) == false)
+        return 1;
+
+    for (i = 0; i < numberOfRuns; i++) {
+        if (runScheduler(modelFile, cacheFile, &withCache) == false)
+            return 1;
+    }
+
+    printf("\n");
+    printTiming("without cache:", &withoutCache);
+    printTiming("with cache:", &withCache);
+
+    return 0;
+}
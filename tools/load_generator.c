@@ -0,0 +1,641 @@
+/*
+ * Multi-client load generator for MMS write and control traffic
+ *
+ * Opens a number of concurrent client connections to a scheduler server. Each
+ * client continuously rewrites a schedule (NumEntr, SchdIntv, values, StrTm),
+ * flips EnaReq/DsaReq, changes SchdPrio and reads the controller outputs
+ * (ValMV, ActSchdRef). At the end a report with the achieved throughput, the
+ * write latency percentiles and the observed lateness of the schedule entry
+ * boundaries (SchdEntr.t compared to ActStrTm + n * SchdIntv) is printed.
+ */
+
+#include <libiec61850/iec61850_client.h>
+#include <libiec61850/hal_thread.h>
+#include <libiec61850/hal_time.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define MAX_SCHEDULES 128
+
+typedef enum {
+    OP_REWRITE = 0, /* write NumEntr, SchdIntv, values and StrTm */
+    OP_ENABLE_TOGGLE = 1, /* operate EnaReq or DsaReq */
+    OP_PRIO_CHANGE = 2, /* write SchdPrio.setVal */
+    OP_READ = 3, /* read ValMV, ActSchdRef and SchdEntr */
+    OP_COUNT = 4
+} OperationType;
+
+static const char* operationNames[OP_COUNT] = {"schedule rewrite", "EnaReq/DsaReq", "SchdPrio write", "status read"};
+
+typedef struct {
+    const char* hostname;
+    int port;
+    int numberOfClients;
+    int durationInS;
+    double rates[OP_COUNT]; /* operations per second per client */
+    int numberOfEntries;
+    int intervalInS;
+    const char* controllerRef;
+    const char* scheduleRefs[MAX_SCHEDULES];
+    int numberOfSchedules;
+} LoadConfig;
+
+typedef struct {
+    uint32_t* values;
+    int count;
+    int size;
+} Samples;
+
+typedef struct sLoadClient* LoadClient;
+
+struct sLoadClient {
+    int id;
+    LoadConfig* config;
+    const char* scheduleRef;
+    unsigned int seed;
+
+    int operations[OP_COUNT];
+    int errors[OP_COUNT];
+
+    Samples writeLatencies; /* in us per single write/operate service */
+    Samples operationLatencies[OP_COUNT]; /* in us per complete operation */
+    Samples boundaryLateness; /* in ms */
+
+    uint64_t lastActStrTm;
+    int lastSchdEntr;
+
+    bool enabled;
+    bool connected;
+};
+
+static void
+samples_add(Samples* self, uint32_t value)
+{
+    if (self->count == self->size) {
+        int newSize = (self->size == 0) ? 1024 : self->size * 2;
+
+        uint32_t* newValues = (uint32_t*)realloc(self->values, newSize * sizeof(uint32_t));
+
+        if (newValues == NULL)
+            return;
+
+        self->values = newValues;
+        self->size = newSize;
+    }
+
+    self->values[self->count++] = value;
+}
+
+static void
+samples_append(Samples* self, Samples* other)
+{
+    int i;
+
+    for (i = 0; i < other->count; i++)
+        samples_add(self, other->values[i]);
+}
+
+static int
+compareUint32(const void* a, const void* b)
+{
+    uint32_t va = *((const uint32_t*)a);
+    uint32_t vb = *((const uint32_t*)b);
+
+    return (va > vb) - (va < vb);
+}
+
+static uint32_t
+samples_getPercentile(Samples* self, double percentile)
+{
+    if (self->count == 0)
+        return 0;
+
+    int idx = (int)((percentile / 100.0) * (self->count - 1) + 0.5);
+
+    return self->values[idx];
+}
+
+static void
+samples_printReport(Samples* self, const char* name, const char* unit)
+{
+    if (self->count == 0) {
+        printf("  %-24s no samples\n", name);
+        return;
+    }
+
+    qsort(self->values, self->count, sizeof(uint32_t), compareUint32);
+
+    printf("  %-24s n=%-8i p50=%u%s p90=%u%s p99=%u%s max=%u%s\n", name, self->count,
+        samples_getPercentile(self, 50), unit, samples_getPercentile(self, 90), unit,
+        samples_getPercentile(self, 99), unit, self->values[self->count - 1], unit);
+}
+
+static uint64_t
+getMonotonicTimeInUs(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ((uint64_t)ts.tv_sec * 1000000) + (ts.tv_nsec / 1000);
+}
+
+static bool
+loadClient_trackWrite(LoadClient self, uint64_t startTime, IedClientError err)
+{
+    samples_add(&(self->writeLatencies), (uint32_t)(getMonotonicTimeInUs() - startTime));
+
+    return (err == IED_ERROR_OK);
+}
+
+static bool
+loadClient_writeInt32(LoadClient self, IedConnection con, const char* objName, int32_t value)
+{
+    char objRef[130];
+    IedClientError err;
+
+    snprintf(objRef, sizeof(objRef), "%s.%s", self->scheduleRef, objName);
+
+    uint64_t startTime = getMonotonicTimeInUs();
+
+    IedConnection_writeInt32Value(con, &err, objRef, IEC61850_FC_SP, value);
+
+    return loadClient_trackWrite(self, startTime, err);
+}
+
+static bool
+loadClient_operate(LoadClient self, IedConnection con, const char* objName)
+{
+    char objRef[130];
+
+    snprintf(objRef, sizeof(objRef), "%s.%s", self->scheduleRef, objName);
+
+    bool success = false;
+
+    uint64_t startTime = getMonotonicTimeInUs();
+
+    ControlObjectClient control = ControlObjectClient_create(objRef, con);
+
+    if (control) {
+        MmsValue* ctlVal = MmsValue_newBoolean(true);
+
+        ControlObjectClient_setOrigin(control, "load_generator", 3);
+
+        success = ControlObjectClient_operate(control, ctlVal, 0 /* operate now */);
+
+        MmsValue_delete(ctlVal);
+
+        ControlObjectClient_destroy(control);
+    }
+
+    samples_add(&(self->writeLatencies), (uint32_t)(getMonotonicTimeInUs() - startTime));
+
+    return success;
+}
+
+static bool
+loadClient_rewriteSchedule(LoadClient self, IedConnection con)
+{
+    bool success = true;
+
+    LoadConfig* config = self->config;
+
+    success &= loadClient_writeInt32(self, con, "NumEntr.setVal", config->numberOfEntries);
+    success &= loadClient_writeInt32(self, con, "SchdIntv.setVal", config->intervalInS);
+
+    int i;
+
+    for (i = 0; i < config->numberOfEntries; i++) {
+        char objRef[130];
+        IedClientError err;
+
+        snprintf(objRef, sizeof(objRef), "%s.ValASG%03i.setMag.f", self->scheduleRef, i + 1);
+
+        uint64_t startTime = getMonotonicTimeInUs();
+
+        IedConnection_writeFloatValue(con, &err, objRef, IEC61850_FC_SP, (float)(rand_r(&(self->seed)) % 1000));
+
+        success &= loadClient_trackWrite(self, startTime, err);
+    }
+
+    char objRef[130];
+    IedClientError err;
+
+    snprintf(objRef, sizeof(objRef), "%s.StrTm01.setTm", self->scheduleRef);
+
+    MmsValue* strTmVal = MmsValue_newUtcTimeByMsTime(Hal_getTimeInMs() + 2000);
+
+    uint64_t startTime = getMonotonicTimeInUs();
+
+    IedConnection_writeObject(con, &err, objRef, IEC61850_FC_SP, strTmVal);
+
+    success &= loadClient_trackWrite(self, startTime, err);
+
+    MmsValue_delete(strTmVal);
+
+    if (success) {
+        success = loadClient_operate(self, con, "EnaReq");
+
+        if (success)
+            self->enabled = true;
+    }
+
+    return success;
+}
+
+static bool
+loadClient_toggleEnable(LoadClient self, IedConnection con)
+{
+    bool success = loadClient_operate(self, con, self->enabled ? "DsaReq" : "EnaReq");
+
+    if (success)
+        self->enabled = !(self->enabled);
+
+    return success;
+}
+
+static bool
+loadClient_changePrio(LoadClient self, IedConnection con)
+{
+    return loadClient_writeInt32(self, con, "SchdPrio.setVal", 1 + (rand_r(&(self->seed)) % 100));
+}
+
+static void
+loadClient_checkBoundaryLateness(LoadClient self, IedConnection con)
+{
+    char objRef[130];
+    IedClientError err;
+
+    snprintf(objRef, sizeof(objRef), "%s.ActStrTm", self->scheduleRef);
+
+    MmsValue* actStrTm = IedConnection_readObject(con, &err, objRef, IEC61850_FC_ST);
+
+    if (actStrTm == NULL)
+        return;
+
+    snprintf(objRef, sizeof(objRef), "%s.SchdEntr", self->scheduleRef);
+
+    MmsValue* schdEntr = IedConnection_readObject(con, &err, objRef, IEC61850_FC_ST);
+
+    if (schdEntr) {
+        /* structure elements: stVal, q, t */
+        MmsValue* actStrTm_stVal = MmsValue_getElement(actStrTm, 0);
+        MmsValue* schdEntr_stVal = MmsValue_getElement(schdEntr, 0);
+        MmsValue* schdEntr_t = MmsValue_getElement(schdEntr, 2);
+
+        if (actStrTm_stVal && schdEntr_stVal && schdEntr_t) {
+            uint64_t startTime = MmsValue_getUtcTimeInMs(actStrTm_stVal);
+            int entryIdx = MmsValue_toInt32(schdEntr_stVal);
+            uint64_t entryTime = MmsValue_getUtcTimeInMs(schdEntr_t);
+
+            if ((startTime != 0) && (entryIdx > 0) &&
+                ((startTime != self->lastActStrTm) || (entryIdx != self->lastSchdEntr)))
+            {
+                uint64_t expectedTime = startTime + ((uint64_t)(entryIdx - 1) * self->config->intervalInS * 1000);
+
+                if (entryTime >= expectedTime)
+                    samples_add(&(self->boundaryLateness), (uint32_t)(entryTime - expectedTime));
+
+                self->lastActStrTm = startTime;
+                self->lastSchdEntr = entryIdx;
+            }
+        }
+
+        MmsValue_delete(schdEntr);
+    }
+
+    MmsValue_delete(actStrTm);
+}
+
+static bool
+loadClient_readStatus(LoadClient self, IedConnection con)
+{
+    char objRef[130];
+    IedClientError err;
+
+    bool success = true;
+
+    snprintf(objRef, sizeof(objRef), "%s.ValMV", self->config->controllerRef);
+
+    MmsValue* value = IedConnection_readObject(con, &err, objRef, IEC61850_FC_MX);
+
+    if (value)
+        MmsValue_delete(value);
+    else
+        success = false;
+
+    snprintf(objRef, sizeof(objRef), "%s.ActSchdRef.stVal", self->config->controllerRef);
+
+    value = IedConnection_readObject(con, &err, objRef, IEC61850_FC_ST);
+
+    if (value)
+        MmsValue_delete(value);
+    else
+        success = false;
+
+    loadClient_checkBoundaryLateness(self, con);
+
+    return success;
+}
+
+static void*
+loadClient_thread(void* parameter)
+{
+    LoadClient self = (LoadClient)parameter;
+    LoadConfig* config = self->config;
+
+    IedClientError err;
+
+    IedConnection con = IedConnection_create();
+
+    IedConnection_connect(con, &err, config->hostname, config->port);
+
+    if (err != IED_ERROR_OK) {
+        printf("ERROR: client %i failed to connect\n", self->id);
+        IedConnection_destroy(con);
+        return NULL;
+    }
+
+    self->connected = true;
+
+    uint64_t now = getMonotonicTimeInUs();
+    uint64_t endTime = now + ((uint64_t)config->durationInS * 1000000);
+
+    uint64_t nextDue[OP_COUNT];
+    uint64_t period[OP_COUNT];
+
+    int op;
+
+    for (op = 0; op < OP_COUNT; op++) {
+        if (config->rates[op] > 0.0) {
+            period[op] = (uint64_t)(1000000.0 / config->rates[op]);
+
+            /* spread the first operations of the clients */
+            nextDue[op] = now + (rand_r(&(self->seed)) % period[op]);
+        }
+        else {
+            period[op] = 0;
+            nextDue[op] = UINT64_MAX;
+        }
+    }
+
+    /* start with a valid schedule so that the other operations have an effect */
+    nextDue[OP_REWRITE] = now;
+
+    while (now < endTime) {
+        OperationType nextOp = OP_REWRITE;
+
+        for (op = 1; op < OP_COUNT; op++) {
+            if (nextDue[op] < nextDue[nextOp])
+                nextOp = (OperationType)op;
+        }
+
+        if (nextDue[nextOp] > now) {
+            uint64_t waitTime = nextDue[nextOp] - now;
+
+            if (nextDue[nextOp] > endTime)
+                break;
+
+            Thread_sleep((int)(waitTime / 1000));
+        }
+
+        uint64_t startTime = getMonotonicTimeInUs();
+
+        bool success = false;
+
+        switch (nextOp) {
+        case OP_REWRITE:
+            success = loadClient_rewriteSchedule(self, con);
+            break;
+        case OP_ENABLE_TOGGLE:
+            success = loadClient_toggleEnable(self, con);
+            break;
+        case OP_PRIO_CHANGE:
+            success = loadClient_changePrio(self, con);
+            break;
+        case OP_READ:
+            success = loadClient_readStatus(self, con);
+            break;
+        default:
+            break;
+        }
+
+        now = getMonotonicTimeInUs();
+
+        samples_add(&(self->operationLatencies[nextOp]), (uint32_t)(now - startTime));
+
+        self->operations[nextOp]++;
+
+        if (success == false)
+            self->errors[nextOp]++;
+
+        if (period[nextOp] > 0) {
+            nextDue[nextOp] += period[nextOp];
+
+            /* don't try to catch up when the server cannot keep up with the requested rate */
+            if (nextDue[nextOp] < now)
+                nextDue[nextOp] = now;
+        }
+        else {
+            nextDue[nextOp] = UINT64_MAX;
+        }
+    }
+
+    IedConnection_close(con);
+    IedConnection_destroy(con);
+
+    return NULL;
+}
+
+static void
+printUsage(const char* progName)
+{
+    printf("Usage: %s [options]\n", progName);
+    printf("  -h            print this help\n");
+    printf("  -H <host>     server hostname (default: localhost)\n");
+    printf("  -p <port>     server port (default: 102)\n");
+    printf("  -n <n>        number of concurrent clients (default: 3)\n");
+    printf("  -d <s>        test duration in seconds (default: 60)\n");
+    printf("  -w <rate>     schedule rewrites per second and client (default: 0.2)\n");
+    printf("  -e <rate>     EnaReq/DsaReq operations per second and client (default: 0.5)\n");
+    printf("  -P <rate>     SchdPrio writes per second and client (default: 1)\n");
+    printf("  -r <rate>     status reads per second and client (default: 5)\n");
+    printf("  -N <n>        number of entries written per schedule (default: 10)\n");
+    printf("  -i <s>        schedule interval in seconds (default: 1)\n");
+    printf("  -C <ref>      schedule controller reference (default: DER_Scheduler_Control/ActPow_FSCC1)\n");
+    printf("  -S <ref>      schedule reference, can be repeated. Clients are assigned round robin\n");
+    printf("                (default: DER_Scheduler_Control/ActPow_FSCH01..10)\n");
+}
+
+int
+main(int argc, char** argv)
+{
+    LoadConfig config;
+
+    memset(&config, 0, sizeof(config));
+
+    config.hostname = "localhost";
+    config.port = 102;
+    config.numberOfClients = 3;
+    config.durationInS = 60;
+    config.rates[OP_REWRITE] = 0.2;
+    config.rates[OP_ENABLE_TOGGLE] = 0.5;
+    config.rates[OP_PRIO_CHANGE] = 1.0;
+    config.rates[OP_READ] = 5.0;
+    config.numberOfEntries = 10;
+    config.intervalInS = 1;
+    config.controllerRef = "DER_Scheduler_Control/ActPow_FSCC1";
+
+    int i;
+
+    for (i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-h") == 0) {
+            printUsage(argv[0]);
+            return 0;
+        }
+
+        if ((argv[i][0] != '-') || (i + 1 >= argc)) {
+            printUsage(argv[0]);
+            return 1;
+        }
+
+        const char* arg = argv[++i];
+
+        switch (argv[i - 1][1]) {
+        case 'H': config.hostname = arg; break;
+        case 'p': config.port = atoi(arg); break;
+        case 'n': config.numberOfClients = atoi(arg); break;
+        case 'd': config.durationInS = atoi(arg); break;
+        case 'w': config.rates[OP_REWRITE] = atof(arg); break;
+        case 'e': config.rates[OP_ENABLE_TOGGLE] = atof(arg); break;
+        case 'P': config.rates[OP_PRIO_CHANGE] = atof(arg); break;
+        case 'r': config.rates[OP_READ] = atof(arg); break;
+        case 'N': config.numberOfEntries = atoi(arg); break;
+        case 'i': config.intervalInS = atoi(arg); break;
+        case 'C': config.controllerRef = arg; break;
+        case 'S':
+            if (config.numberOfSchedules < MAX_SCHEDULES)
+                config.scheduleRefs[config.numberOfSchedules++] = arg;
+            break;
+        default:
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    if ((config.numberOfClients < 1) || (config.durationInS < 1) || (config.numberOfEntries < 1) ||
+        (config.numberOfEntries > 999) || (config.intervalInS < 1))
+    {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    static char defaultScheduleRefs[10][130];
+
+    if (config.numberOfSchedules == 0) {
+        for (i = 0; i < 10; i++) {
+            snprintf(defaultScheduleRefs[i], 130, "DER_Scheduler_Control/ActPow_FSCH%02i", i + 1);
+            config.scheduleRefs[config.numberOfSchedules++] = defaultScheduleRefs[i];
+        }
+    }
+
+    LoadClient clients = (LoadClient)calloc(config.numberOfClients, sizeof(struct sLoadClient));
+    Thread* threads = (Thread*)calloc(config.numberOfClients, sizeof(Thread));
+
+    if ((clients == NULL) || (threads == NULL)) {
+        printf("ERROR: Out of memory\n");
+        return 1;
+    }
+
+    printf("INFO: Starting %i clients for %i s\n", config.numberOfClients, config.durationInS);
+
+    uint64_t testStartTime = getMonotonicTimeInUs();
+
+    for (i = 0; i < config.numberOfClients; i++) {
+        clients[i].id = i;
+        clients[i].config = &config;
+        clients[i].scheduleRef = config.scheduleRefs[i % config.numberOfSchedules];
+        clients[i].seed = (unsigned int)(testStartTime + i);
+
+        threads[i] = Thread_create(loadClient_thread, &(clients[i]), false);
+        Thread_start(threads[i]);
+    }
+
+    for (i = 0; i < config.numberOfClients; i++) {
+        Thread_destroy(threads[i]);
+    }
+
+    double testDurationInS = (getMonotonicTimeInUs() - testStartTime) / 1000000.0;
+
+    /* aggregate results */
+
+    Samples writeLatencies = {NULL, 0, 0};
+    Samples boundaryLateness = {NULL, 0, 0};
+    Samples operationLatencies[OP_COUNT];
+
+    memset(operationLatencies, 0, sizeof(operationLatencies));
+
+    int operations[OP_COUNT] = {0};
+    int errors[OP_COUNT] = {0};
+    int connectedClients = 0;
+
+    for (i = 0; i < config.numberOfClients; i++) {
+        LoadClient client = &(clients[i]);
+
+        if (client->connected)
+            connectedClients++;
+
+        int op;
+
+        for (op = 0; op < OP_COUNT; op++) {
+            operations[op] += client->operations[op];
+            errors[op] += client->errors[op];
+            samples_append(&(operationLatencies[op]), &(client->operationLatencies[op]));
+            free(client->operationLatencies[op].values);
+        }
+
+        samples_append(&writeLatencies, &(client->writeLatencies));
+        samples_append(&boundaryLateness, &(client->boundaryLateness));
+
+        free(client->writeLatencies.values);
+        free(client->boundaryLateness.values);
+    }
+
+    printf("\nLoad test report (%i of %i clients connected, %.1f s)\n", connectedClients, config.numberOfClients, testDurationInS);
+
+    printf("Throughput:\n");
+
+    int op;
+
+    for (op = 0; op < OP_COUNT; op++) {
+        printf("  %-24s %8i ops %10.2f ops/s %6i errors\n", operationNames[op], operations[op],
+            operations[op] / testDurationInS, errors[op]);
+    }
+
+    printf("  %-24s %8i ops %10.2f ops/s\n", "MMS write/operate", writeLatencies.count,
+        writeLatencies.count / testDurationInS);
+
+    printf("Latency:\n");
+
+    samples_printReport(&writeLatencies, "MMS write/operate", "us");
+
+    for (op = 0; op < OP_COUNT; op++) {
+        samples_printReport(&(operationLatencies[op]), operationNames[op], "us");
+        free(operationLatencies[op].values);
+    }
+
+    printf("Scheduler boundary lateness (SchdEntr.t - expected entry start):\n");
+
+    samples_printReport(&boundaryLateness, "entry boundary", "ms");
+
+    free(writeLatencies.values);
+    free(boundaryLateness.values);
+
+    free(threads);
+    free(clients);
+
+    return 0;
+}
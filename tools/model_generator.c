@@ -0,0 +1,540 @@
+/*
+ * Synthetic model generator for scale testing
+ *
+ * Emits a libiec61850 config file (model.cfg) with a configurable number of
+ * logical devices, schedule controllers (FSCC), schedules (FSCH) per controller
+ * and schedule entries per schedule. The generated structure follows the
+ * hand-written models/model.cfg so that it can be used with Scheduler_create.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+typedef enum {
+    CTRL_TYPE_MV = 0,
+    CTRL_TYPE_SPS = 1,
+    CTRL_TYPE_MIXED = 2
+} ControllerType;
+
+typedef struct {
+    int numberOfLDs;
+    int controllersPerLD;
+    int schedulesPerController; /* non-periodic schedules per controller */
+    int periodicSchedulesPerController; /* periodic (reserve) schedules per controller */
+    int entriesPerSchedule;
+    int startTimesPerSchedule;
+    ControllerType controllerType;
+    const char* iedName;
+} GeneratorConfig;
+
+static void
+printUsage(const char* progName)
+{
+    printf("Usage: %s [options]\n", progName);
+    printf("  -o <file>   output file (default: stdout)\n");
+    printf("  -i <name>   IED name (default: DER_Scheduler_)\n");
+    printf("  -l <n>      number of logical devices (default: 1)\n");
+    printf("  -c <n>      schedule controllers (FSCC) per logical device (default: 3)\n");
+    printf("  -s <n>      non-periodic schedules (FSCH) per controller (default: 10)\n");
+    printf("  -p <n>      periodic schedules (FSCH with StrTm.setCal) per controller (default: 1)\n");
+    printf("  -e <n>      entries per schedule (default: 100, max: 9999)\n");
+    printf("  -n <n>      start times (StrTm) per schedule (default: 16)\n");
+    printf("  -t <type>   controller type: mv, sps or mixed (default: mixed)\n");
+}
+
+static void
+writeStatusDA(FILE* out, const char* name, int type, int fc, int trgOps, const char* initValue)
+{
+    if (initValue)
+        fprintf(out, "DA(%s 0 %i %i %i 0)=%s;\n", name, type, fc, trgOps, initValue);
+    else
+        fprintf(out, "DA(%s 0 %i %i %i 0);\n", name, type, fc, trgOps);
+}
+
+static void
+writeQualityAndTimestamp(FILE* out, int fc)
+{
+    writeStatusDA(out, "q", 23, fc, 2, NULL);
+    writeStatusDA(out, "t", 22, fc, 0, NULL);
+}
+
+static void
+writeBeh(FILE* out)
+{
+    fprintf(out, "DO(Beh 0){\n");
+    writeStatusDA(out, "stVal", 12, 0, 5, "1");
+    writeQualityAndTimestamp(out, 0);
+    fprintf(out, "}\n");
+}
+
+static void
+writeMV(FILE* out, const char* name)
+{
+    fprintf(out, "DO(%s 0){\n", name);
+    fprintf(out, "DA(mag 0 27 1 4 0){\n");
+    writeStatusDA(out, "f", 10, 1, 4, NULL);
+    fprintf(out, "}\n");
+    writeQualityAndTimestamp(out, 1);
+    fprintf(out, "DA(units 0 27 4 1 0){\n");
+    writeStatusDA(out, "SIUnit", 12, 4, 1, "38");
+    writeStatusDA(out, "multiplier", 12, 4, 1, "3");
+    fprintf(out, "}\n");
+    writeStatusDA(out, "d", 20, 5, 0, NULL);
+    fprintf(out, "}\n");
+}
+
+static void
+writeSPS(FILE* out, const char* name)
+{
+    fprintf(out, "DO(%s 0){\n", name);
+    writeStatusDA(out, "stVal", 0, 0, 1, NULL);
+    writeQualityAndTimestamp(out, 0);
+    fprintf(out, "}\n");
+}
+
+static void
+writeStatusObject(FILE* out, const char* name, int type, int trgOps, const char* initValue)
+{
+    fprintf(out, "DO(%s 0){\n", name);
+    writeStatusDA(out, "stVal", type, 0, trgOps, initValue);
+    writeQualityAndTimestamp(out, 0);
+    fprintf(out, "}\n");
+}
+
+static void
+writeControllableSPC(FILE* out, const char* name, int ctlModel)
+{
+    fprintf(out, "DO(%s 0){\n", name);
+    fprintf(out, "DA(origin 0 27 0 0 0){\n");
+    writeStatusDA(out, "orCat", 12, 0, 0, NULL);
+    writeStatusDA(out, "orIdent", 13, 0, 0, NULL);
+    fprintf(out, "}\n");
+    writeStatusDA(out, "ctlNum", 6, 0, 0, NULL);
+    writeStatusDA(out, "stVal", 0, 0, 1, NULL);
+    writeQualityAndTimestamp(out, 0);
+    fprintf(out, "DA(ctlModel 0 12 4 1 0)=%i;\n", ctlModel);
+    fprintf(out, "DA(Oper 0 27 12 0 0){\n");
+    writeStatusDA(out, "ctlVal", 0, 12, 0, NULL);
+    fprintf(out, "DA(origin 0 27 12 0 0){\n");
+    writeStatusDA(out, "orCat", 12, 12, 0, NULL);
+    writeStatusDA(out, "orIdent", 13, 12, 0, NULL);
+    fprintf(out, "}\n");
+    writeStatusDA(out, "ctlNum", 6, 12, 0, NULL);
+    writeStatusDA(out, "T", 22, 12, 0, NULL);
+    writeStatusDA(out, "Test", 0, 12, 0, NULL);
+    writeStatusDA(out, "Check", 24, 12, 0, NULL);
+    fprintf(out, "}\n");
+    fprintf(out, "}\n");
+}
+
+static void
+writeSetting(FILE* out, const char* name, int type, const char* initValue)
+{
+    fprintf(out, "DO(%s 0){\n", name);
+    writeStatusDA(out, "setVal", type, 2, 1, initValue);
+    fprintf(out, "}\n");
+}
+
+static void
+writeLLN0(FILE* out)
+{
+    fprintf(out, "LN(LLN0){\n");
+    fprintf(out, "DO(NamPlt 0){\n");
+    writeStatusDA(out, "vendor", 20, 5, 0, "\"Alliander\"");
+    writeStatusDA(out, "swRev", 20, 5, 0, "\"1.0.0\"");
+    writeStatusDA(out, "d", 20, 5, 0, "\"DER Scheduler generated model\"");
+    writeStatusDA(out, "configRev", 20, 5, 0, "\"1\"");
+    fprintf(out, "}\n");
+    writeBeh(out);
+    writeStatusObject(out, "Health", 12, 5, "1");
+    fprintf(out, "DO(Mod 0){\n");
+    writeStatusDA(out, "stVal", 12, 0, 1, "1");
+    writeQualityAndTimestamp(out, 0);
+    writeStatusDA(out, "ctlModel", 12, 4, 1, "0");
+    fprintf(out, "}\n");
+    fprintf(out, "}\n");
+}
+
+static void
+writeLPHD(FILE* out)
+{
+    fprintf(out, "LN(LPHD1){\n");
+    fprintf(out, "DO(PhyNam 0){\n");
+    writeStatusDA(out, "vendor", 20, 5, 0, "\"Alliander\"");
+    writeStatusDA(out, "hwRev", 20, 5, 0, NULL);
+    writeStatusDA(out, "swRev", 20, 5, 0, NULL);
+    writeStatusDA(out, "serNum", 20, 5, 0, NULL);
+    writeStatusDA(out, "model", 20, 5, 0, NULL);
+    fprintf(out, "}\n");
+    writeStatusObject(out, "PhyHealth", 12, 5, NULL);
+    writeStatusObject(out, "Proxy", 0, 1, NULL);
+    fprintf(out, "}\n");
+}
+
+static void
+writeGGIO(FILE* out, const char* prefix, bool isMV)
+{
+    fprintf(out, "LN(%sGGIO1){\n", prefix);
+    writeBeh(out);
+
+    if (isMV) {
+        fprintf(out, "DO(AnOut1 0){\n");
+        fprintf(out, "DA(mxVal 0 27 1 1 0){\n");
+        writeStatusDA(out, "f", 10, 1, 1, NULL);
+        fprintf(out, "}\n");
+        writeStatusDA(out, "q", 23, 1, 2, NULL);
+        writeStatusDA(out, "t", 22, 1, 0, NULL);
+        writeStatusDA(out, "ctlModel", 12, 4, 1, "0");
+        fprintf(out, "DA(units 0 27 4 1 0){\n");
+        writeStatusDA(out, "SIUnit", 12, 4, 1, "38");
+        writeStatusDA(out, "multiplier", 12, 4, 1, "3");
+        fprintf(out, "}\n");
+        fprintf(out, "DA(minVal 0 27 4 1 0){\n");
+        writeStatusDA(out, "f", 10, 4, 1, NULL);
+        fprintf(out, "}\n");
+        fprintf(out, "DA(maxVal 0 27 4 1 0){\n");
+        writeStatusDA(out, "f", 10, 4, 1, NULL);
+        fprintf(out, "}\n");
+        writeStatusDA(out, "dbRef", 10, 4, 1, NULL);
+        fprintf(out, "}\n");
+    }
+    else {
+        writeControllableSPC(out, "SPCSO1", 1);
+    }
+
+    fprintf(out, "}\n");
+}
+
+static void
+getScheduleName(char* buf, const char* prefix, int idx, int numberOfRegular)
+{
+    if (idx < numberOfRegular)
+        sprintf(buf, "%sFSCH%02i", prefix, idx + 1);
+    else
+        sprintf(buf, "%sRes_FSCH%02i", prefix, idx - numberOfRegular + 1);
+}
+
+static void
+writeFSCC(FILE* out, const GeneratorConfig* config, const char* ldName, const char* prefix, bool isMV)
+{
+    int numberOfSchedules = config->schedulesPerController + config->periodicSchedulesPerController;
+
+    fprintf(out, "LN(%sFSCC1){\n", prefix);
+    writeBeh(out);
+    writeStatusObject(out, "ActSchdRef", 19, 1, NULL);
+
+    if (isMV)
+        writeMV(out, "ValMV");
+    else
+        writeSPS(out, "ValSPS");
+
+    fprintf(out, "DO(CtlEnt 0){\n");
+
+    if (isMV)
+        fprintf(out, "DA(setSrcRef 0 19 2 1 0)=\"@%s/%sGGIO1.AnOut1.mxVal.f\";\n", ldName, prefix);
+    else
+        fprintf(out, "DA(setSrcRef 0 19 2 1 0)=\"@%s/%sGGIO1.SPCSO1.stVal\";\n", ldName, prefix);
+
+    fprintf(out, "}\n");
+
+    int i;
+
+    for (i = 0; i < numberOfSchedules; i++) {
+        char schedName[64];
+
+        getScheduleName(schedName, prefix, i, config->schedulesPerController);
+
+        fprintf(out, "DO(Schd%02i 0){\n", i + 1);
+        fprintf(out, "DA(setSrcRef 0 19 2 1 0)=\"@%s/%s\";\n", ldName, schedName);
+        fprintf(out, "}\n");
+    }
+
+    fprintf(out, "}\n");
+}
+
+static void
+writeStrTm(FILE* out, int idx, bool isPeriodic)
+{
+    fprintf(out, "DO(StrTm%02i 0){\n", idx);
+    writeStatusDA(out, "setTm", 22, 2, 1, NULL);
+
+    if (isPeriodic) {
+        fprintf(out, "DA(setCal 0 27 2 1 0){\n");
+        writeStatusDA(out, "occ", 7, 2, 1, NULL);
+        writeStatusDA(out, "occType", 12, 2, 1, (idx == 1) ? "0" : NULL);
+        writeStatusDA(out, "occPer", 12, 2, 1, (idx == 1) ? "0" : NULL);
+        writeStatusDA(out, "weekDay", 12, 2, 1, NULL);
+        writeStatusDA(out, "month", 12, 2, 1, NULL);
+        writeStatusDA(out, "day", 6, 2, 1, NULL);
+        writeStatusDA(out, "hr", 6, 2, 1, NULL);
+        writeStatusDA(out, "mn", 6, 2, 1, NULL);
+        fprintf(out, "}\n");
+    }
+
+    fprintf(out, "}\n");
+}
+
+static void
+writeFSCH(FILE* out, const GeneratorConfig* config, const char* schedName, bool isMV, bool isPeriodic)
+{
+    char numberBuf[32];
+
+    fprintf(out, "LN(%s){\n", schedName);
+    writeBeh(out);
+    writeStatusObject(out, "SchdSt", 12, 1, NULL);
+    writeStatusObject(out, "SchdEntr", 3, 5, NULL);
+
+    if (isMV)
+        writeMV(out, "ValMV");
+    else
+        writeSPS(out, "ValSPS");
+
+    writeStatusObject(out, "ActStrTm", 22, 5, NULL);
+    writeStatusObject(out, "NxtStrTm", 22, 5, NULL);
+    writeStatusObject(out, "SchdEnaErr", 12, 1, "1");
+    writeControllableSPC(out, "EnaReq", 1);
+    writeControllableSPC(out, "DsaReq", 1);
+
+    /* reserve schedules are preconfigured with a single entry of one hour */
+    writeSetting(out, "SchdPrio", 3, isPeriodic ? "0" : NULL);
+
+    sprintf(numberBuf, "%i", isPeriodic ? 1 : config->entriesPerSchedule);
+    writeSetting(out, "NumEntr", 3, numberBuf);
+
+    fprintf(out, "DO(SchdIntv 0){\n");
+    writeStatusDA(out, "setVal", 3, 2, 1, isPeriodic ? "3600" : NULL);
+    fprintf(out, "DA(units 0 27 4 1 0){\n");
+    writeStatusDA(out, "SIUnit", 12, 4, 1, "4");
+    writeStatusDA(out, "multiplier", 12, 4, 1, NULL);
+    fprintf(out, "}\n");
+    fprintf(out, "}\n");
+
+    const char* valueFormat = (config->entriesPerSchedule > 999) ? "%s%04i" : "%s%03i";
+
+    int i;
+
+    for (i = 1; i <= config->entriesPerSchedule; i++) {
+        char doName[32];
+
+        sprintf(doName, valueFormat, isMV ? "ValASG" : "ValSPG", i);
+
+        fprintf(out, "DO(%s 0){\n", doName);
+
+        if (isMV) {
+            fprintf(out, "DA(setMag 0 27 2 1 0){\n");
+            writeStatusDA(out, "f", 10, 2, 1, (isPeriodic && (i == 1)) ? "0.0" : NULL);
+            fprintf(out, "}\n");
+        }
+        else {
+            writeStatusDA(out, "setVal", 0, 2, 1, NULL);
+        }
+
+        fprintf(out, "}\n");
+    }
+
+    for (i = 1; i <= config->startTimesPerSchedule; i++) {
+        writeStrTm(out, i, isPeriodic);
+    }
+
+    writeSetting(out, "SchdReuse", 0, isPeriodic ? "1" : NULL);
+
+    fprintf(out, "}\n");
+}
+
+static bool
+isMVController(const GeneratorConfig* config, int controllerIdx)
+{
+    if (config->controllerType == CTRL_TYPE_MIXED) {
+        /* two analogue controllers followed by one on/off controller (like ActPow/MaxPow/OnOff) */
+        return ((controllerIdx % 3) != 2);
+    }
+
+    return (config->controllerType == CTRL_TYPE_MV);
+}
+
+static void
+writeLogicalDevice(FILE* out, const GeneratorConfig* config, const char* ldName)
+{
+    int numberOfSchedules = config->schedulesPerController + config->periodicSchedulesPerController;
+
+    fprintf(out, "LD(%s){\n", ldName);
+
+    writeLLN0(out);
+    writeLPHD(out);
+
+    int c;
+
+    /* same order as the hand-written model: target LNs, controllers, schedules */
+
+    for (c = 0; c < config->controllersPerLD; c++) {
+        char prefix[32];
+
+        sprintf(prefix, "Ctl%02i_", c + 1);
+
+        writeGGIO(out, prefix, isMVController(config, c));
+    }
+
+    for (c = 0; c < config->controllersPerLD; c++) {
+        char prefix[32];
+
+        sprintf(prefix, "Ctl%02i_", c + 1);
+
+        writeFSCC(out, config, ldName, prefix, isMVController(config, c));
+    }
+
+    for (c = 0; c < config->controllersPerLD; c++) {
+        char prefix[32];
+
+        sprintf(prefix, "Ctl%02i_", c + 1);
+
+        int s;
+
+        for (s = 0; s < numberOfSchedules; s++) {
+            char schedName[64];
+
+            getScheduleName(schedName, prefix, s, config->schedulesPerController);
+
+            writeFSCH(out, config, schedName, isMVController(config, c), (s >= config->schedulesPerController));
+        }
+    }
+
+    fprintf(out, "}\n");
+}
+
+static bool
+parseIntArg(const char* str, int* value, int min, int max)
+{
+    char* end = NULL;
+
+    long val = strtol(str, &end, 10);
+
+    if ((end == str) || (*end != 0) || (val < min) || (val > max)) {
+        printf("ERROR: invalid value %s (allowed range: %i..%i)\n", str, min, max);
+        return false;
+    }
+
+    *value = (int)val;
+
+    return true;
+}
+
+int
+main(int argc, char** argv)
+{
+    GeneratorConfig config;
+
+    config.numberOfLDs = 1;
+    config.controllersPerLD = 3;
+    config.schedulesPerController = 10;
+    config.periodicSchedulesPerController = 1;
+    config.entriesPerSchedule = 100;
+    config.startTimesPerSchedule = 16;
+    config.controllerType = CTRL_TYPE_MIXED;
+    config.iedName = "DER_Scheduler_";
+
+    const char* outputFile = NULL;
+
+    int i;
+
+    for (i = 1; i < argc; i++) {
+        bool valid = true;
+
+        if ((argv[i][0] != '-') || (argv[i][1] == 0) || (argv[i][2] != 0)) {
+            valid = false;
+        }
+        else if (argv[i][1] == 'h') {
+            printUsage(argv[0]);
+            return 0;
+        }
+        else if (i + 1 >= argc) {
+            valid = false;
+        }
+        else {
+            const char* arg = argv[++i];
+
+            switch (argv[i - 1][1]) {
+            case 'o':
+                outputFile = arg;
+                break;
+            case 'i':
+                config.iedName = arg;
+                break;
+            case 'l':
+                valid = parseIntArg(arg, &config.numberOfLDs, 1, 999);
+                break;
+            case 'c':
+                valid = parseIntArg(arg, &config.controllersPerLD, 1, 99);
+                break;
+            case 's':
+                valid = parseIntArg(arg, &config.schedulesPerController, 0, 99);
+                break;
+            case 'p':
+                valid = parseIntArg(arg, &config.periodicSchedulesPerController, 0, 99);
+                break;
+            case 'e':
+                valid = parseIntArg(arg, &config.entriesPerSchedule, 1, 9999);
+                break;
+            case 'n':
+                valid = parseIntArg(arg, &config.startTimesPerSchedule, 0, 99);
+                break;
+            case 't':
+                if (!strcmp(arg, "mv"))
+                    config.controllerType = CTRL_TYPE_MV;
+                else if (!strcmp(arg, "sps"))
+                    config.controllerType = CTRL_TYPE_SPS;
+                else if (!strcmp(arg, "mixed"))
+                    config.controllerType = CTRL_TYPE_MIXED;
+                else
+                    valid = false;
+                break;
+            default:
+                valid = false;
+                break;
+            }
+        }
+
+        if (valid == false) {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    FILE* out = stdout;
+
+    if (outputFile) {
+        out = fopen(outputFile, "w");
+
+        if (out == NULL) {
+            printf("ERROR: Cannot open output file %s\n", outputFile);
+            return 1;
+        }
+    }
+
+    fprintf(out, "MODEL(%s){\n", config.iedName);
+
+    for (i = 0; i < config.numberOfLDs; i++) {
+        char ldName[32];
+
+        if (config.numberOfLDs == 1)
+            strcpy(ldName, "Control");
+        else
+            sprintf(ldName, "Control%i", i + 1);
+
+        writeLogicalDevice(out, &config, ldName);
+    }
+
+    fprintf(out, "}\n");
+
+    if (outputFile) {
+        fclose(out);
+
+        printf("INFO: Generated %i LD(s) with %i controller(s) and %i schedule(s) -> %s\n",
+            config.numberOfLDs, config.numberOfLDs * config.controllersPerLD,
+            config.numberOfLDs * config.controllersPerLD * (config.schedulesPerController + config.periodicSchedulesPerController),
+            outputFile);
+    }
+
+    return 0;
+}
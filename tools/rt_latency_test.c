@@ -0,0 +1,204 @@
+/*
+ * Wakeup latency of an engine thread under CPU stress
+ *
+ * Starts a number of busy threads with default scheduling and measures how much later
+ * than requested a periodically sleeping thread wakes up (like the schedule and scheduler
+ * threads). The measurement is done first with default scheduling and then with the
+ * given real-time configuration (see scheduler_rt.h), so the results can be compared.
+ *
+ * Real-time policies and memory locking require CAP_SYS_NICE/CAP_IPC_LOCK (e.g. run as root).
+ */
+
+#include "scheduler_rt.h"
+
+#include <libiec61850/hal_thread.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+    SchedulerRtConfig config;
+    int intervalInMs;
+    int durationInS;
+    SchedulerRtLatency latency;
+    bool configApplied;
+} Measurement;
+
+static bool stressRunning = false;
+
+static void*
+stressThread(void* parameter)
+{
+    volatile uint64_t counter = 0;
+
+    (void)parameter;
+
+    while (__atomic_load_n(&stressRunning, __ATOMIC_RELAXED))
+        counter++;
+
+    return NULL;
+}
+
+static void*
+measurementThread(void* parameter)
+{
+    Measurement* self = (Measurement*)parameter;
+
+    self->configApplied = SchedulerRt_applyToCurrentThread(&(self->config));
+
+    uint64_t endTime = SchedulerRt_getMonotonicTimeInUs() + ((uint64_t)self->durationInS * 1000000);
+
+    while (SchedulerRt_getMonotonicTimeInUs() < endTime) {
+        uint64_t sleepStart = SchedulerRt_getMonotonicTimeInUs();
+
+        Thread_sleep(self->intervalInMs);
+
+        SchedulerRtLatency_addWakeup(&(self->latency), sleepStart, self->intervalInMs);
+    }
+
+    return NULL;
+}
+
+static void
+runMeasurement(Measurement* measurement, const char* name)
+{
+    memset(&(measurement->latency), 0, sizeof(SchedulerRtLatency));
+
+    Thread thread = Thread_create(measurementThread, measurement, false);
+
+    if (thread == NULL) {
+        printf("ERROR: Failed to create measurement thread\n");
+        return;
+    }
+
+    Thread_start(thread);
+    Thread_destroy(thread);
+
+    SchedulerRtLatency* latency = &(measurement->latency);
+
+    printf("%-28s wakeups: %8llu  avg: %6llu us  p99: %6u us  p99.9: %6u us  max: %6u us%s\n", name,
+        (unsigned long long)latency->numberOfWakeups,
+        (unsigned long long)(latency->numberOfWakeups ? (latency->totalLatencyInUs / latency->numberOfWakeups) : 0),
+        SchedulerRtLatency_getPercentile(latency, 99.0), SchedulerRtLatency_getPercentile(latency, 99.9),
+        latency->maxLatencyInUs, measurement->configApplied ? "" : "  (configuration rejected)");
+}
+
+static void
+printUsage(const char* progName)
+{
+    printf("Usage: %s [options]\n", progName);
+    printf("  -p <policy>   scheduling policy of the measured thread: other, fifo or rr (default: fifo)\n");
+    printf("  -P <n>        real-time priority (default: 80)\n");
+    printf("  -c <mask>     CPU mask of the measured thread in hex, 0 for all CPUs (default: 0)\n");
+    printf("  -l <0|1>      lock memory (default: 1)\n");
+    printf("  -s <n>        number of stress threads (default: 4)\n");
+    printf("  -d <s>        duration of each measurement in seconds (default: 10)\n");
+    printf("  -i <ms>       sleep interval of the measured thread (default: 1)\n");
+}
+
+int
+main(int argc, char** argv)
+{
+    SchedulerRtConfig config;
+
+    memset(&config, 0, sizeof(config));
+
+    config.policy = SCHEDULER_RT_POLICY_FIFO;
+    config.priority = 80;
+    config.lockMemory = true;
+    config.prefaultStackSize = 64 * 1024;
+    config.prefaultHeapSize = 1024 * 1024;
+
+    int numberOfStressThreads = 4;
+    int durationInS = 10;
+    int intervalInMs = 1;
+
+    int i;
+
+    for (i = 1; i < argc; i++) {
+        if ((argv[i][0] != '-') || (i + 1 >= argc)) {
+            printUsage(argv[0]);
+            return 1;
+        }
+
+        const char* arg = argv[++i];
+
+        switch (argv[i - 1][1]) {
+        case 'p':
+            if (strcmp(arg, "other") == 0)
+                config.policy = SCHEDULER_RT_POLICY_DEFAULT;
+            else if (strcmp(arg, "fifo") == 0)
+                config.policy = SCHEDULER_RT_POLICY_FIFO;
+            else if (strcmp(arg, "rr") == 0)
+                config.policy = SCHEDULER_RT_POLICY_RR;
+            else {
+                printUsage(argv[0]);
+                return 1;
+            }
+            break;
+
+        case 'P': config.priority = atoi(arg); break;
+        case 'c': config.cpuMask = strtoull(arg, NULL, 16); break;
+        case 'l': config.lockMemory = (atoi(arg) != 0); break;
+        case 's': numberOfStressThreads = atoi(arg); break;
+        case 'd': durationInS = atoi(arg); break;
+        case 'i': intervalInMs = atoi(arg); break;
+        default:
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    if ((numberOfStressThreads < 0) || (durationInS < 1) || (intervalInMs < 1)) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    Thread* stressThreads = (Thread*)calloc(numberOfStressThreads + 1, sizeof(Thread));
+
+    if (stressThreads == NULL) {
+        printf("ERROR: Out of memory\n");
+        return 1;
+    }
+
+    printf("INFO: %i stress threads, %i ms interval, %i s per measurement\n", numberOfStressThreads, intervalInMs, durationInS);
+
+    __atomic_store_n(&stressRunning, true, __ATOMIC_RELAXED);
+
+    for (i = 0; i < numberOfStressThreads; i++) {
+        stressThreads[i] = Thread_create(stressThread, NULL, false);
+
+        if (stressThreads[i])
+            Thread_start(stressThreads[i]);
+    }
+
+    Measurement measurement;
+
+    memset(&measurement, 0, sizeof(measurement));
+
+    measurement.intervalInMs = intervalInMs;
+    measurement.durationInS = durationInS;
+
+    /* reference with default scheduling */
+    runMeasurement(&measurement, "default scheduling");
+
+    if (SchedulerRt_lockMemory(&config) == false)
+        printf("WARN: Measurement without locked memory\n");
+
+    measurement.config = config;
+
+    runMeasurement(&measurement, (config.policy == SCHEDULER_RT_POLICY_RR) ? "SCHED_RR" :
+        ((config.policy == SCHEDULER_RT_POLICY_FIFO) ? "SCHED_FIFO" : "configured (SCHED_OTHER)"));
+
+    __atomic_store_n(&stressRunning, false, __ATOMIC_RELAXED);
+
+    for (i = 0; i < numberOfStressThreads; i++) {
+        if (stressThreads[i])
+            Thread_destroy(stressThreads[i]);
+    }
+
+    free(stressThreads);
+
+    return 0;
+}
@@ -0,0 +1,239 @@
+/*
+ * Headless fleet simulation with device twins
+ *
+ * Creates a number of twins, each with a schedule controller and two schedules
+ * (a base schedule and a higher priority schedule that runs during a part of the
+ * day). The twins are simulated for the given number of hours on a virtual clock
+ * and the achieved speed-up compared to real time is printed.
+ *
+ * The schedules use a limited number of profiles (like the reserve and default
+ * schedules of a real fleet). Schedules with the same profile share one value
+ * array of a ScheduleValuePool.
+ */
+
+#include "scheduler_simulation.h"
+#include "schedule_values.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define SCHEDULES_PER_TWIN 2
+
+typedef struct {
+    ScheduleCore schedules[SCHEDULES_PER_TWIN];
+    ScheduleCore* scheduleList[SCHEDULES_PER_TWIN];
+    uint64_t startTimes[SCHEDULES_PER_TWIN];
+    ScheduleValueArray values[SCHEDULES_PER_TWIN];
+    ScheduleControllerCore controller;
+} Twin;
+
+static uint64_t outputChanges = 0;
+
+static void
+outputHandler(void* parameter, SimulationTwin twin, ScheduleControllerCore* controller, uint64_t time)
+{
+    (void)parameter;
+    (void)twin;
+    (void)controller;
+    (void)time;
+
+    __atomic_fetch_add(&outputChanges, 1, __ATOMIC_RELAXED);
+}
+
+static uint64_t
+getMonotonicTimeInUs(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ((uint64_t)ts.tv_sec * 1000000) + (ts.tv_nsec / 1000);
+}
+
+static bool
+twin_initialize(Twin* self, ScheduleValuePool pool, double* profileBuffer, int numberOfProfiles, int numberOfEntries,
+    int intervalInMs, uint64_t startTime, unsigned int* seed)
+{
+    int i;
+
+    memset(self, 0, sizeof(Twin));
+
+    for (i = 0; i < SCHEDULES_PER_TWIN; i++) {
+        ScheduleCore* schedule = &(self->schedules[i]);
+
+        /* the same profile number always creates the same values */
+        unsigned int profileSeed = (numberOfProfiles > 0) ? (unsigned int)(rand_r(seed) % numberOfProfiles) : (unsigned int)rand_r(seed);
+
+        int j;
+
+        for (j = 0; j < numberOfEntries; j++)
+            profileBuffer[j] = (double)(rand_r(&profileSeed) % 10000) / 10.0;
+
+        self->values[i] = ScheduleValuePool_getArray(pool, profileBuffer, numberOfEntries);
+
+        if (self->values[i] == NULL)
+            return false;
+
+        /* base schedule starts immediately, the second schedule at a random entry boundary */
+        self->startTimes[i] = startTime + 1;
+
+        if (i > 0)
+            self->startTimes[i] += (uint64_t)(rand_r(seed) % numberOfEntries) * intervalInMs;
+
+        schedule->values = ScheduleValueArray_getValues(self->values[i]);
+        schedule->numberOfValues = (i == 0) ? numberOfEntries : (numberOfEntries / 8) + 1;
+        schedule->intervalInMs = intervalInMs;
+        schedule->startTimes = &(self->startTimes[i]);
+        schedule->numberOfStartTimes = 1;
+        schedule->prio = 10 + i;
+
+        ScheduleCore_initialize(schedule);
+        ScheduleCore_enable(schedule, startTime);
+
+        self->scheduleList[i] = schedule;
+    }
+
+    self->controller.schedules = self->scheduleList;
+    self->controller.numberOfSchedules = SCHEDULES_PER_TWIN;
+
+    return true;
+}
+
+static void
+printUsage(const char* progName)
+{
+    printf("Usage: %s [options]\n", progName);
+    printf("  -n <n>        number of twins (default: 10000)\n");
+    printf("  -t <n>        number of worker threads (default: 4)\n");
+    printf("  -H <h>        simulated time in hours (default: 24)\n");
+    printf("  -N <n>        number of entries per schedule (default: 96)\n");
+    printf("  -i <s>        schedule interval in seconds (default: 900)\n");
+    printf("  -s <s>        step of the virtual clock in seconds (default: 3600)\n");
+    printf("  -P <n>        number of distinct schedule profiles, 0 for individual profiles (default: 16)\n");
+}
+
+int
+main(int argc, char** argv)
+{
+    int numberOfTwins = 10000;
+    int numberOfThreads = 4;
+    int hours = 24;
+    int numberOfEntries = 96;
+    int intervalInS = 900;
+    int stepInS = 3600;
+    int numberOfProfiles = 16;
+
+    int i;
+
+    for (i = 1; i < argc; i++) {
+        if ((argv[i][0] != '-') || (i + 1 >= argc)) {
+            printUsage(argv[0]);
+            return 1;
+        }
+
+        const char* arg = argv[++i];
+
+        switch (argv[i - 1][1]) {
+        case 'n': numberOfTwins = atoi(arg); break;
+        case 't': numberOfThreads = atoi(arg); break;
+        case 'H': hours = atoi(arg); break;
+        case 'N': numberOfEntries = atoi(arg); break;
+        case 'i': intervalInS = atoi(arg); break;
+        case 's': stepInS = atoi(arg); break;
+        case 'P': numberOfProfiles = atoi(arg); break;
+        default:
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    if ((numberOfTwins < 1) || (numberOfThreads < 0) || (hours < 1) || (numberOfEntries < 1) ||
+        (intervalInS < 1) || (stepInS < 1) || (numberOfProfiles < 0))
+    {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    uint64_t startTime = (uint64_t)time(NULL) * 1000;
+
+    SchedulerSimulation simulation = SchedulerSimulation_create(numberOfThreads, startTime);
+
+    Twin* twins = (Twin*)calloc(numberOfTwins, sizeof(Twin));
+
+    ScheduleValuePool pool = ScheduleValuePool_create();
+
+    double* profileBuffer = (double*)malloc(numberOfEntries * sizeof(double));
+
+    if ((simulation == NULL) || (twins == NULL) || (pool == NULL) || (profileBuffer == NULL)) {
+        printf("ERROR: Out of memory\n");
+        return 1;
+    }
+
+    SchedulerSimulation_setOutputHandler(simulation, outputHandler, NULL);
+
+    unsigned int seed = (unsigned int)startTime;
+
+    for (i = 0; i < numberOfTwins; i++) {
+        Twin* twin = &(twins[i]);
+
+        SimulationTwin simTwin = SchedulerSimulation_addTwin(simulation, twin);
+
+        if ((simTwin == NULL) || (twin_initialize(twin, pool, profileBuffer, numberOfProfiles, numberOfEntries, intervalInS * 1000, startTime, &seed) == false)) {
+            printf("ERROR: Out of memory\n");
+            return 1;
+        }
+
+        int j;
+
+        for (j = 0; j < SCHEDULES_PER_TWIN; j++)
+            SimulationTwin_addSchedule(simTwin, twin->scheduleList[j]);
+
+        SimulationTwin_addController(simTwin, &(twin->controller));
+    }
+
+    printf("INFO: %i distinct value arrays for %i schedules (%i bytes, %lu bytes without sharing)\n",
+        ScheduleValuePool_getNumberOfArrays(pool), numberOfTwins * SCHEDULES_PER_TWIN, ScheduleValuePool_getMemoryUsage(pool),
+        (unsigned long)numberOfTwins * SCHEDULES_PER_TWIN * numberOfEntries * sizeof(double));
+
+    printf("INFO: Simulating %i twins for %i h with %i worker threads\n", numberOfTwins, hours, numberOfThreads);
+
+    uint64_t endTime = startTime + ((uint64_t)hours * 3600 * 1000);
+
+    uint64_t wallStartTime = getMonotonicTimeInUs();
+
+    while (SchedulerSimulation_getTime(simulation) < endTime) {
+        uint64_t nextTime = SchedulerSimulation_getTime(simulation) + ((uint64_t)stepInS * 1000);
+
+        if (nextTime > endTime)
+            nextTime = endTime;
+
+        SchedulerSimulation_advanceTo(simulation, nextTime);
+    }
+
+    uint64_t wallTimeInUs = getMonotonicTimeInUs() - wallStartTime;
+
+    if (wallTimeInUs == 0)
+        wallTimeInUs = 1;
+
+    printf("INFO: Simulation finished after %.3f s (speed-up %.0fx)\n", wallTimeInUs / 1000000.0,
+        ((double)hours * 3600 * 1000000) / wallTimeInUs);
+    printf("INFO: %llu output changes\n", (unsigned long long)outputChanges);
+
+    SchedulerSimulation_destroy(simulation);
+
+    for (i = 0; i < numberOfTwins; i++) {
+        int j;
+
+        for (j = 0; j < SCHEDULES_PER_TWIN; j++)
+            ScheduleValueArray_release(twins[i].values[j]);
+    }
+
+    free(twins);
+    free(profileBuffer);
+
+    ScheduleValuePool_destroy(pool);
+
+    return 0;
+}